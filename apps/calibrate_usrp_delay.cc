@@ -4,137 +4,199 @@
 #include <uhd/utils/safe_main.hpp>
 #include <uhd/utils/thread.hpp>
 #include <boost/program_options.hpp>
-#include <boost/thread.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 namespace po = boost::program_options;
 
-void transmit(uhd::usrp::multi_usrp::sptr usrp,
-              std::vector<std::complex<float>*> buff_ptrs,
-              size_t num_pulses,
+namespace {
+
+struct CalibrationResult {
+    double samp_rate;
+    double master_clock_rate;
+    double delay;
+};
+
+uhd::usrp::multi_usrp::sptr
+open_device(const std::string& args, double freq, double tx_gain, double rx_gain)
+{
+    uhd::usrp::multi_usrp::sptr usrp = uhd::usrp::multi_usrp::make(args);
+    usrp->set_tx_freq(freq);
+    usrp->set_rx_freq(freq);
+    usrp->set_tx_gain(tx_gain);
+    usrp->set_rx_gain(rx_gain);
+    return usrp;
+}
+
+/**
+ * @brief Set the transmit and receive sample rates, returning false if the device
+ * coerced the rate to a different value
+ */
+bool set_rate(uhd::usrp::multi_usrp::sptr usrp, double rate)
+{
+    usrp->set_tx_rate(rate);
+    usrp->set_rx_rate(rate);
+    return std::abs(usrp->get_tx_rate() - rate) < 1e-6 * rate and
+           std::abs(usrp->get_rx_rate() - rate) < 1e-6 * rate;
+}
+
+void transmit(uhd::tx_streamer::sptr tx_stream,
+              std::complex<float>* pulse,
               size_t num_samps_pulse,
+              size_t num_pulses,
               uhd::time_spec_t start_time)
 {
-    static bool first = true;
-
-    // static bool first = true;
-    static uhd::stream_args_t tx_stream_args("fc32", "sc16");
-    uhd::tx_streamer::sptr tx_stream;
-    // tx_stream.reset();
-    if (first) {
-        first = false;
-        tx_stream_args.channels.push_back(0);
-    }
-    tx_stream = usrp->get_tx_stream(tx_stream_args);
-    // Create metadata structure
-    static uhd::tx_metadata_t tx_md;
+    uhd::tx_metadata_t tx_md;
     tx_md.start_of_burst = true;
     tx_md.end_of_burst = false;
-    tx_md.has_time_spec = (start_time.get_real_secs() > 0 ? true : false);
+    tx_md.has_time_spec = true;
     tx_md.time_spec = start_time;
 
+    // The pulse buffer holds a full PRI, so sending it back to back gives a periodic
+    // pulse train
     for (size_t ipulse = 0; ipulse < num_pulses; ipulse++) {
-        tx_stream->send(buff_ptrs, num_samps_pulse, tx_md, 0.5);
+        tx_stream->send(pulse, num_samps_pulse, tx_md, 0.5);
         tx_md.start_of_burst = false;
         tx_md.has_time_spec = false;
     }
 
     // Send mini EOB packet
-    tx_md.has_time_spec = false;
     tx_md.end_of_burst = true;
     tx_stream->send("", 0, tx_md);
 }
 
-long int receive(uhd::usrp::multi_usrp::sptr usrp,
-                 std::vector<std::complex<float>*> buff_ptrs,
-                 size_t num_samps,
-                 uhd::time_spec_t start_time)
+bool receive(uhd::rx_streamer::sptr rx_stream,
+             std::complex<float>* buff,
+             size_t num_samps,
+             uhd::time_spec_t start_time)
 {
-    static bool first = true;
-
-    static size_t channels = buff_ptrs.size();
-    static std::vector<size_t> channel_vec;
-    uhd::stream_args_t stream_args("fc32", "sc16");
-    uhd::rx_streamer::sptr rx_stream;
-    if (first) {
-        first = false;
-        if (channel_vec.size() == 0) {
-            for (size_t i = 0; i < channels; i++) {
-                channel_vec.push_back(i);
-            }
-        }
-        stream_args.channels = channel_vec;
-    }
-    rx_stream = usrp->get_rx_stream(stream_args);
-
-    uhd::rx_metadata_t md;
-
     // Set up streaming
     uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
     stream_cmd.num_samps = num_samps;
     stream_cmd.time_spec = start_time;
-    stream_cmd.stream_now = (start_time.get_real_secs() > 0 ? false : true);
+    stream_cmd.stream_now = false;
     rx_stream->issue_stream_cmd(stream_cmd);
 
+    uhd::rx_metadata_t md;
     size_t max_num_samps = rx_stream->get_max_num_samps();
     size_t num_samps_total = 0;
-    std::vector<std::complex<float>*> buff_ptrs2(buff_ptrs.size());
     double timeout = 0.5 + start_time.get_real_secs();
     while (num_samps_total < num_samps) {
-        // Move storing pointer to correct location
-        for (size_t i = 0; i < channels; i++)
-            buff_ptrs2[i] = &(buff_ptrs[i][num_samps_total]);
-
-        // Sampling data
         size_t samps_to_recv = std::min(num_samps - num_samps_total, max_num_samps);
-        size_t num_rx_samps = rx_stream->recv(buff_ptrs2, samps_to_recv, md, timeout);
+        num_samps_total +=
+            rx_stream->recv(buff + num_samps_total, samps_to_recv, md, timeout);
         timeout = 0.5;
-
-        num_samps_total += num_rx_samps;
-
-        // handle the error code
-        if (md.error_code == uhd::rx_metadata_t::ERROR_CODE_TIMEOUT)
-            break;
-        if (md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE)
+        if (md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) {
+            UHD_LOG_WARNING("CALIBRATE_DELAY", "Receiver error: " << md.strerror());
             break;
+        }
     }
+    return num_samps_total == num_samps;
+}
 
-    if (num_samps_total < num_samps)
-        return -((long int)num_samps_total);
-    else
-        return (long int)num_samps_total;
+/**
+ * @brief Estimate the loopback delay (in samples) of a received pulse train
+ *
+ * The delay has the same definition as in earlier versions of this tool, which took
+ * the argmax of the full linear convolution with the matched filter minus the filter
+ * length. That is one sample less than the lag of the cross-correlation peak, and it
+ * is the number of samples that usrp_radar discards, so existing calibration files
+ * stay valid.
+ *
+ * @param rx num_pulses + 1 received PRIs
+ * @param pri Transmitted PRI (pulse followed by zeros)
+ * @param num_pulses Number of PRIs to average
+ */
+double estimate_delay(const af::array& rx, const af::array& pri, size_t num_pulses)
+{
+    size_t n = pri.elements();
+    // The first PRI has no echo from a previous pulse, so it is discarded. Every other
+    // PRI sees the same periodic signal, which is averaged coherently.
+    af::array x = af::moddims(rx, n, num_pulses + 1).cols(1, num_pulses);
+    x = af::mean(x, 1);
+
+    // Circular cross-correlation with the transmitted PRI. A pulse that spills into the
+    // next PRI wraps around, so the peak is at the delay (modulo the PRI length).
+    af::array y = af::abs(af::ifft(af::fft(x) * af::conjg(af::fft(pri))));
+    std::vector<float> mag(n);
+    y.as(f32).host(mag.data());
+    size_t k = std::max_element(mag.begin(), mag.end()) - mag.begin();
+
+    // Fit a parabola through the peak and its neighbors for a sub-sample estimate
+    double a = mag[(k + n - 1) % n];
+    double b = mag[k];
+    double c = mag[(k + 1) % n];
+    double denom = a - 2 * b + c;
+    double offset = denom != 0 ? 0.5 * (a - c) / denom : 0;
+    return k + offset - 1;
 }
 
-inline void handle_receive_errors(const uhd::rx_metadata_t& rx_meta)
+/**
+ * @brief Merge the results into the calibration file, replacing it atomically so that
+ * readers never see a partially written file
+ */
+void write_results(const std::string& filename,
+                   const std::string& radio_type,
+                   const std::vector<CalibrationResult>& results)
 {
-    if (rx_meta.error_code == uhd::rx_metadata_t::ERROR_CODE_TIMEOUT) {
-        std::cout << boost::format("No packet received, implementation timed-out.")
-                  << std::endl;
-        return;
-    }
-    if (rx_meta.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) {
-        throw std::runtime_error(
-            str(boost::format("Receiver error %s") % rx_meta.strerror()));
+    std::filesystem::path path(filename);
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path());
+
+    // If data already exists in the file, keep it
+    nlohmann::json json;
+    std::ifstream prev_data(filename);
+    if (prev_data)
+        prev_data >> json;
+    prev_data.close();
+
+    for (const CalibrationResult& result : results) {
+        // Check if radio/clock rate/sample rate triplet already exists
+        bool exists = false;
+        for (auto& config : json[radio_type]) {
+            if (config["samp_rate"] == result.samp_rate and
+                config["master_clock_rate"] == result.master_clock_rate) {
+                config["delay"] = result.delay;
+                exists = true;
+                break;
+            }
+        }
+        // Calibration configuration not found, add it
+        if (not exists)
+            json[radio_type].push_back(
+                { { "master_clock_rate", result.master_clock_rate },
+                  { "samp_rate", result.samp_rate },
+                  { "delay", result.delay } });
     }
+
+    // Write to a temporary file in the same directory, then rename it over the original
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp";
+    std::ofstream outfile(tmp_path);
+    outfile << json.dump(true);
+    outfile.close();
+    if (not outfile)
+        throw std::runtime_error("Failed to write " + tmp_path.string());
+    std::filesystem::rename(tmp_path, path);
 }
 
+} // namespace
+
 int UHD_SAFE_MAIN(int argc, char* argv[])
 {
     af::info();
     // Save the calibration results to a json file
     const std::string homedir = getenv("HOME");
 
-    // Initialzie the USRP object
-    uhd::usrp::multi_usrp::sptr usrp;
-
-    // TODO: These should be program option parameters
     std::vector<double> rates;
     std::string args;
     std::string filename;
     double tx_gain, rx_gain;
     double freq;
+    size_t num_pulses;
     po::options_description desc("Allowed options");
     // clang-format off
     desc.add_options()("help", "help message")
@@ -143,9 +205,9 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     ("tx_gain", po::value<double>(&tx_gain), "Transmit gain")
     ("rx_gain", po::value<double>(&rx_gain), "Receive gain")
     ("freq", po::value<double>(&freq)->default_value(5e9), "Center Frequency")
+    ("num_pulses", po::value<size_t>(&num_pulses)->default_value(16), "Number of pulses averaged per sample rate")
     ("filename", po::value<std::string>(&filename)->default_value(homedir + "/.uhd/delay_calibration.json"), "Output json file")
     ;
-    usrp = uhd::usrp::multi_usrp::make(args);
     // clang-format on
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -159,7 +221,9 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
                      "delay shows up as a constant range offset and must be corrected to "
                      "produce accurate range values. This script estimates the delay for "
                      "each sample rate/master clock rate pair in the input arguments, "
-                     "and saves them to a json file for use in later processing."
+                     "and saves them to a json file for use in later processing. Each "
+                     "delay is averaged over several pulses and interpolated to a "
+                     "fraction of a sample."
                   << std::endl;
         return ~0;
     }
@@ -185,118 +249,79 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-
-    // Get the directory of the output file
-    std::string directory;
-    const size_t last_slash_idx = filename.rfind('/');
-    if (std::string::npos != last_slash_idx) {
-        directory = filename.substr(0, last_slash_idx);
+    if (num_pulses == 0) {
+        UHD_LOG_ERROR("CALIBRATE_DELAY", "The number of pulses must be positive");
+        return EXIT_FAILURE;
     }
 
-    
-    double start_time = 0.1;
-    boost::thread_group tx_thread;
-    std::vector<double> master_clock_rates(rates.size());
-    std::vector<size_t> delays(rates.size());
-    std::string radio_type;
-    for (size_t i = 0; i < rates.size(); i++) {
-        // Set up the USRP device
-        usrp = uhd::usrp::multi_usrp::make(args);
-        usrp->set_tx_freq(freq);
-        usrp->set_rx_freq(freq);
-        // Set the gain to half of the max gain on Tx and Rx. This should be
-        // plenty of gain to get a clean matched filter peak in loopback
-        usrp->set_tx_gain(tx_gain);
-        usrp->set_rx_gain(rx_gain);
-        usrp->set_tx_rate(rates[i]);
-        usrp->set_rx_rate(rates[i]);
-
-        master_clock_rates[i] = usrp->get_master_clock_rate();
-        if (i == 0) {
-            radio_type = usrp->get_mboard_name();
-        }
-        // Initialize the waveform object
-        double bandwidth = rates[i] / 2;
-        double pulse_width = 20e-6;
-        double prf = 10e3;
-        af::array waveform_array = plasma::lfm(-bandwidth/2, bandwidth, pulse_width, rates[i], prf).as(c32);
-        std::unique_ptr<std::complex<float>> waveform_data(
-            reinterpret_cast<std::complex<float>*>(waveform_array.host<af::cfloat>()));
-
-        // Set up Rx buffer
-        size_t num_samp_rx = waveform_array.elements();
-        std::vector<std::complex<float>*> rx_buff_ptrs;
-        std::vector<std::complex<float>> rx_buff(num_samp_rx, 0);
-        rx_buff_ptrs.push_back(&rx_buff.front());
-
-        // Set up Tx buffer
-        std::vector<std::complex<float>*> tx_buff_ptrs;
-        tx_buff_ptrs.push_back(waveform_data.get());
+    // The device stays open for the whole sweep. Rates that the device can't reach
+    // at its current master clock rate are coerced, and the delay is measured (and
+    // saved) for the rate that was actually used.
+    uhd::usrp::multi_usrp::sptr usrp = open_device(args, freq, tx_gain, rx_gain);
+    std::string radio_type = usrp->get_mboard_name();
+    uhd::stream_args_t stream_args("fc32", "sc16");
+    stream_args.channels.push_back(0);
 
-        // Send the  data to be used for calibration
+    double start_time = 0.1;
+    double pulse_width = 20e-6;
+    double prf = 10e3;
+    std::vector<std::complex<float>> rx_buff;
+    std::vector<CalibrationResult> results;
+    for (double rate : rates) {
+        if (not set_rate(usrp, rate))
+            UHD_LOG_WARNING("CALIBRATE_DELAY",
+                            "Requested sample rate " << rate / 1e6
+                                                     << " MHz was coerced to "
+                                                     << usrp->get_tx_rate() / 1e6
+                                                     << " MHz");
+        double samp_rate = usrp->get_tx_rate();
+        // Streamers are bound to the current rates
+        uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
+        uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
+
+        // Pad the waveform to a full PRI
+        double bandwidth = samp_rate / 2;
+        af::array pulse =
+            plasma::lfm(-bandwidth / 2, bandwidth, pulse_width, samp_rate).as(c32);
+        size_t n_pri = std::max<size_t>(std::round(samp_rate / prf), pulse.elements());
+        af::array pri = af::constant(0, n_pri, c32);
+        pri(af::seq(pulse.elements())) = pulse;
+        std::vector<std::complex<float>> tx_buff(n_pri);
+        pri.host(tx_buff.data());
+
+        // Send one extra pulse so that every averaged PRI follows a previous pulse
+        size_t num_samp_rx = (num_pulses + 1) * n_pri;
+        rx_buff.assign(num_samp_rx, 0);
         uhd::time_spec_t time_now = usrp->get_time_now();
-        tx_thread.create_thread(boost::bind(&transmit,
-                                            usrp,
-                                            tx_buff_ptrs,
-                                            1,
-                                            waveform_array.elements(),
-                                            time_now + start_time));
-        receive(usrp, rx_buff_ptrs, num_samp_rx, time_now + start_time);
-        tx_thread.join_all();
+        std::thread tx_thread(transmit,
+                              tx_stream,
+                              tx_buff.data(),
+                              n_pri,
+                              num_pulses + 1,
+                              time_now + start_time);
+        bool ok = receive(rx_stream, rx_buff.data(), num_samp_rx, time_now + start_time);
+        tx_thread.join();
+        if (not ok) {
+            UHD_LOG_ERROR("CALIBRATE_DELAY",
+                          "Failed to receive the calibration pulses at "
+                              << samp_rate / 1e6 << " MHz");
+            continue;
+        }
 
-        // Create the matched filter
-        af::array x(rx_buff.size(), c32);
-        x.write(reinterpret_cast<af::cfloat*>(rx_buff.data()),
-                rx_buff.size() * sizeof(af::cfloat));
-        af::array h = af::conjg(af::flip(waveform_array, 0));
-        af::array y = af::convolve1(x, h, AF_CONV_EXPAND, AF_CONV_AUTO);
-        double max;
-        unsigned int argmax;
-        af::max<double>(&max, &argmax, y);
-        delays[i] = argmax - h.elements();
+        af::array rx(num_samp_rx, reinterpret_cast<const af::cfloat*>(rx_buff.data()));
+        CalibrationResult result;
+        result.samp_rate = samp_rate;
+        result.master_clock_rate = usrp->get_master_clock_rate();
+        result.delay = estimate_delay(rx, pri, num_pulses);
+        results.push_back(result);
         // Output the results for the current configuration
         UHD_LOG_INFO("CALIBRATE_DELAY",
-                     "At MCR = " << master_clock_rates[i] / 1e6
-                                 << " MHz, sample rate = " << rates[i] / 1e6
-                                 << " MHz, delay is " << delays[i] << " samples");
-
-
-        // Reset the device for the next configuration
-        usrp.reset();
+                     "At MCR = " << result.master_clock_rate / 1e6
+                                 << " MHz, sample rate = " << samp_rate / 1e6
+                                 << " MHz, delay is " << result.delay << " samples");
     }
-    // Save the calibration results to a json file
-    // const std::string homedir = getenv("HOME");
-    // Create uhd hidden folder if it doesn't already exist
-    if (not std::filesystem::exists(directory)) {
-        std::filesystem::create_directory(directory);
-    }
-    // If data already exists in the file, keep it
-    nlohmann::json json;
-    std::ifstream prev_data(filename);
-    if (prev_data)
-        prev_data >> json;
-    prev_data.close();
-    // Write the data to delay_calibration.json
-    std::ofstream outfile(filename);
-    for (size_t i = 0; i < rates.size(); i++) {
-        // Check if radio/clock rate/sample rate triplet already exists
-        bool exists = false;
-        for (auto& config : json[radio_type]) {
-            if (config["samp_rate"] == rates[i] and
-                config["master_clock_rate"] == master_clock_rates[i]) {
-                config["delay"] = delays[i];
-                exists = true;
-                break;
-            }
-        }
-        // Calibration configuration not found, add it
-        if (not exists)
-            json[radio_type].push_back({ { "master_clock_rate", master_clock_rates[i] },
-                                         { "samp_rate", rates[i] },
-                                         { "delay", delays[i] } });
-    }
-    outfile << json.dump(true);
-    outfile.close();
+
+    write_results(filename, radio_type, results);
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,336 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * Benchmarks for the message handlers of the DSP blocks. Each handler is called
+ * directly (without a flowgraph) with synthetic PDUs, and the following counters are
+ * reported for each (samples per PRI, pulses per CPI, waveform length, backend)
+ * configuration:
+ *
+ *   cpi_per_second     Number of CPIs processed per second
+ *   bytes_per_second   Input sample throughput
+ *   allocs_per_cpi     Heap allocations (operator new) per CPI
+ *
+ * Use --benchmark_out=<file> --benchmark_out_format=json to save the results, or
+ * build the run_benchmarks target.
+ */
+
+#include "alpha_beta_tracker.h"
+#include "beamformer_impl.h"
+#include "cfar2D_impl.h"
+#include "doppler_processing_impl.h"
+#include "match_filt_impl.h"
+#include "pdu_file_sink_impl.h"
+#include "pulse_to_cpi_impl.h"
+#include <arrayfire.h>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <random>
+
+namespace {
+std::atomic<size_t> num_allocs(0);
+} // namespace
+
+void* operator new(size_t size)
+{
+    num_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace gr {
+namespace plasma {
+
+// Calls the message handlers that the blocks keep private
+class BlockBenchmark
+{
+public:
+    static void handle_tx_msg(match_filt_impl& block, const pmt::pmt_t& msg)
+    {
+        block.handle_tx_msg(msg);
+    }
+    static void handle_rx_msg(match_filt_impl& block, const pmt::pmt_t& msg)
+    {
+        block.handle_rx_msg(msg);
+    }
+    static void handle_msg(doppler_processing_impl& block, const pmt::pmt_t& msg)
+    {
+        block.handle_msg(msg);
+    }
+    static void handle_message(cfar2D_impl& block, const pmt::pmt_t& msg)
+    {
+        block.handle_message(msg);
+    }
+    static void handle_msg(beamformer_impl& block, const pmt::pmt_t& msg)
+    {
+        block.handle_msg(msg);
+    }
+};
+
+namespace {
+
+// Indices of the benchmark arguments
+enum Arg { SAMPLES, PULSES, WAVEFORM, BACKEND };
+
+pmt::pmt_t make_pdu(size_t n, pmt::pmt_t meta = pmt::make_dict())
+{
+    std::mt19937 gen(0);
+    std::normal_distribution<float> dist;
+    std::vector<gr_complex> samples(n);
+    for (gr_complex& x : samples)
+        x = gr_complex(dist(gen), dist(gen));
+    return pmt::cons(meta, pmt::init_c32vector(n, samples));
+}
+
+Device::Backend backend(const benchmark::State& state)
+{
+    return static_cast<Device::Backend>(state.range(BACKEND));
+}
+
+std::vector<int64_t> available_backends()
+{
+    std::vector<int64_t> backends;
+    int available = af::getAvailableBackends();
+    for (Device::Backend b : { Device::CPU, Device::CUDA, Device::OPENCL }) {
+        if (available & Device::to_af_backend(b))
+            backends.push_back(b);
+    }
+    return backends;
+}
+
+/**
+ * @brief Run the benchmark loop, where each call to process_cpi handles one CPI
+ */
+template <typename F>
+void run(benchmark::State& state, F&& process_cpi, size_t bytes_per_cpi)
+{
+    // Exclude one-time setup (JIT compilation, FFT plans, buffer allocation)
+    process_cpi();
+
+    size_t allocs = num_allocs.load();
+    for (auto _ : state)
+        process_cpi();
+    allocs = num_allocs.load() - allocs;
+
+    state.SetBytesProcessed(state.iterations() * bytes_per_cpi);
+    state.counters["cpi_per_second"] =
+        benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["allocs_per_cpi"] =
+        benchmark::Counter(allocs, benchmark::Counter::kAvgIterations);
+}
+
+void BM_match_filt(benchmark::State& state)
+{
+    size_t nsamp = state.range(SAMPLES);
+    size_t npulse = state.range(PULSES);
+    auto block = gnuradio::make_block_sptr<match_filt_impl>(npulse);
+    block->set_backend(backend(state));
+    BlockBenchmark::handle_tx_msg(*block, make_pdu(state.range(WAVEFORM)));
+
+    pmt::pmt_t msg = make_pdu(nsamp * npulse);
+    run(
+        state,
+        [&] { BlockBenchmark::handle_rx_msg(*block, msg); },
+        nsamp * npulse * sizeof(gr_complex));
+}
+
+void BM_doppler_processing(benchmark::State& state)
+{
+    size_t nsamp = state.range(SAMPLES);
+    size_t npulse = state.range(PULSES);
+    auto block = gnuradio::make_block_sptr<doppler_processing_impl>(npulse, npulse);
+    block->set_backend(backend(state));
+
+    pmt::pmt_t msg = make_pdu(nsamp * npulse);
+    run(
+        state,
+        [&] { BlockBenchmark::handle_msg(*block, msg); },
+        nsamp * npulse * sizeof(gr_complex));
+}
+
+void BM_cfar2D(benchmark::State& state)
+{
+    size_t nsamp = state.range(SAMPLES);
+    size_t npulse = state.range(PULSES);
+    std::vector<int> guard_win_size = { 2, 2 };
+    std::vector<int> train_win_size = { 8, 8 };
+    auto block = gnuradio::make_block_sptr<cfar2D_impl>(
+        guard_win_size, train_win_size, 1e-6, npulse);
+    block->set_backend(backend(state));
+
+    pmt::pmt_t msg = make_pdu(nsamp * npulse);
+    run(
+        state,
+        [&] { BlockBenchmark::handle_message(*block, msg); },
+        nsamp * npulse * sizeof(gr_complex));
+}
+
+void BM_beamformer(benchmark::State& state)
+{
+    size_t nsamp = state.range(SAMPLES);
+    size_t npulse = state.range(PULSES);
+    // The third argument is the number of channels, which is also the number of beams
+    size_t nchan = state.range(WAVEFORM);
+    std::vector<double> angles(nchan);
+    for (size_t i = 0; i < nchan; i++)
+        angles[i] = -60 + 120.0 * i / nchan;
+    auto block = gnuradio::make_block_sptr<beamformer_impl>(nchan, 0.5, angles);
+    block->set_backend(backend(state));
+
+    pmt::pmt_t msg = make_pdu(nsamp * npulse * nchan);
+    run(
+        state,
+        [&] { BlockBenchmark::handle_msg(*block, msg); },
+        nsamp * npulse * nchan * sizeof(gr_complex));
+}
+
+void BM_pulse_to_cpi(benchmark::State& state)
+{
+    size_t nsamp = state.range(SAMPLES);
+    size_t npulse = state.range(PULSES);
+    auto block = gnuradio::make_block_sptr<pulse_to_cpi_impl>(npulse);
+
+    pmt::pmt_t msg = make_pdu(nsamp);
+    run(
+        state,
+        [&] {
+            for (size_t i = 0; i < npulse; i++)
+                block->handle_msg(msg);
+        },
+        nsamp * npulse * sizeof(gr_complex));
+}
+
+void BM_pdu_file_sink(benchmark::State& state)
+{
+    size_t nsamp = state.range(SAMPLES);
+    size_t npulse = state.range(PULSES);
+    std::string data_filename =
+        (std::filesystem::temp_directory_path() / "plasma_bench.sc32").string();
+    std::string meta_filename;
+    {
+        auto block = gnuradio::make_block_sptr<pdu_file_sink_impl>(
+            sizeof(gr_complex), data_filename, meta_filename);
+
+        // The worker thread runs for the whole benchmark, and each CPI is timed until
+        // it has been written
+        pmt::pmt_t msg = make_pdu(nsamp * npulse);
+        block->start();
+        run(
+            state,
+            [&] {
+                block->handle_message(msg);
+                block->flush();
+            },
+            nsamp * npulse * sizeof(gr_complex));
+        block->stop();
+    }
+    std::filesystem::remove(data_filename);
+}
+
+/**
+ * @brief Update tracks on state.range(0) targets moving at constant velocity, plus a
+ * few false alarms per CPI
+ */
+void BM_tracker(benchmark::State& state)
+{
+    size_t ntarget = state.range(0);
+    size_t nfalse = ntarget / 20;
+    double dt = 0.1;
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> range_dist(0, 50e3);
+    std::uniform_real_distribution<double> velocity_dist(-100, 100);
+    std::normal_distribution<double> noise;
+    std::vector<double> truth_range(ntarget), truth_velocity(ntarget);
+    for (size_t i = 0; i < ntarget; i++) {
+        truth_range[i] = range_dist(gen);
+        truth_velocity[i] = velocity_dist(gen);
+    }
+
+    AlphaBetaTracker tracker(20, 10, 0.5, 0.1, 3, 2);
+    std::vector<double> range(ntarget + nfalse), velocity(ntarget + nfalse);
+    auto make_detections = [&] {
+        for (size_t i = 0; i < ntarget; i++) {
+            truth_range[i] += truth_velocity[i] * dt;
+            range[i] = truth_range[i] + noise(gen);
+            velocity[i] = truth_velocity[i] + 0.5 * noise(gen);
+        }
+        for (size_t i = ntarget; i < ntarget + nfalse; i++) {
+            range[i] = range_dist(gen);
+            velocity[i] = velocity_dist(gen);
+        }
+    };
+    // Confirm the initial tracks
+    for (int i = 0; i < 3; i++) {
+        make_detections();
+        tracker.update(dt, range.data(), velocity.data(), range.size());
+    }
+
+    // Only the update is timed
+    for (auto _ : state) {
+        state.PauseTiming();
+        make_detections();
+        state.ResumeTiming();
+        tracker.update(dt, range.data(), velocity.data(), range.size());
+    }
+    state.counters["cpi_per_second"] =
+        benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["tracks"] = tracker.size();
+}
+
+} // namespace
+} // namespace plasma
+} // namespace gr
+
+int main(int argc, char** argv)
+{
+    using namespace gr::plasma;
+    benchmark::Initialize(&argc, argv);
+
+    const std::vector<int64_t> samples = { 1024, 8192 };
+    const std::vector<int64_t> pulses = { 64, 256 };
+    const std::vector<int64_t> waveforms = { 64, 512 };
+    const std::vector<int64_t> backends = available_backends();
+    const std::vector<std::string> names = { "samples", "pulses", "waveform", "backend" };
+
+    benchmark::RegisterBenchmark("match_filt", BM_match_filt)
+        ->ArgNames(names)
+        ->ArgsProduct({ samples, pulses, waveforms, backends });
+    benchmark::RegisterBenchmark("doppler_processing", BM_doppler_processing)
+        ->ArgNames(names)
+        ->ArgsProduct({ samples, pulses, { 0 }, backends });
+    benchmark::RegisterBenchmark("cfar2D", BM_cfar2D)
+        ->ArgNames(names)
+        ->ArgsProduct({ samples, pulses, { 0 }, backends });
+    benchmark::RegisterBenchmark("beamformer", BM_beamformer)
+        ->ArgNames({ "samples", "pulses", "channels", "backend" })
+        ->ArgsProduct({ samples, pulses, { 4, 16 }, backends });
+    // The remaining blocks do not use ArrayFire
+    benchmark::RegisterBenchmark("pulse_to_cpi", BM_pulse_to_cpi)
+        ->ArgNames(names)
+        ->ArgsProduct({ samples, pulses, { 0 }, { Device::DEFAULT } });
+    benchmark::RegisterBenchmark("pdu_file_sink", BM_pdu_file_sink)
+        ->ArgNames(names)
+        ->ArgsProduct({ samples, pulses, { 0 }, { Device::DEFAULT } })
+        ->UseRealTime();
+    benchmark::RegisterBenchmark("tracker", BM_tracker)
+        ->ArgName("targets")
+        ->Arg(1000)
+        ->Arg(4000)
+        ->Unit(benchmark::kMicrosecond);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,96 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_ADMISSION_CONTROL_H
+#define INCLUDED_PLASMA_ADMISSION_CONTROL_H
+
+#include <gnuradio/basic_block.h>
+#include <gnuradio/plasma/api.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Decides which queued messages a processing block handles when it falls behind
+ *
+ * Policies:
+ * - KEEP_LATEST: When more than queue_depth messages are waiting, the older messages
+ *   are discarded and the newest one is processed. This bounds the latency of a live
+ *   display.
+ * - FIFO: Every message is processed in the order it arrived.
+ * - RATE_LIMITED: At most max_rate messages per second are processed. Messages that
+ *   arrive sooner are discarded.
+ *
+ * Discarded messages are counted and can be read with num_dropped().
+ */
+class PLASMA_API AdmissionControl
+{
+public:
+    enum Policy { KEEP_LATEST, FIFO, RATE_LIMITED };
+
+    AdmissionControl();
+
+    void set_policy(Policy policy);
+    Policy policy() const;
+
+    /*!
+     * \brief Set the number of messages that may wait in the queue before the
+     * KEEP_LATEST policy starts discarding them
+     */
+    void set_queue_depth(size_t depth);
+    size_t queue_depth() const;
+
+    /*!
+     * \brief Set the maximum processing rate (in messages per second) for the
+     * RATE_LIMITED policy
+     */
+    void set_max_rate(double rate);
+    double max_rate() const;
+
+    /*!
+     * \brief Decide whether to process a message that was just delivered to a handler
+     *
+     * Must be called from the message handler of the given port. For KEEP_LATEST,
+     * msg may be replaced by a newer message taken from the queue.
+     *
+     * \param block Block that owns the port
+     * \param port Input message port
+     * \param msg Message delivered to the handler
+     * \return true if the (possibly replaced) message should be processed
+     */
+    bool admit(gr::basic_block* block, const pmt::pmt_t& port, pmt::pmt_t& msg);
+
+    /*!
+     * \brief Count messages that the block discarded for its own reasons (e.g., a GUI
+     * that is still drawing the previous update)
+     */
+    void record_drop(uint64_t n = 1);
+
+    uint64_t num_dropped() const;
+    /*!
+     * \brief Number of messages admitted for processing
+     */
+    uint64_t num_processed() const;
+    void reset_counters();
+
+private:
+    std::atomic<Policy> d_policy;
+    std::atomic<size_t> d_queue_depth;
+    std::atomic<double> d_max_rate;
+    std::atomic<uint64_t> d_num_dropped;
+    std::atomic<uint64_t> d_num_processed;
+    std::chrono::steady_clock::time_point d_last_admit;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_ADMISSION_CONTROL_H */
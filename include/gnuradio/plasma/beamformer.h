@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_BEAMFORMER_H
+#define INCLUDED_PLASMA_BEAMFORMER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/plasma/api.h>
+#include <gnuradio/plasma/device.h>
+#include <vector>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Form receive beams from a multi-channel CPI
+ * \ingroup plasma
+ *
+ * Each input PDU holds a [samples x pulses x channels] cube, stored with the samples
+ * of each pulse contiguous and the channels outermost. The number of channels is
+ * read from the plasma:num_channels metadata field if present.
+ *
+ * The channels are weighted and summed for each beam with a single matrix multiply
+ * per CPI. The weights steer a uniform linear array with the given element spacing
+ * towards each steering angle, normalized to unit gain. They are only recomputed
+ * when the steering or the number of channels changes.
+ *
+ * The output holds the beams as stacked CPIs ([samples x pulses x beams]), with the
+ * number of beams in the plasma:num_beams metadata field. match_filt and
+ * doppler_processing process every beam of a CPI in one batched call.
+ */
+class PLASMA_API beamformer : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<beamformer> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of plasma::beamformer.
+     *
+     * To avoid accidental use of raw pointers, plasma::beamformer's
+     * constructor is in a private implementation
+     * class. plasma::beamformer::make is the public interface for
+     * creating new instances.
+     *
+     * \param num_channels Number of receive channels (array elements)
+     * \param element_spacing Spacing between adjacent elements (wavelengths)
+     * \param steering_angles Angle of each beam from broadside (degrees)
+     */
+    static sptr make(size_t num_channels,
+                     double element_spacing,
+                     const std::vector<double>& steering_angles);
+
+    virtual void set_steering_angles(const std::vector<double>& steering_angles) = 0;
+    virtual void set_element_spacing(double element_spacing) = 0;
+
+    virtual void set_backend(Device::Backend) = 0;
+    /*!
+     * \brief Select the device to use within the ArrayFire backend
+     */
+    virtual void set_device_id(int device_id) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_BEAMFORMER_H */
@@ -9,8 +9,10 @@
 #define INCLUDED_PLASMA_CFAR2D_H
 
 #include <gnuradio/block.h>
+#include <gnuradio/plasma/admission_control.h>
 #include <gnuradio/plasma/api.h>
 #include <gnuradio/plasma/device.h>
+#include <vector>
 
 namespace gr {
 namespace plasma {
@@ -40,11 +42,41 @@ public:
 
     virtual void set_msg_queue_depth(size_t) = 0;
 
+    /*!
+     * \brief Select how the block handles a backlog of input messages
+     *
+     * \param policy KEEP_LATEST discards all but the newest messages once more than
+     * the message queue depth are waiting, FIFO processes every message, and
+     * RATE_LIMITED processes at most max_rate messages per second.
+     * \param max_rate Maximum processing rate (messages/s) for RATE_LIMITED
+     */
+    virtual void set_admission_policy(AdmissionControl::Policy policy,
+                                      double max_rate = 0) = 0;
+
+    /*!
+     * \brief Number of input messages discarded by the admission policy
+     */
+    virtual uint64_t num_dropped() = 0;
+
     virtual void set_backend(Device::Backend) = 0;
+    /*!
+     * \brief Select the device to use within the ArrayFire backend
+     */
+    virtual void set_device_id(int device_id) = 0;
+    /*!
+     * \brief Pin the block's processing thread to the given CPU cores
+     */
+    virtual void set_cpu_affinity(const std::vector<int>& cores) = 0;
 
     virtual void set_metadata_keys(std::string detction_indices_key,
                                    std::string n_detections_key,
                                    std::string n_pulse_cpi_key) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
 };
 
 } // namespace plasma
@@ -36,6 +36,20 @@ public:
 
     virtual void init_meta_dict(const std::string& sample_rate_key,
                                 const std::string& prf_key) = 0;
+
+    /*!
+     * \brief Transmit a staggered PRF pulse train
+     *
+     * The output holds one pulse per PRF in the list, each padded to its own PRI, in a
+     * single contiguous buffer that usrp_radar sends as a whole. The start sample of
+     * each pulse is recorded in the plasma:pulse_offsets metadata, which pulse_to_cpi
+     * uses to split the received buffers back into pulses. The new stagger takes
+     * effect with the next input message.
+     *
+     * \param prfs PRF of each pulse in the stagger group (Hz). If empty, every pulse
+     * uses the PRF given to the constructor.
+     */
+    virtual void set_prf_stagger(const std::vector<double>& prfs) = 0;
 };
 
 } // namespace plasma
@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_DETECTION_REFINER_H
+#define INCLUDED_PLASMA_DETECTION_REFINER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/plasma/api.h>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Estimate the range and velocity of each detection from cfar2D
+ * \ingroup plasma
+ *
+ * For each detection, a parabola is fit to the magnitude of the cell and its two
+ * neighbors in range and in doppler, and the peak of each parabola gives a sub-bin
+ * location. The locations are converted to physical units with the sample rate,
+ * PRF, pulse width, range gate, and center frequency in the metadata, and added to
+ * the PDU (which is otherwise passed through) as f64vectors:
+ *
+ * - plasma:detection_range: Range (m)
+ * - plasma:detection_doppler: Doppler shift (Hz)
+ * - plasma:detection_velocity: Radial velocity (m/s), if the center frequency is
+ *   known. Like the doppler shift, it is positive for closing targets, so it is the
+ *   negative of the range rate.
+ * - plasma:detection_power: Interpolated peak power
+ * - plasma:detection_beam: Beam index (a u64vector). When the map holds several
+ *   beams (plasma:num_beams), their maps are side by side along doppler, and each
+ *   detection is refined within its own beam.
+ *
+ * Only the cells around each detection are read, so the cost scales with the number
+ * of detections rather than the size of the map. Both complex maps and power maps
+ * (from noncoherent_integrator) are accepted.
+ */
+class PLASMA_API detection_refiner : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<detection_refiner> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of plasma::detection_refiner.
+     *
+     * To avoid accidental use of raw pointers, plasma::detection_refiner's
+     * constructor is in a private implementation
+     * class. plasma::detection_refiner::make is the public interface for
+     * creating new instances.
+     *
+     * \param num_cols Number of doppler bins in each map, used until the metadata
+     * gives a doppler FFT size
+     */
+    static sptr make(size_t num_cols);
+
+    virtual void set_metadata_keys(std::string detection_indices_key,
+                                   std::string doppler_fft_size_key) = 0;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_DETECTION_REFINER_H */
@@ -10,18 +10,74 @@
 
 #include <gnuradio/plasma/api.h>
 #include <arrayfire.h>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace gr {
 namespace plasma {
 
 /*!
- * \brief <+description+>
+ * \brief ArrayFire execution context for a single block
+ *
+ * Stores the backend, device ID, and (optionally) the CPU cores that a block's
+ * ArrayFire computations should use. The ArrayFire backend and active device are
+ * thread-local, so the block calls bind() from its message handler(s) before doing any
+ * ArrayFire work rather than modifying the global state when it is constructed.
  *
  */
 class PLASMA_API Device
 {
 public:
     enum Backend { DEFAULT, CPU, CUDA, OPENCL };
+
+    Device();
+    Device(Backend backend, int device_id = 0);
+    Device(const Device& other);
+    Device& operator=(const Device& other);
+
+    /*!
+     * \brief Set the ArrayFire backend used by the block
+     */
+    void set_backend(Backend backend);
+
+    /*!
+     * \brief Set the index of the device to use within the selected backend
+     */
+    void set_device_id(int device_id);
+
+    /*!
+     * \brief Pin the thread that runs the block (and the ArrayFire CPU backend worker
+     * threads it spawns) to the given cores. An empty vector leaves the affinity
+     * unchanged.
+     */
+    void set_cpu_affinity(const std::vector<int>& cores);
+
+    Backend backend() const;
+    int device_id() const;
+    std::vector<int> cpu_affinity() const;
+
+    /*!
+     * \brief Make this the active ArrayFire backend and device for the calling thread
+     *
+     * Thread pinning is only applied the first time this is called from a given
+     * thread, or after the configuration has changed.
+     *
+     * \return true if the configuration changed or the calling thread differs from the
+     * previous call, in which case arrays created under the old context should be
+     * recreated.
+     */
+    bool bind();
+
+    static af::Backend to_af_backend(Backend backend);
+
+private:
+    mutable std::mutex d_mutex;
+    Backend d_backend;
+    int d_device_id;
+    std::vector<int> d_cpu_affinity;
+    bool d_changed;
+    std::thread::id d_bound_thread;
 };
 
 } // namespace plasma
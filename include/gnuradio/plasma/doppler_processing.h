@@ -9,8 +9,10 @@
 #define INCLUDED_PLASMA_DOPPLER_PROCESSING_H
 
 #include <gnuradio/block.h>
+#include <gnuradio/plasma/admission_control.h>
 #include <gnuradio/plasma/api.h>
 #include <gnuradio/plasma/device.h>
+#include <vector>
 // #include "device.h"
 
 namespace gr {
@@ -38,10 +40,70 @@ public:
 
     virtual void set_msg_queue_depth(size_t) = 0;
 
+    /*!
+     * \brief Select how the block handles a backlog of input messages
+     *
+     * \param policy KEEP_LATEST discards all but the newest messages once more than
+     * the message queue depth are waiting, FIFO processes every message, and
+     * RATE_LIMITED processes at most max_rate messages per second.
+     * \param max_rate Maximum processing rate (messages/s) for RATE_LIMITED
+     */
+    virtual void set_admission_policy(AdmissionControl::Policy policy,
+                                      double max_rate = 0) = 0;
+
+    /*!
+     * \brief Number of input messages discarded by the admission policy
+     */
+    virtual uint64_t num_dropped() = 0;
+
+    /*!
+     * \brief Set the maximum number of CPIs processed per batch
+     *
+     * When the block falls behind, up to batch_size queued CPIs with the same
+     * dimensions are processed as one batched FFT. When it keeps up, each CPI is still
+     * processed as soon as it arrives. Batches are gathered after the admission
+     * policy is applied, so with KEEP_LATEST the queue depth should be at least
+     * batch_size.
+     *
+     * \param batch_size Maximum CPIs per batch. A value of 1 (the default) disables
+     * batching.
+     */
+    virtual void set_batch_size(size_t batch_size) = 0;
+
     virtual void set_backend(Device::Backend) = 0;
+    /*!
+     * \brief Select the device to use within the ArrayFire backend
+     */
+    virtual void set_device_id(int device_id) = 0;
+    /*!
+     * \brief Pin the block's processing thread to the given CPU cores
+     */
+    virtual void set_cpu_affinity(const std::vector<int>& cores) = 0;
 
     virtual void set_metadata_keys(const std::string& n_pulse_cpi_key,
                                    const std::string& doppler_fft_size_key) = 0;
+
+    /*!
+     * \brief Apply a moving target indication (MTI) filter across the pulses of each
+     * range bin before the Doppler FFT
+     *
+     * For example, {1, -1} is a two-pulse canceller and {1, -2, 1} is a three-pulse
+     * canceller. The first taps.size() - 1 pulses of each CPI only partially overlap
+     * the filter, so they are dropped before the FFT. CPIs with fewer pulses than taps
+     * are passed through unfiltered, and a warning is logged.
+     *
+     * \param taps Slow-time FIR filter taps. An empty vector disables the filter.
+     * \param fused If true, the filter is applied as a multiply in the Doppler domain
+     * instead. This is cheaper, but the filter wraps around the CPI unless the FFT size
+     * is at least the number of pulses plus taps.size() - 1, and no pulses are dropped.
+     */
+    virtual void set_mti_filter(const std::vector<gr_complex>& taps, bool fused) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
 };
 
 } // namespace plasma
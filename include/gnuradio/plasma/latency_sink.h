@@ -0,0 +1,57 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_LATENCY_SINK_H
+#define INCLUDED_PLASMA_LATENCY_SINK_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/plasma/api.h>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Summarize the plasma:latency traces of incoming PDUs
+ * \ingroup plasma
+ *
+ * For each stage in the trace, the block measures the processing time (exit - entry)
+ * and the latency the stage adds to the chain (its exit time minus the previous
+ * stage's exit time, which includes time spent waiting in its message queue). The
+ * end-to-end latency is the time from the first stage's entry to the arrival of the
+ * message at this block.
+ *
+ * Every report_interval messages, the p50/p99/max of each measurement (in ms) is
+ * logged and published on the stats port as a dictionary mapping each stage to a
+ * dictionary of statistics.
+ */
+class PLASMA_API latency_sink : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<latency_sink> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of plasma::latency_sink.
+     *
+     * To avoid accidental use of raw pointers, plasma::latency_sink's
+     * constructor is in a private implementation
+     * class. plasma::latency_sink::make is the public interface for
+     * creating new instances.
+     *
+     * \param report_interval Number of traced messages between reports
+     */
+    static sptr make(size_t report_interval);
+
+    /*!
+     * \brief Discard all measurements collected since the last report
+     */
+    virtual void reset() = 0;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_LATENCY_SINK_H */
@@ -18,6 +18,12 @@ namespace plasma {
  * \brief Generates a linear frequency modulated waveform
  * \ingroup plasma
  *
+ * The waveform parameters can be changed with messages on the "in" port, either as a
+ * single (key . value) pair or as a dictionary, where the keys are the metadata keys set
+ * by init_meta_dict(). All parameters in a dictionary are applied before the waveform
+ * is regenerated, so the dictionary produces exactly one new waveform. If the
+ * dictionary contains a plasma:effective_sample index, it is forwarded in the PDU
+ * metadata so that usrp_radar switches to the new waveform at that transmit sample.
  */
 class PLASMA_API lfm_source : virtual public gr::block
 {
@@ -49,6 +55,16 @@ public:
                                 const std::string& sample_rate_key,
                                 const std::string& label_key,
                                 const std::string& prf_key) = 0;
+
+    /**
+     * @brief Set the number of waveforms kept in the cache
+     *
+     * Generated waveforms are cached by their parameters, so switching back to a
+     * recently used waveform reuses its data instead of regenerating it.
+     *
+     * @param size Maximum number of cached waveforms
+     */
+    virtual void set_cache_size(size_t size) = 0;
 };
 
 } // namespace plasma
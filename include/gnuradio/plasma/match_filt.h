@@ -9,8 +9,10 @@
 #define INCLUDED_PLASMA_MATCH_FILT_H
 
 #include <gnuradio/block.h>
+#include <gnuradio/plasma/admission_control.h>
 #include <gnuradio/plasma/api.h>
 #include <gnuradio/plasma/device.h>
+#include <vector>
 
 
 namespace gr {
@@ -37,8 +39,63 @@ public:
     static sptr make(size_t num_pulse_cpi);
 
     virtual void set_msg_queue_depth(size_t depth) = 0;
+
+    /*!
+     * \brief Select how the block handles a backlog of input messages
+     *
+     * \param policy KEEP_LATEST discards all but the newest messages once more than
+     * the message queue depth are waiting, FIFO processes every message, and
+     * RATE_LIMITED processes at most max_rate messages per second.
+     * \param max_rate Maximum processing rate (messages/s) for RATE_LIMITED
+     */
+    virtual void set_admission_policy(AdmissionControl::Policy policy,
+                                      double max_rate = 0) = 0;
+
+    /*!
+     * \brief Number of input messages discarded by the admission policy
+     */
+    virtual uint64_t num_dropped() = 0;
+
+    /*!
+     * \brief Set the maximum number of CPIs processed per batch
+     *
+     * When the block falls behind, up to batch_size queued CPIs with the same
+     * dimensions are pulse compressed in a single call. When it keeps up, each CPI is
+     * still processed as soon as it arrives. Batches are gathered after the admission
+     * policy is applied, so with KEEP_LATEST the queue depth should be at least
+     * batch_size.
+     *
+     * \param batch_size Maximum CPIs per batch. A value of 1 (the default) disables
+     * batching.
+     */
+    virtual void set_batch_size(size_t batch_size) = 0;
     virtual void set_backend(Device::Backend) = 0;
+    /*!
+     * \brief Select the device to use within the ArrayFire backend
+     */
+    virtual void set_device_id(int device_id) = 0;
+    /*!
+     * \brief Pin the block's processing thread to the given CPU cores
+     */
+    virtual void set_cpu_affinity(const std::vector<int>& cores) = 0;
     virtual void set_metadata_keys(const std::string& n_pulse_cpi_key) = 0;
+
+    /*!
+     * \brief Only compute and output the range bins between min_gate and max_gate
+     *
+     * \param min_gate Minimum range gate
+     * \param max_gate Maximum range gate. Gating is disabled if this is not greater
+     * than min_gate.
+     * \param in_meters If true, the gates are ranges in meters. Otherwise, they are
+     * delays in samples relative to the start of the transmission.
+     */
+    virtual void set_range_gates(double min_gate, double max_gate, bool in_meters) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
 };
 
 } // namespace plasma
@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_NONCOHERENT_INTEGRATOR_H
+#define INCLUDED_PLASMA_NONCOHERENT_INTEGRATOR_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/plasma/api.h>
+#include <gnuradio/plasma/device.h>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Noncoherently integrate the power of consecutive range-doppler maps
+ * \ingroup plasma
+ *
+ * Each input PDU holds a complex map (e.g., from doppler_processing). Its power
+ * |x|^2 is added to an accumulator that stays on the device between CPIs, so each
+ * CPI costs a single multiply-add pass. The output PDUs hold the integrated power
+ * as an f32vector, which cfar2D and range_doppler_sink accept in place of complex
+ * data.
+ *
+ * The number of CPIs integrated into each output is attached to its metadata as
+ * plasma:num_integrated, which cfar2D uses to keep its false alarm rate. For an
+ * exponentially weighted average, this is the equivalent number of independent
+ * CPIs.
+ *
+ * The accumulator is reset whenever the size of the input changes.
+ */
+class PLASMA_API noncoherent_integrator : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<noncoherent_integrator> sptr;
+
+    enum Method {
+        SUM,         //!< Sum num_cpi maps, then output the sum and start again
+        EXPONENTIAL, //!< Output a running average with weight 1/num_cpi on every CPI
+    };
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of plasma::noncoherent_integrator.
+     *
+     * To avoid accidental use of raw pointers, plasma::noncoherent_integrator's
+     * constructor is in a private implementation
+     * class. plasma::noncoherent_integrator::make is the public interface for
+     * creating new instances.
+     *
+     * \param num_cpi Number of CPIs to integrate (or the time constant, in CPIs, of
+     * the exponential average)
+     * \param method Integration method
+     */
+    static sptr make(size_t num_cpi, Method method = SUM);
+
+    /*!
+     * \brief Set the number of CPIs to integrate. This also resets the accumulator.
+     */
+    virtual void set_num_cpi(size_t num_cpi) = 0;
+
+    virtual void set_backend(Device::Backend) = 0;
+    /*!
+     * \brief Select the device to use within the ArrayFire backend
+     */
+    virtual void set_device_id(int device_id) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_NONCOHERENT_INTEGRATOR_H */
@@ -16,9 +16,15 @@ namespace gr {
 namespace plasma {
 
 /*!
- * \brief <+description of block+>
+ * \brief Generates a polyphase-coded FM (PCFM) waveform
  * \ingroup plasma
  *
+ * The waveform can be changed with messages on the "in" port, either as a single
+ * (key . value) pair or as a dictionary, using the phase code class, number of chips
+ * and sample rate keys set by set_metadata_keys() and radar:oversampling. The phase
+ * code class is given by its name (e.g., "frank") or its PhaseCode::Code value. All
+ * parameters in a dictionary are applied before the waveform is regenerated, and a
+ * plasma:effective_sample index is forwarded in the PDU metadata.
  */
 class PLASMA_API pcfm_source : virtual public gr::block
 {
@@ -40,6 +46,16 @@ public:
                                    const std::string& n_phase_code_chips_key,
                                    const std::string& duration_key,
                                    const std::string& sample_rate_key) = 0;
+
+    /**
+     * @brief Set the number of waveforms kept in the cache
+     *
+     * Generated waveforms are cached by their parameters, so switching back to a
+     * recently used waveform reuses its data instead of regenerating it.
+     *
+     * @param size Maximum number of cached waveforms
+     */
+    virtual void set_cache_size(size_t size) = 0;
 };
 
 } // namespace plasma
@@ -45,6 +45,42 @@ public:
      * 
      */
     P4,
+    /**
+     * P1 code (length must be a perfect square)
+     *
+     */
+    P1,
+    /**
+     * P2 code (length must be the square of an even number)
+     *
+     */
+    P2,
+    /**
+     * P3 code
+     *
+     */
+    P3,
+    /**
+     * Px code (length must be a perfect square)
+     *
+     */
+    PX,
+    /**
+     * Zadoff-Chu code with root index 1
+     *
+     */
+    ZADOFF_CHU,
+    /**
+     * Phase of a Costas frequency hopping sequence with n = N^2 chips, where N + 1 is
+     * prime. Each of the N hops lasts N chips.
+     *
+     */
+    COSTAS,
+    /**
+     * Minimum peak sidelobe binary code (lengths 2-42)
+     *
+     */
+    MPS,
     /**
      * Arbitrary (currently invalid) code type
      *
@@ -63,6 +99,14 @@ public:
 
   static std::string code_string(Code);
 
+  /**
+   * @brief Return the frequency order of a Welch-Costas sequence of length n
+   *
+   * @param n Sequence length. n + 1 must be prime.
+   * @return std::vector<int> A permutation of 0, ..., n - 1
+   */
+  static std::vector<int> costas_sequence(int n);
+
   static void wrapToPi(std::vector<double>&);
 };
 
@@ -8,6 +8,7 @@ static const pmt::pmt_t PMT_OUT = pmt::intern("out");
 static const pmt::pmt_t PMT_TX = pmt::intern("tx");
 static const pmt::pmt_t PMT_RX = pmt::intern("rx");
 static const pmt::pmt_t PMT_PDU = pmt::intern("pdu");
+static const pmt::pmt_t PMT_TRACE = pmt::intern("trace");
 
 // SigMF core
 static const pmt::pmt_t PMT_GLOBAL = pmt::intern("global");
@@ -31,6 +32,51 @@ static const pmt::pmt_t PMT_DOPPLER_FFT_SIZE = pmt::intern("radar:doppler_fft_si
 static const pmt::pmt_t PMT_PHASE_CODE_CLASS = pmt::intern("radar:phase_code_class");
 static const pmt::pmt_t PMT_NUM_PHASE_CODE_CHIPS =
     pmt::intern("radar:num_phase_code_chips");
+// Samples per chip of a phase-coded waveform
+static const pmt::pmt_t PMT_OVERSAMPLING = pmt::intern("radar:oversampling");
+// Delay (in samples) of the first row and one past the last row of range-gated data
+static const pmt::pmt_t PMT_RANGE_GATE_START = pmt::intern("radar:range_gate_start");
+static const pmt::pmt_t PMT_RANGE_GATE_STOP = pmt::intern("radar:range_gate_stop");
+
+// Reserved keys
+// Latency trace: dict mapping each stage (block alias) to a u64vector containing its
+// entry and exit times in nanoseconds since the system clock epoch
+static const pmt::pmt_t PMT_LATENCY = pmt::intern("plasma:latency");
+// Scheduled waveform update: transmit sample index (as counted by usrp_radar) at which
+// the waveform in a PDU takes effect
+static const pmt::pmt_t PMT_EFFECTIVE_SAMPLE = pmt::intern("plasma:effective_sample");
+// Waveform banks: the number of waveforms in a bank, the number of samples in its
+// longest waveform, the bank index transmitted in each PRI (u32vector, repeated once
+// exhausted), and the bank index of each received pulse (a u32vector for CPIs)
+static const pmt::pmt_t PMT_NUM_WAVEFORMS = pmt::intern("plasma:num_waveforms");
+static const pmt::pmt_t PMT_WAVEFORM_LENGTH = pmt::intern("plasma:waveform_length");
+static const pmt::pmt_t PMT_WAVEFORM_SCHEDULE = pmt::intern("plasma:waveform_schedule");
+static const pmt::pmt_t PMT_WAVEFORM_INDEX = pmt::intern("plasma:waveform_index");
+// Start sample of each pulse in a transmit buffer holding several PRIs (u64vector)
+static const pmt::pmt_t PMT_PULSE_OFFSETS = pmt::intern("plasma:pulse_offsets");
+// Receive delay (in samples, between 0 and 1) that remains after usrp_radar discards
+// the whole samples of its calibrated delay
+static const pmt::pmt_t PMT_FRACTIONAL_DELAY = pmt::intern("plasma:fractional_delay");
+// Receive time (in seconds since usrp_radar started streaming) of the first sample of a
+// received buffer, or of the first pulse of a CPI
+static const pmt::pmt_t PMT_RX_TIME = pmt::intern("plasma:rx_time");
+// Number of CPIs noncoherently integrated into a power map (or the equivalent number
+// for an exponentially weighted average)
+static const pmt::pmt_t PMT_NUM_INTEGRATED = pmt::intern("plasma:num_integrated");
+// Refined estimates for each detection of a range-doppler map (f64vectors): range (m),
+// doppler shift (Hz), radial velocity (m/s), and interpolated peak power
+static const pmt::pmt_t PMT_DETECTION_RANGE = pmt::intern("plasma:detection_range");
+static const pmt::pmt_t PMT_DETECTION_DOPPLER = pmt::intern("plasma:detection_doppler");
+static const pmt::pmt_t PMT_DETECTION_VELOCITY = pmt::intern("plasma:detection_velocity");
+static const pmt::pmt_t PMT_DETECTION_POWER = pmt::intern("plasma:detection_power");
+// Beam of each detection in a map with several stacked beams (u64vector)
+static const pmt::pmt_t PMT_DETECTION_BEAM = pmt::intern("plasma:detection_beam");
+// ID of each confirmed track in the output of a tracker (u64vector)
+static const pmt::pmt_t PMT_TRACK_ID = pmt::intern("plasma:track_id");
+// Multi-channel CPIs: the number of receive channels in a [samples x pulses x channels]
+// cube, and the number of beams stacked in a [samples x pulses x beams] cube
+static const pmt::pmt_t PMT_NUM_CHANNELS = pmt::intern("plasma:num_channels");
+static const pmt::pmt_t PMT_NUM_BEAMS = pmt::intern("plasma:num_beams");
 
 
 #endif /* B4AE609D_6687_4998_809D_482441F2B6F9 */
@@ -9,9 +9,11 @@
 #define INCLUDED_PLASMA_PULSE_DOPPLER_H
 
 #include <gnuradio/block.h>
+#include <gnuradio/plasma/admission_control.h>
 #include <gnuradio/plasma/api.h>
 #include <arrayfire.h>
 #include <gnuradio/plasma/device.h>
+#include <vector>
 
 namespace gr {
 namespace plasma {
@@ -37,9 +39,44 @@ public:
     static sptr make(int n_pulse_cpi, int doppler_fft_size);
 
     virtual void set_msg_queue_depth(size_t depth) = 0;
+
+    /*!
+     * \brief Select how the block handles a backlog of input messages
+     *
+     * \param policy KEEP_LATEST discards all but the newest messages once more than
+     * the message queue depth are waiting, FIFO processes every message, and
+     * RATE_LIMITED processes at most max_rate messages per second.
+     * \param max_rate Maximum processing rate (messages/s) for RATE_LIMITED
+     */
+    virtual void set_admission_policy(AdmissionControl::Policy policy,
+                                      double max_rate = 0) = 0;
+
+    /*!
+     * \brief Number of input messages discarded by the admission policy
+     */
+    virtual uint64_t num_dropped() = 0;
     virtual void set_backend(Device::Backend) = 0;
+    /*!
+     * \brief Select the device to use within the ArrayFire backend
+     */
+    virtual void set_device_id(int device_id) = 0;
+    /*!
+     * \brief Pin the block's processing thread to the given CPU cores
+     */
+    virtual void set_cpu_affinity(const std::vector<int>& cores) = 0;
 
     virtual void init_meta_dict(std::string doppler_fft_size_key) = 0;
+
+    /*!
+     * \brief Only compute and output the range bins between min_gate and max_gate
+     *
+     * \param min_gate Minimum range gate
+     * \param max_gate Maximum range gate. Gating is disabled if this is not greater
+     * than min_gate.
+     * \param in_meters If true, the gates are ranges in meters. Otherwise, they are
+     * delays in samples relative to the start of the transmission.
+     */
+    virtual void set_range_gates(double min_gate, double max_gate, bool in_meters) = 0;
 };
 
 } // namespace plasma
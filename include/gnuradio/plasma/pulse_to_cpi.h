@@ -35,6 +35,15 @@ public:
     static sptr make(size_t n_pulse_cpi);
 
     virtual void init_meta_dict(std::string n_pulse_cpi_key) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field
+     *
+     * The output CPI always carries the trace of its first pulse, so downstream
+     * latencies are measured from the oldest sample in the CPI.
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
 };
 
 } // namespace plasma
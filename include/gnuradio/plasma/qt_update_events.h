@@ -7,25 +7,87 @@
 #include <vector>
 
 static constexpr int RadarUpdateEventType = 4096;
+static constexpr int WaterfallUpdateEventType = 4097;
 
 class RangeDopplerUpdateEvent : public QEvent
 {
 public:
-    RangeDopplerUpdateEvent(const double* data,
+    /**
+     * @brief Construct a new update event
+     *
+     * @param data Row-major image data, which is moved into the event
+     * @param rows Number of rows in the image
+     * @param cols Number of columns in the image
+     * @param input_rows Number of rows in the map before it was decimated for display
+     * @param input_cols Number of columns in the map before it was decimated for display
+     * @param zmin Minimum value in the image, used for the color scale
+     * @param zmax Maximum value in the image, used for the color scale
+     * @param meta Metadata dictionary of the map
+     */
+    RangeDopplerUpdateEvent(std::vector<float>&& data,
                             size_t rows,
                             size_t cols,
+                            size_t input_rows,
+                            size_t input_cols,
+                            double zmin,
+                            double zmax,
                             pmt::pmt_t meta);
     ~RangeDopplerUpdateEvent() override;
-    double* data();
+    std::vector<float>& data();
     const size_t cols();
     const size_t rows();
+    const size_t input_cols();
+    const size_t input_rows();
+    double zmin() const;
+    double zmax() const;
     const pmt::pmt_t meta();
     static QEvent::Type Type() { return QEvent::Type(RadarUpdateEventType); }
 
 private:
-    double* d_data;
+    std::vector<float> d_data;
     size_t d_rows;
     size_t d_cols;
+    size_t d_input_rows;
+    size_t d_input_cols;
+    double d_zmin;
+    double d_zmax;
+    pmt::pmt_t d_meta;
+};
+
+class WaterfallUpdateEvent : public QEvent
+{
+public:
+    /**
+     * @brief Construct a new update event
+     *
+     * @param row New row of the waterfall, which is moved into the event
+     * @param mode Display mode (gr::plasma::range_doppler_sink::DisplayMode) the row
+     * was reduced for
+     * @param history Number of rows to keep in the waterfall
+     * @param zmin Minimum value of the color scale
+     * @param zmax Maximum value of the color scale
+     * @param meta Metadata dictionary of the CPI
+     */
+    WaterfallUpdateEvent(std::vector<float>&& row,
+                         int mode,
+                         size_t history,
+                         double zmin,
+                         double zmax,
+                         pmt::pmt_t meta);
+    std::vector<float>& row();
+    int mode() const;
+    size_t history() const;
+    double zmin() const;
+    double zmax() const;
+    const pmt::pmt_t meta();
+    static QEvent::Type Type() { return QEvent::Type(WaterfallUpdateEventType); }
+
+private:
+    std::vector<float> d_row;
+    int d_mode;
+    size_t d_history;
+    double d_zmin;
+    double d_zmax;
     pmt::pmt_t d_meta;
 };
 
@@ -9,6 +9,7 @@
 #define INCLUDED_PLASMA_RANGE_DOPPLER_SINK_H
 
 #include <gnuradio/block.h>
+#include <gnuradio/plasma/admission_control.h>
 #include <gnuradio/plasma/api.h>
 #ifdef ENABLE_PYTHON
 #pragma push_macro("slots")
@@ -33,6 +34,12 @@ class PLASMA_API range_doppler_sink : virtual public gr::block
 public:
     typedef std::shared_ptr<range_doppler_sink> sptr;
 
+    enum DisplayMode {
+        RANGE_DOPPLER, //!< Range-doppler map of the latest CPI
+        RANGE_TIME,    //!< Range-time intensity waterfall (peak over doppler)
+        DOPPLER_TIME,  //!< Doppler-time waterfall (peak over range)
+    };
+
     /*!
      * \brief Return a shared_ptr to a new instance of plasma::range_doppler_sink.
      *
@@ -52,8 +59,38 @@ public:
 #endif
 
     virtual void set_dynamic_range(const double) = 0;
+
+    /*!
+     * \brief Select what is displayed
+     *
+     * In the waterfall modes, each CPI is reduced to one row, which is added to the top
+     * of a scrolling history that is kept in a fixed-size buffer. Rows are scaled to a
+     * running peak that decays over the history, so changes in intensity from one CPI
+     * to the next stay visible. The range-doppler map is scaled to its own peak.
+     *
+     * \param mode Display mode
+     * \param history Number of CPIs shown in the waterfall modes
+     */
+    virtual void set_display_mode(DisplayMode mode, size_t history) = 0;
+
     virtual void set_msg_queue_depth(size_t depth) = 0;
 
+    /*!
+     * \brief Select how the block handles a backlog of input messages
+     *
+     * \param policy KEEP_LATEST discards all but the newest messages once more than
+     * the message queue depth are waiting, FIFO processes every message, and
+     * RATE_LIMITED processes at most max_rate messages per second.
+     * \param max_rate Maximum processing rate (messages/s) for RATE_LIMITED
+     */
+    virtual void set_admission_policy(AdmissionControl::Policy policy,
+                                      double max_rate = 0) = 0;
+
+    /*!
+     * \brief Number of input messages discarded by the admission policy
+     */
+    virtual uint64_t num_dropped() = 0;
+
     virtual void set_metadata_keys(std::string samp_rate_key,
                                    std::string n_matrix_col_key,
                                    std::string center_freq_key,
@@ -61,6 +98,13 @@ public:
                                    std::string prf_key,
                                    std::string pulsewidth_key,
                                    std::string detection_indices_key) = 0;
+
+    /*!
+     * \brief Record the time each message enters and leaves this block in the
+     * plasma:latency metadata field, and publish the metadata of every displayed
+     * CPI on the trace port (e.g., for a latency_sink)
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
 };
 
 } // namespace plasma
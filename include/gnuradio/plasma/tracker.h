@@ -0,0 +1,79 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_TRACKER_H
+#define INCLUDED_PLASMA_TRACKER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/plasma/api.h>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Track the detections of consecutive CPIs in range and radial velocity
+ * \ingroup plasma
+ *
+ * The input is the output of a detection_refiner, which gives the range and velocity
+ * of each cfar2D detection. The refined velocity is positive for closing targets, so
+ * it is negated to give the range rate. Each track's range and range rate are
+ * smoothed with an alpha-beta filter, and detections are associated with tracks by
+ * gated nearest neighbor assignment. A track is confirmed after num_confirm
+ * consecutive hits, and deleted after more than max_misses consecutive misses (or on
+ * its first miss, if it isn't confirmed yet).
+ *
+ * The time between updates is the difference between the receive times of the CPIs
+ * (plasma:rx_time, from usrp_radar). Without receive times, the CPIs are assumed to
+ * be back to back, so the time between updates is num_pulse_cpi / PRF.
+ *
+ * One PDU is published per CPI with the confirmed tracks. Its data is an f64vector
+ * holding the range (m) of each track followed by the range rate (m/s) of each
+ * track, and its metadata has the track IDs (plasma:track_id, a u64vector) and the
+ * sample start of the CPI (if known).
+ */
+class PLASMA_API tracker : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<tracker> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of plasma::tracker.
+     *
+     * To avoid accidental use of raw pointers, plasma::tracker's
+     * constructor is in a private implementation
+     * class. plasma::tracker::make is the public interface for
+     * creating new instances.
+     *
+     * \param range_gate Half-width of the association gate in range (m)
+     * \param velocity_gate Half-width of the association gate in velocity (m/s). If
+     * zero, velocity is not used for association.
+     * \param alpha Range smoothing gain
+     * \param beta Range rate smoothing gain
+     * \param num_confirm Number of consecutive hits that confirm a track
+     * \param max_misses Number of consecutive misses a confirmed track survives
+     */
+    static sptr make(double range_gate,
+                     double velocity_gate,
+                     double alpha,
+                     double beta,
+                     size_t num_confirm,
+                     size_t max_misses);
+
+    virtual void set_gates(double range_gate, double velocity_gate) = 0;
+    virtual void set_gains(double alpha, double beta) = 0;
+    virtual void set_confirmation(size_t num_confirm, size_t max_misses) = 0;
+
+    /*!
+     * \brief Delete every track
+     */
+    virtual void reset() = 0;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_TRACKER_H */
@@ -18,6 +18,20 @@ namespace plasma {
  * \brief A block that simultaneously transmits and receives data from a USRP device
  * \ingroup plasma
  *
+ * New waveforms are switched in at a pulse boundary. If the PDU metadata contains
+ * plasma:effective_sample, the switch is deferred until at least that many samples
+ * have been transmitted.
+ *
+ * A waveform bank from plasma::waveform_bank is transmitted one PRI at a time following
+ * its schedule, and each received pulse is tagged with plasma:waveform_index.
+ *
+ * The receive delay from the calibration file may be fractional. Its whole samples are
+ * discarded when streaming starts, and the remainder is published as
+ * plasma:fractional_delay with each new waveform so that plasma::match_filt can
+ * correct for it.
+ *
+ * Each received PDU is stamped with its receive time (plasma:rx_time), which
+ * plasma::pulse_to_cpi passes on with each CPI.
  */
 class PLASMA_API usrp_radar : virtual public gr::block
 {
@@ -46,6 +60,12 @@ public:
     virtual void set_metadata_keys(const std::string& tx_freq_key,
                                    const std::string& rx_freq_key,
                                    const std::string& sample_start_key) = 0;
+
+    /*!
+     * \brief Start a plasma:latency trace in the metadata of each received PDU,
+     * recording when the samples reached the host and when the PDU was published
+     */
+    virtual void set_latency_tracing(bool enable) = 0;
 };
 
 } // namespace plasma
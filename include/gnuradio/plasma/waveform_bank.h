@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_WAVEFORM_BANK_H
+#define INCLUDED_PLASMA_WAVEFORM_BANK_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/plasma/api.h>
+
+namespace gr {
+namespace plasma {
+
+/*!
+ * \brief Collect waveforms into a bank that is transmitted following a pulse-to-pulse
+ * schedule
+ * \ingroup plasma
+ *
+ * Each waveform PDU received on the input port fills a slot of the bank. The slot is
+ * given by plasma:waveform_index in the PDU metadata, or is the slot after the last
+ * one filled if the key is absent. Once every slot has been filled (and each time a
+ * slot or the schedule changes afterwards), the bank is published as a single PDU
+ * containing each waveform zero-padded to one PRI, back to back.
+ *
+ * The schedule is attached to the output metadata as plasma:waveform_schedule. When
+ * usrp_radar receives a bank, it transmits the scheduled waveform in each PRI directly
+ * from the bank and tags each received pulse with its waveform index. When match_filt
+ * receives a bank on its tx port, it builds one matched filter per waveform and
+ * selects the filter for each pulse from those indices.
+ */
+class PLASMA_API waveform_bank : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<waveform_bank> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of plasma::waveform_bank.
+     *
+     * To avoid accidental use of raw pointers, plasma::waveform_bank's
+     * constructor is in a private implementation
+     * class. plasma::waveform_bank::make is the public interface for
+     * creating new instances.
+     *
+     * \param num_waveforms Number of waveforms in the bank
+     * \param schedule Bank index of the waveform transmitted in each PRI, repeated once
+     * exhausted. If empty, the waveforms are transmitted in order.
+     * \param prf Pulse repetition frequency (Hz)
+     * \param samp_rate Sample rate (samples/s)
+     */
+    static sptr make(size_t num_waveforms,
+                     const std::vector<int>& schedule,
+                     double prf,
+                     double samp_rate);
+
+    /*!
+     * \brief Set the bank index of the waveform transmitted in each PRI
+     */
+    virtual void set_schedule(const std::vector<int>& schedule) = 0;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_WAVEFORM_BANK_H */
@@ -0,0 +1,88 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <gnuradio/plasma/admission_control.h>
+
+namespace gr {
+namespace plasma {
+
+AdmissionControl::AdmissionControl()
+    : d_policy(KEEP_LATEST),
+      d_queue_depth(1),
+      d_max_rate(0),
+      d_num_dropped(0),
+      d_num_processed(0),
+      d_last_admit()
+{
+}
+
+void AdmissionControl::set_policy(Policy policy) { d_policy = policy; }
+
+AdmissionControl::Policy AdmissionControl::policy() const { return d_policy; }
+
+void AdmissionControl::set_queue_depth(size_t depth) { d_queue_depth = depth; }
+
+size_t AdmissionControl::queue_depth() const { return d_queue_depth; }
+
+void AdmissionControl::set_max_rate(double rate) { d_max_rate = rate; }
+
+double AdmissionControl::max_rate() const { return d_max_rate; }
+
+bool AdmissionControl::admit(gr::basic_block* block,
+                             const pmt::pmt_t& port,
+                             pmt::pmt_t& msg)
+{
+    switch (d_policy) {
+    case KEEP_LATEST: {
+        // Skip ahead to the newest message, leaving at most queue_depth behind it
+        uint64_t ndrop = 0;
+        while (block->nmsgs(port) > d_queue_depth) {
+            pmt::pmt_t next = block->delete_head_nowait(port);
+            if (not next)
+                break;
+            msg = next;
+            ndrop++;
+        }
+        d_num_dropped += ndrop;
+        break;
+    }
+    case RATE_LIMITED: {
+        double rate = d_max_rate;
+        auto now = std::chrono::steady_clock::now();
+        if (rate > 0 and std::chrono::duration<double>(now - d_last_admit).count() <
+                             1.0 / rate) {
+            d_num_dropped++;
+            return false;
+        }
+        d_last_admit = now;
+        break;
+    }
+    case FIFO:
+    default:
+        break;
+    }
+    d_num_processed++;
+    return true;
+}
+
+void AdmissionControl::record_drop(uint64_t n)
+{
+    d_num_dropped += n;
+}
+
+uint64_t AdmissionControl::num_dropped() const { return d_num_dropped; }
+
+uint64_t AdmissionControl::num_processed() const { return d_num_processed; }
+
+void AdmissionControl::reset_counters()
+{
+    d_num_dropped = 0;
+    d_num_processed = 0;
+}
+
+} /* namespace plasma */
+} /* namespace gr */
@@ -0,0 +1,166 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "alpha_beta_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace gr {
+namespace plasma {
+
+AlphaBetaTracker::AlphaBetaTracker(double range_gate,
+                                   double velocity_gate,
+                                   double alpha,
+                                   double beta,
+                                   size_t num_confirm,
+                                   size_t max_misses)
+    : d_next_id(0)
+{
+    set_gates(range_gate, velocity_gate);
+    set_gains(alpha, beta);
+    set_confirmation(num_confirm, max_misses);
+}
+
+void AlphaBetaTracker::set_gates(double range_gate, double velocity_gate)
+{
+    d_range_gate = range_gate;
+    d_velocity_gate = velocity_gate;
+}
+
+void AlphaBetaTracker::set_gains(double alpha, double beta)
+{
+    d_alpha = alpha;
+    d_beta = beta;
+}
+
+void AlphaBetaTracker::set_confirmation(size_t num_confirm, size_t max_misses)
+{
+    d_num_confirm = std::max<size_t>(num_confirm, 1);
+    d_max_misses = max_misses;
+}
+
+void AlphaBetaTracker::clear()
+{
+    d_id.clear();
+    d_range.clear();
+    d_velocity.clear();
+    d_hits.clear();
+    d_misses.clear();
+}
+
+void AlphaBetaTracker::update(double dt,
+                              const double* range,
+                              const double* velocity,
+                              size_t n)
+{
+    size_t ntrack = size();
+    for (size_t i = 0; i < ntrack; i++)
+        d_range[i] += d_velocity[i] * dt;
+
+    associate(range, velocity, n);
+
+    // Update the associated tracks and compact the ones that survive
+    size_t out = 0;
+    for (size_t i = 0; i < ntrack; i++) {
+        int32_t j = d_assignment[i];
+        if (j >= 0) {
+            double residual = range[j] - d_range[i];
+            d_range[i] += d_alpha * residual;
+            if (dt > 0)
+                d_velocity[i] += d_beta * residual / dt;
+            d_hits[i]++;
+            d_misses[i] = 0;
+        } else {
+            d_misses[i]++;
+            if (d_hits[i] < d_num_confirm or d_misses[i] > d_max_misses)
+                continue;
+        }
+        d_id[out] = d_id[i];
+        d_range[out] = d_range[i];
+        d_velocity[out] = d_velocity[i];
+        d_hits[out] = d_hits[i];
+        d_misses[out] = d_misses[i];
+        out++;
+    }
+    d_id.resize(out);
+    d_range.resize(out);
+    d_velocity.resize(out);
+    d_hits.resize(out);
+    d_misses.resize(out);
+
+    // Start tentative tracks on the remaining detections
+    for (size_t j = 0; j < n; j++) {
+        if (d_detection_used[j] or std::isnan(range[j]))
+            continue;
+        double v = velocity and not std::isnan(velocity[j]) ? velocity[j] : 0;
+        d_id.push_back(d_next_id++);
+        d_range.push_back(range[j]);
+        d_velocity.push_back(v);
+        d_hits.push_back(1);
+        d_misses.push_back(0);
+    }
+}
+
+void AlphaBetaTracker::associate(const double* range, const double* velocity, size_t n)
+{
+    size_t ntrack = size();
+    d_assignment.assign(ntrack, -1);
+    d_detection_used.assign(n, 0);
+    if (d_range_gate <= 0)
+        return;
+
+    // Sort the detections by range, so the detections in each track's range gate are
+    // found with a binary search
+    d_order.resize(n);
+    std::iota(d_order.begin(), d_order.end(), 0);
+    d_order.erase(std::remove_if(d_order.begin(),
+                                 d_order.end(),
+                                 [&](uint32_t j) { return std::isnan(range[j]); }),
+                  d_order.end());
+    std::sort(d_order.begin(), d_order.end(), [&](uint32_t a, uint32_t b) {
+        return range[a] < range[b];
+    });
+    d_sorted_range.resize(d_order.size());
+    for (size_t k = 0; k < d_order.size(); k++)
+        d_sorted_range[k] = range[d_order[k]];
+
+    d_candidates.clear();
+    bool use_velocity = velocity and d_velocity_gate > 0;
+    for (size_t i = 0; i < ntrack; i++) {
+        auto first = std::lower_bound(
+            d_sorted_range.begin(), d_sorted_range.end(), d_range[i] - d_range_gate);
+        for (auto it = first;
+             it != d_sorted_range.end() and *it <= d_range[i] + d_range_gate;
+             it++) {
+            uint32_t j = d_order[it - d_sorted_range.begin()];
+            double dr = (range[j] - d_range[i]) / d_range_gate;
+            double distance = dr * dr;
+            if (use_velocity and not std::isnan(velocity[j])) {
+                double dv = (velocity[j] - d_velocity[i]) / d_velocity_gate;
+                distance += dv * dv;
+            }
+            if (distance <= 1)
+                d_candidates.push_back({ distance, uint32_t(i), j });
+        }
+    }
+
+    std::sort(d_candidates.begin(),
+              d_candidates.end(),
+              [](const Candidate& a, const Candidate& b) {
+                  return a.distance < b.distance;
+              });
+    for (const Candidate& c : d_candidates) {
+        if (d_assignment[c.track] >= 0 or d_detection_used[c.detection])
+            continue;
+        d_assignment[c.track] = c.detection;
+        d_detection_used[c.detection] = 1;
+    }
+}
+
+} // namespace plasma
+} // namespace gr
@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_ALPHA_BETA_TRACKER_H
+#define INCLUDED_PLASMA_ALPHA_BETA_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief Range/range-rate tracks maintained with alpha-beta filters.
+ *
+ * Each update predicts every track forward, gates the detections against the
+ * predictions, associates them, and then updates, deletes, and starts tracks:
+ *
+ * - A detection falls in a track's gate if (dr / range_gate)^2 + (dv / velocity_gate)^2
+ *   <= 1, where dr and dv are its range and velocity residuals. The velocity term is
+ *   left out for detections without a velocity.
+ * - Gated pairs are assigned in order of increasing distance, and each track and
+ *   detection is used at most once. This is a greedy approximation to global nearest
+ *   neighbor assignment, which costs O(P log P) in the number of gated pairs instead
+ *   of the O(N^3) of an optimal assignment.
+ * - Tracks are confirmed after num_confirm consecutive hits. Tentative tracks are
+ *   deleted on their first miss, and confirmed tracks after more than max_misses
+ *   consecutive misses.
+ * - Each unassociated detection starts a tentative track, with its velocity (if any)
+ *   as the initial range rate.
+ *
+ * The tracks are stored as a structure of arrays, so each pass over them reads only
+ * the fields it needs, and deleted tracks are compacted in a single pass.
+ */
+class AlphaBetaTracker
+{
+public:
+    AlphaBetaTracker(double range_gate,
+                     double velocity_gate,
+                     double alpha,
+                     double beta,
+                     size_t num_confirm,
+                     size_t max_misses);
+
+    void set_gates(double range_gate, double velocity_gate);
+    void set_gains(double alpha, double beta);
+    void set_confirmation(size_t num_confirm, size_t max_misses);
+
+    /**
+     * @brief Advance the tracks by dt seconds and update them with a set of detections
+     *
+     * @param dt Time since the last update (s)
+     * @param range Range of each detection (m). NaN ranges are ignored.
+     * @param velocity Radial velocity of each detection (m/s), or nullptr if unknown
+     * @param n Number of detections
+     */
+    void update(double dt, const double* range, const double* velocity, size_t n);
+
+    /**
+     * @brief Delete every track
+     */
+    void clear();
+
+    size_t size() const { return d_id.size(); }
+    bool confirmed(size_t i) const { return d_hits[i] >= d_num_confirm; }
+    uint64_t id(size_t i) const { return d_id[i]; }
+    double range(size_t i) const { return d_range[i]; }
+    double velocity(size_t i) const { return d_velocity[i]; }
+
+private:
+    double d_range_gate;
+    double d_velocity_gate;
+    double d_alpha;
+    double d_beta;
+    uint32_t d_num_confirm;
+    uint32_t d_max_misses;
+    uint64_t d_next_id;
+
+    // Track state
+    std::vector<uint64_t> d_id;
+    std::vector<double> d_range;
+    std::vector<double> d_velocity;
+    std::vector<uint32_t> d_hits;
+    std::vector<uint32_t> d_misses;
+
+    // Scratch space, kept between updates to avoid reallocating
+    struct Candidate {
+        double distance;
+        uint32_t track;
+        uint32_t detection;
+    };
+    std::vector<uint32_t> d_order;
+    std::vector<double> d_sorted_range;
+    std::vector<Candidate> d_candidates;
+    std::vector<int32_t> d_assignment;
+    std::vector<uint8_t> d_detection_used;
+
+    void associate(const double* range, const double* velocity, size_t n);
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_ALPHA_BETA_TRACKER_H */
@@ -0,0 +1,153 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "beamformer_impl.h"
+#include "latency_trace.h"
+#include <gnuradio/io_signature.h>
+#include <cmath>
+
+namespace gr {
+namespace plasma {
+
+beamformer::sptr beamformer::make(size_t num_channels,
+                                  double element_spacing,
+                                  const std::vector<double>& steering_angles)
+{
+    return gnuradio::make_block_sptr<beamformer_impl>(
+        num_channels, element_spacing, steering_angles);
+}
+
+
+/*
+ * The private constructor
+ */
+beamformer_impl::beamformer_impl(size_t num_channels,
+                                 double element_spacing,
+                                 const std::vector<double>& steering_angles)
+    : gr::block("beamformer",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_latency_tracing(false),
+      d_num_channels(num_channels),
+      d_element_spacing(element_spacing),
+      d_steering_angles(steering_angles),
+      d_weights_changed(true),
+      d_in_port(PMT_IN),
+      d_out_port(PMT_OUT)
+{
+    d_data = pmt::make_c32vector(0, 0);
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+beamformer_impl::~beamformer_impl() {}
+
+void beamformer_impl::handle_msg(pmt::pmt_t msg)
+{
+    uint64_t entry_ns = latency_now_ns();
+    if (not pmt::is_pdu(msg) or not pmt::is_c32vector(pmt::cdr(msg))) {
+        GR_LOG_WARN(d_logger, "Input must be a PDU of complex samples")
+        return;
+    }
+    RadarMeta meta = RadarMeta::parse(pmt::car(msg));
+    pmt::pmt_t num_channels = meta.ref(PMT_NUM_CHANNELS, pmt::PMT_NIL);
+    update_weights(d_device.bind(),
+                   pmt::is_integer(num_channels) ? pmt::to_long(num_channels) : 0);
+    if (d_weights.elements() == 0) {
+        GR_LOG_WARN(d_logger, "No beams to form")
+        return;
+    }
+
+    pmt::pmt_t samples = pmt::cdr(msg);
+    size_t n = pmt::length(samples);
+    size_t nchan = d_weights.dims(0);
+    size_t nbeam = d_weights.dims(1);
+    if (n % nchan != 0) {
+        GR_LOG_WARN(d_logger, "CPI size is not a multiple of the number of channels")
+        return;
+    }
+
+    // Every sample of every pulse is a row of an (n / nchan) x nchan matrix, so all of
+    // the beams are formed by one matrix multiply
+    size_t nrow = n / nchan;
+    if (pmt::length(d_data) != nrow * nbeam)
+        d_data = pmt::make_c32vector(nrow * nbeam, 0);
+    size_t io(0);
+    const gr_complex* in = pmt::c32vector_elements(samples, io);
+    af::array x(af::dim4(nrow, nchan), reinterpret_cast<const af::cfloat*>(in));
+    af::array beams = af::matmul(x, d_weights);
+    beams.host(pmt::c32vector_writable_elements(d_data, io));
+
+    meta.add(PMT_NUM_BEAMS, pmt::from_long(nbeam));
+    pmt::pmt_t out_meta = meta.pack();
+    if (d_latency_tracing)
+        out_meta = latency_stamp(out_meta, alias(), entry_ns, latency_now_ns());
+    message_port_pub(d_out_port, pmt::cons(out_meta, d_data));
+}
+
+void beamformer_impl::update_weights(bool rebuild, size_t num_channels)
+{
+    // The weights must be created under this block's backend, so they are built here
+    // rather than in the setters
+    gr::thread::scoped_lock lock(d_mutex);
+    if (num_channels > 0 and num_channels != d_num_channels) {
+        d_num_channels = num_channels;
+        d_weights_changed = true;
+    }
+    if (not d_weights_changed and not rebuild)
+        return;
+    d_weights_changed = false;
+    d_weights = af::array();
+    size_t nchan = d_num_channels;
+    size_t nbeam = d_steering_angles.size();
+    if (nchan == 0 or nbeam == 0)
+        return;
+
+    // Element n of a beam steered to angle theta is weighted by
+    // exp(-j 2 pi d n sin(theta)) / N, which cancels the phase of a plane wave
+    // arriving from theta
+    std::vector<gr_complex> weights(nchan * nbeam);
+    for (size_t b = 0; b < nbeam; b++) {
+        double sin_theta = std::sin(d_steering_angles[b] * M_PI / 180);
+        for (size_t i = 0; i < nchan; i++) {
+            double phase = -2 * M_PI * d_element_spacing * i * sin_theta;
+            weights[b * nchan + i] = std::polar<float>(1.0 / nchan, phase);
+        }
+    }
+    d_weights =
+        af::array(af::dim4(nchan, nbeam), reinterpret_cast<af::cfloat*>(weights.data()));
+}
+
+void beamformer_impl::set_steering_angles(const std::vector<double>& steering_angles)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_steering_angles = steering_angles;
+    d_weights_changed = true;
+}
+
+void beamformer_impl::set_element_spacing(double element_spacing)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_element_spacing = element_spacing;
+    d_weights_changed = true;
+}
+
+void beamformer_impl::set_backend(Device::Backend backend)
+{
+    d_device.set_backend(backend);
+}
+
+void beamformer_impl::set_device_id(int device_id) { d_device.set_device_id(device_id); }
+
+void beamformer_impl::set_latency_tracing(bool enable) { d_latency_tracing = enable; }
+
+} /* namespace plasma */
+} /* namespace gr */
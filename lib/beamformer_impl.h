@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_BEAMFORMER_IMPL_H
+#define INCLUDED_PLASMA_BEAMFORMER_IMPL_H
+
+#include "radar_meta.h"
+#include <gnuradio/plasma/beamformer.h>
+#include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/thread/thread.h>
+#include <arrayfire.h>
+
+namespace gr {
+namespace plasma {
+
+class beamformer_impl : public beamformer
+{
+private:
+    bool d_latency_tracing;
+
+    // Array geometry and steering as set by the user (protected by d_mutex), and the
+    // (channels x beams) weight matrix on the device
+    size_t d_num_channels;
+    double d_element_spacing;
+    std::vector<double> d_steering_angles;
+    bool d_weights_changed;
+    gr::thread::mutex d_mutex;
+    af::array d_weights;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+    pmt::pmt_t d_data;
+    Device d_device;
+
+    void handle_msg(pmt::pmt_t msg);
+
+    /**
+     * @brief Rebuild the device weights if the steering has changed
+     *
+     * @param rebuild Rebuild even if nothing has changed (e.g., for a new backend)
+     * @param num_channels Number of channels in the input, or 0 to keep the current
+     * number
+     */
+    void update_weights(bool rebuild, size_t num_channels);
+
+    // The benchmarks in bench/ call the message handlers directly
+    friend class BlockBenchmark;
+
+public:
+    beamformer_impl(size_t num_channels,
+                    double element_spacing,
+                    const std::vector<double>& steering_angles);
+    ~beamformer_impl();
+
+    void set_steering_angles(const std::vector<double>& steering_angles) override;
+    void set_element_spacing(double element_spacing) override;
+    void set_backend(Device::Backend) override;
+    void set_device_id(int device_id) override;
+    void set_latency_tracing(bool enable) override;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_BEAMFORMER_IMPL_H */
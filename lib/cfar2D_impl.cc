@@ -7,11 +7,54 @@
 
 #include "arrayfire.h"
 #include "cfar2D_impl.h"
+#include "latency_trace.h"
+#include "radar_meta.h"
 #include <gnuradio/io_signature.h>
+#include <cmath>
 
 namespace gr {
 namespace plasma {
 
+namespace {
+/**
+ * @brief Single-CPI false alarm probability for a cell averaging detector whose
+ * threshold gives the false alarm probability pfa after num_integrated CPIs are
+ * summed
+ *
+ * With N training cells and K integrated CPIs, the noise power in each cell is gamma
+ * distributed and a threshold factor a gives (Richards, Fundamentals of Radar Signal
+ * Processing)
+ *
+ *   Pfa = sum_{k=0}^{K-1} C(NK + k - 1, k) (a/N)^k / (1 + a/N)^(NK + k)
+ *
+ * This is solved for a by bisection, then mapped back through the single-CPI relation
+ * Pfa = (1 + a/N)^-N so the detector can be built with its usual parameters.
+ */
+double integrated_pfa(double pfa, double num_train, size_t num_integrated)
+{
+    if (num_integrated <= 1 or num_train <= 0)
+        return pfa;
+    double m = num_train * num_integrated;
+    auto false_alarm = [&](double t) {
+        double sum = 0;
+        for (size_t k = 0; k < num_integrated; k++)
+            sum += std::exp(std::lgamma(m + k) - std::lgamma(k + 1.0) - std::lgamma(m) +
+                            k * std::log(t) - (m + k) * std::log1p(t));
+        return sum;
+    };
+    // The false alarm rate decreases with t = a/N, so bisect on log(t)
+    double lo = std::log(1e-12), hi = std::log(1e6);
+    for (int i = 0; i < 100; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (false_alarm(std::exp(mid)) > pfa)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return std::exp(-num_train * std::log1p(std::exp(0.5 * (lo + hi))));
+}
+} // namespace
+
 
 cfar2D::sptr cfar2D::make(std::vector<int>& guard_win_size,
                           std::vector<int>& train_win_size,
@@ -34,13 +77,16 @@ cfar2D_impl::cfar2D_impl(std::vector<int>& guard_win_size,
           "cfar2D", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
       d_in_port(PMT_IN),
       d_out_port(PMT_OUT),
-      d_num_pulse_cpi(num_pulse_cpi)
+      d_num_integrated(1),
+      d_num_pulse_cpi(num_pulse_cpi),
+      d_num_beams(1),
+      d_latency_tracing(false)
 {
     // Set up the CFAR detector objects
     std::copy(guard_win_size.begin(), guard_win_size.end(), d_guard_win_size.begin());
     std::copy(train_win_size.begin(), train_win_size.end(), d_train_win_size.begin());
     d_pfa = pfa;
-    detector = ::plasma::CFARDetector2D(d_guard_win_size, d_train_win_size, d_pfa);
+    update_detector();
 
     // Message handling
     message_port_register_out(d_out_port);
@@ -54,21 +100,33 @@ cfar2D_impl::cfar2D_impl(std::vector<int>& guard_win_size,
  */
 cfar2D_impl::~cfar2D_impl() {}
 
-void cfar2D_impl::handle_message(const pmt::pmt_t& msg)
+void cfar2D_impl::handle_message(pmt::pmt_t msg)
 {
-    if (this->nmsgs(d_in_port) > d_msg_queue_depth)
+    uint64_t entry_ns = latency_now_ns();
+    if (not d_admission.admit(this, d_in_port, msg))
         return;
+    // The detector's arrays must be created under this block's backend
+    if (d_device.bind())
+        update_detector();
     // Parse the input message
     pmt::pmt_t samples;
-    pmt::pmt_t meta = pmt::make_dict();
+    RadarMeta meta;
     if (pmt::is_pdu(msg)) {
         samples = pmt::cdr(msg);
-        meta = pmt::dict_update(meta, pmt::car(msg));
+        meta = RadarMeta::parse(pmt::car(msg));
 
         // Update number of pulses per CPI if it changed
-        if (pmt::dict_has_key(meta, d_n_pulse_cpi_key)) {
-            d_num_pulse_cpi =
-                pmt::to_long(pmt::dict_ref(meta, d_n_pulse_cpi_key, pmt::PMT_NIL));
+        pmt::pmt_t n_pulse_cpi = meta.ref(d_n_pulse_cpi_key, pmt::PMT_NIL);
+        if (not pmt::is_null(n_pulse_cpi))
+            d_num_pulse_cpi = pmt::to_long(n_pulse_cpi);
+        d_num_beams = pmt::to_long(meta.ref(PMT_NUM_BEAMS, pmt::from_long(d_num_beams)));
+
+        // Keep the false alarm rate when the number of integrated CPIs changes
+        size_t num_integrated =
+            pmt::to_long(meta.ref(PMT_NUM_INTEGRATED, pmt::from_long(1)));
+        if (num_integrated != d_num_integrated) {
+            d_num_integrated = num_integrated;
+            update_detector();
         }
 
     } else if (pmt::is_uniform_vector(msg)) {
@@ -81,28 +139,57 @@ void cfar2D_impl::handle_message(const pmt::pmt_t& msg)
     // Convert the input data to a 2D range-doppler map
     size_t n = pmt::length(samples);
     size_t io(0);
-    int ncol = d_num_pulse_cpi;
+    int ncol = d_num_pulse_cpi * d_num_beams;
     int nrow = n / ncol;
-    const gr_complex* in = pmt::c32vector_elements(samples, io);
-    af::array rdm(af::dim4(nrow, ncol), reinterpret_cast<const af::cfloat*>(in));
-
-    // Run the CFAR detector on the magnitude squared of the input data
-    rdm = af::pow(af::abs(rdm), 2);
-    DetectionReport results = detector.detect(rdm);
+    af::array rdm;
+    if (pmt::is_f32vector(samples)) {
+        // Power from noncoherent_integrator
+        const float* in = pmt::f32vector_elements(samples, io);
+        rdm = af::array(af::dim4(nrow, ncol), in);
+    } else {
+        // Run the CFAR detector on the magnitude squared of the input data
+        const gr_complex* in = pmt::c32vector_elements(samples, io);
+        rdm = af::array(af::dim4(nrow, ncol), reinterpret_cast<const af::cfloat*>(in));
+        rdm = af::pow(af::abs(rdm), 2);
+    }
 
-    // Convert the resulting array of linear indices to a PMT object
-    int* ind_ptr = results.indices.as(s32).host<int>();
-    pmt::pmt_t indices = pmt::init_s32vector(
-        results.indices.elements(),
-        std::vector<int>(ind_ptr, ind_ptr + results.indices.elements()));
-    delete ind_ptr;
+    // Each beam's map is searched separately so that the training windows never mix
+    // cells from neighboring beams. The indices are into the full (stacked) map.
+    std::vector<int> indices;
+    size_t num_detections = 0;
+    for (size_t beam = 0; beam < d_num_beams; beam++) {
+        int first_col = beam * d_num_pulse_cpi;
+        DetectionReport results =
+            detector.detect(rdm.cols(first_col, first_col + d_num_pulse_cpi - 1));
+        int* ind_ptr = results.indices.as(s32).host<int>();
+        for (dim_t i = 0; i < results.indices.elements(); i++)
+            indices.push_back(ind_ptr[i] + first_col * nrow);
+        af::freeHost(ind_ptr);
+        num_detections += results.num_detections;
+    }
 
     // Add detection metadata (directly passing the input data)
-    meta = pmt::dict_add(meta, d_detection_indices_key, indices);
-    meta =
-        pmt::dict_add(meta, d_n_detections_key, pmt::from_long(results.num_detections));
+    meta.add(d_detection_indices_key, pmt::init_s32vector(indices.size(), indices));
+    meta.add(d_n_detections_key, pmt::from_long(num_detections));
+    pmt::pmt_t out_meta = meta.pack();
+    if (d_latency_tracing)
+        out_meta = latency_stamp(out_meta, alias(), entry_ns, latency_now_ns());
+
+    message_port_pub(d_out_port, pmt::cons(out_meta, samples));
+}
 
-    message_port_pub(d_out_port, pmt::cons(meta, samples));
+void cfar2D_impl::update_detector()
+{
+    // Training cells in the window around the cell under test, with the window sizes
+    // measured on each side of it
+    double num_train =
+        (2.0 * (d_guard_win_size[0] + d_train_win_size[0]) + 1) *
+            (2.0 * (d_guard_win_size[1] + d_train_win_size[1]) + 1) -
+        (2.0 * d_guard_win_size[0] + 1) * (2.0 * d_guard_win_size[1] + 1);
+    detector = ::plasma::CFARDetector2D(
+        d_guard_win_size,
+        d_train_win_size,
+        integrated_pfa(d_pfa, num_train, d_num_integrated));
 }
 
 void cfar2D_impl::set_metadata_keys(std::string detction_indices_key,
@@ -114,27 +201,32 @@ void cfar2D_impl::set_metadata_keys(std::string detction_indices_key,
     d_n_pulse_cpi_key = pmt::intern(n_pulse_cpi_key);
 }
 
-void cfar2D_impl::set_msg_queue_depth(size_t depth) { d_msg_queue_depth = depth; }
+void cfar2D_impl::set_msg_queue_depth(size_t depth)
+{
+    d_admission.set_queue_depth(depth);
+}
+
+void cfar2D_impl::set_admission_policy(AdmissionControl::Policy policy, double max_rate)
+{
+    d_admission.set_policy(policy);
+    d_admission.set_max_rate(max_rate);
+}
+
+uint64_t cfar2D_impl::num_dropped() { return d_admission.num_dropped(); }
 
 void cfar2D_impl::set_backend(Device::Backend backend)
 {
-    switch (backend) {
-    case Device::CPU:
-        d_backend = AF_BACKEND_CPU;
-        break;
-    case Device::CUDA:
-        d_backend = AF_BACKEND_CUDA;
-        break;
-    case Device::OPENCL:
-        d_backend = AF_BACKEND_OPENCL;
-        break;
-    default:
-        d_backend = AF_BACKEND_DEFAULT;
-        break;
-    }
-    af::setBackend(d_backend);
+    d_device.set_backend(backend);
+}
+
+void cfar2D_impl::set_device_id(int device_id) { d_device.set_device_id(device_id); }
+
+void cfar2D_impl::set_cpu_affinity(const std::vector<int>& cores)
+{
+    d_device.set_cpu_affinity(cores);
 }
 
+void cfar2D_impl::set_latency_tracing(bool enable) { d_latency_tracing = enable; }
 
 } /* namespace plasma */
 } /* namespace gr */
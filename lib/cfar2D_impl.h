@@ -27,17 +27,28 @@ private:
     const pmt::pmt_t d_in_port;
     const pmt::pmt_t d_out_port;
 
-    af::Backend d_backend;
+    Device d_device;
 
     // Parameters for CFAR Object
     std::array<size_t, 2> d_guard_win_size;
     std::array<size_t, 2> d_train_win_size;
     double d_pfa;
+    // Number of CPIs noncoherently integrated into the input, which the detector's
+    // false alarm rate is adjusted for
+    size_t d_num_integrated;
     size_t d_num_pulse_cpi;
-    size_t d_msg_queue_depth;
+    // Beams stacked in each map, which are placed side by side along doppler and
+    // searched one at a time
+    size_t d_num_beams;
+    bool d_latency_tracing;
+    AdmissionControl d_admission;
     ::plasma::CFARDetector2D detector;
 
-    void handle_message(const pmt::pmt_t& msg);
+    void handle_message(pmt::pmt_t msg);
+    void update_detector();
+
+    // The benchmarks in bench/ call the message handlers directly
+    friend class BlockBenchmark;
 
 public:
     cfar2D_impl(std::vector<int>& guard_win_size,
@@ -47,7 +58,13 @@ public:
     ~cfar2D_impl();
 
     void set_msg_queue_depth(size_t) override;
+    void set_admission_policy(AdmissionControl::Policy policy,
+                              double max_rate) override;
+    uint64_t num_dropped() override;
     void set_backend(Device::Backend) override;
+    void set_device_id(int device_id) override;
+    void set_cpu_affinity(const std::vector<int>& cores) override;
+    void set_latency_tracing(bool enable) override;
 
     void set_metadata_keys(std::string detction_indices_key,
                            std::string n_detections_key,
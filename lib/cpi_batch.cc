@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "cpi_batch.h"
+#include <algorithm>
+
+namespace gr {
+namespace plasma {
+
+CpiBatch::CpiBatch() : d_max_size(1), d_nrow(0), d_ncol(0) {}
+
+void CpiBatch::set_max_size(size_t max_size)
+{
+    d_max_size = std::max<size_t>(max_size, 1);
+}
+
+size_t CpiBatch::max_size() const { return d_max_size; }
+
+size_t CpiBatch::target_size(size_t nqueued) const
+{
+    return std::min(d_max_size, nqueued + 1);
+}
+
+std::vector<pmt::pmt_t> CpiBatch::drain(gr::basic_block* block,
+                                        const pmt::pmt_t& port,
+                                        AdmissionControl& admission,
+                                        const pmt::pmt_t& msg) const
+{
+    std::vector<pmt::pmt_t> msgs{ msg };
+    size_t target = target_size(block->nmsgs(port));
+    for (size_t i = 1; i < target; i++) {
+        pmt::pmt_t next = block->delete_head_nowait(port);
+        if (not next)
+            break;
+        if (admission.admit(block, port, next))
+            msgs.push_back(next);
+    }
+    return msgs;
+}
+
+bool CpiBatch::push(const pmt::pmt_t& meta, const pmt::pmt_t& samples, size_t ncol)
+{
+    size_t nrow = pmt::length(samples) / ncol;
+    if (not empty() and (nrow != d_nrow or ncol != d_ncol))
+        return false;
+    d_nrow = nrow;
+    d_ncol = ncol;
+    d_meta.push_back(meta);
+    d_samples.push_back(samples);
+    return true;
+}
+
+af::array CpiBatch::cube()
+{
+    // Pack the CPIs contiguously on the host so the batch is a single transfer
+    size_t n = d_nrow * d_ncol;
+    d_in_buf.resize(n * size());
+    for (size_t i = 0; i < size(); i++) {
+        size_t io(0);
+        const gr_complex* in = pmt::c32vector_elements(d_samples[i], io);
+        std::copy(in, in + n, d_in_buf.begin() + i * n);
+    }
+    return af::array(af::dim4(d_nrow, d_ncol, size()),
+                     reinterpret_cast<const af::cfloat*>(d_in_buf.data()));
+}
+
+std::vector<pmt::pmt_t> CpiBatch::split(const af::array& out)
+{
+    size_t n = out.elements() / size();
+    d_out_buf.resize(out.elements());
+    out.host(d_out_buf.data());
+
+    std::vector<pmt::pmt_t> data;
+    data.reserve(size());
+    for (size_t i = 0; i < size(); i++)
+        data.push_back(pmt::init_c32vector(n, d_out_buf.data() + i * n));
+    return data;
+}
+
+void CpiBatch::clear()
+{
+    d_meta.clear();
+    d_samples.clear();
+}
+
+bool CpiBatch::empty() const { return d_samples.empty(); }
+
+size_t CpiBatch::size() const { return d_samples.size(); }
+
+size_t CpiBatch::nrow() const { return d_nrow; }
+
+size_t CpiBatch::ncol() const { return d_ncol; }
+
+const pmt::pmt_t& CpiBatch::meta(size_t i) const { return d_meta[i]; }
+
+} /* namespace plasma */
+} /* namespace gr */
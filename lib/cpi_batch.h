@@ -0,0 +1,107 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_CPI_BATCH_H
+#define INCLUDED_PLASMA_CPI_BATCH_H
+
+#include <gnuradio/basic_block.h>
+#include <gnuradio/plasma/admission_control.h>
+#include <gnuradio/types.h>
+#include <arrayfire.h>
+#include <pmt/pmt.h>
+#include <vector>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief Collects CPIs with identical dimensions so they can be processed as a single
+ * batched ArrayFire operation.
+ *
+ * The batch size adapts to the backlog: a block that is keeping up processes one CPI
+ * per call (no added latency), while a block that is falling behind drains up to
+ * max_size() queued CPIs at once.
+ */
+class CpiBatch
+{
+public:
+    CpiBatch();
+
+    /**
+     * @brief Set the maximum number of CPIs per batch. A value of 1 disables batching.
+     */
+    void set_max_size(size_t max_size);
+    size_t max_size() const;
+
+    /**
+     * @brief Number of CPIs to gather given the number of messages still queued
+     */
+    size_t target_size(size_t nqueued) const;
+
+    /**
+     * @brief Take the CPIs to batch with msg off a block's queue
+     *
+     * Up to target_size() - 1 messages are taken from the queue. They never reach the
+     * scheduler, so each one goes through the block's admission control here instead,
+     * and the ones it discards are left out.
+     *
+     * @param block Block that owns the port
+     * @param port Input message port
+     * @param admission Admission control of the port
+     * @param msg Message delivered to the handler (already admitted)
+     * @return msg followed by the admitted messages, in the order they arrived
+     */
+    std::vector<pmt::pmt_t> drain(gr::basic_block* block,
+                                  const pmt::pmt_t& port,
+                                  AdmissionControl& admission,
+                                  const pmt::pmt_t& msg) const;
+
+    /**
+     * @brief Add a CPI to the batch
+     *
+     * @param meta Metadata dictionary for the CPI
+     * @param samples c32vector containing ncol pulses of equal length
+     * @param ncol Number of pulses in the CPI
+     * @return false if the CPI's dimensions differ from those already in the batch, in
+     * which case nothing is added
+     */
+    bool push(const pmt::pmt_t& meta, const pmt::pmt_t& samples, size_t ncol);
+
+    /**
+     * @brief Copy the batch to the device as a single (nrow, ncol, size()) array
+     */
+    af::array cube();
+
+    /**
+     * @brief Split a processed batch into one c32vector per CPI
+     *
+     * @param out Array whose elements are stored CPI by CPI along the last dimension
+     */
+    std::vector<pmt::pmt_t> split(const af::array& out);
+
+    void clear();
+    bool empty() const;
+    size_t size() const;
+    size_t nrow() const;
+    size_t ncol() const;
+    const pmt::pmt_t& meta(size_t i) const;
+
+private:
+    size_t d_max_size;
+    size_t d_nrow;
+    size_t d_ncol;
+    std::vector<pmt::pmt_t> d_meta;
+    std::vector<pmt::pmt_t> d_samples;
+    // Host staging buffers, reused between batches
+    std::vector<gr_complex> d_in_buf;
+    std::vector<gr_complex> d_out_buf;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_CPI_BATCH_H */
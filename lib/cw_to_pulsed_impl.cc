@@ -7,6 +7,8 @@
 
 #include "cw_to_pulsed_impl.h"
 #include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <numeric>
 
 namespace gr {
 namespace plasma {
@@ -27,6 +29,8 @@ cw_to_pulsed_impl::cw_to_pulsed_impl(double prf, double samp_rate)
       prf(prf),
       sample_rate(samp_rate),
       last_data(pmt::PMT_NIL),
+      pulsed_data(pmt::PMT_NIL),
+      pulse_offsets(pmt::PMT_NIL),
       in_port(PMT_IN),
       out_port(PMT_OUT)
 
@@ -53,10 +57,12 @@ void cw_to_pulsed_impl::handle_msg(pmt::pmt_t msg)
         GR_LOG_ERROR(d_logger, "Unexpected message type")
     }
 
-    // Update with new data
-    if (samples != pmt::PMT_NIL) {
+    // Update with new data. Sources that cache their waveforms resend the same PMT, which
+    // doesn't count as a change.
+    if (samples != pmt::PMT_NIL and samples != last_data) {
         // Data vector updated
         last_data = samples;
+        pulsed_data = pmt::PMT_NIL;
     }
 
     size_t n_nonzero = pmt::length(last_data);
@@ -71,14 +77,44 @@ void cw_to_pulsed_impl::handle_msg(pmt::pmt_t msg)
 
     // Send new message (if data is available)
     if (last_data != pmt::PMT_NIL) {
-        size_t n_pri = round(sample_rate / prf);
-        std::vector<gr_complex> data(n_pri, 0);
-        std::copy(pmt::c32vector_elements(last_data, n_nonzero),
-                  pmt::c32vector_elements(last_data, n_nonzero) + n_nonzero,
-                  data.begin());
-        pmt::pmt_t pdu_data = pmt::init_c32vector(n_pri, data.data());
-
-        message_port_pub(out_port, pmt::cons(meta, pdu_data));
+        // Samples in each PRI of the pulse train
+        std::vector<size_t> pri;
+        {
+            gr::thread::scoped_lock lock(stagger_mutex);
+            for (double p : prf_stagger)
+                pri.push_back(round(sample_rate / p));
+        }
+        if (pri.empty())
+            pri.push_back(round(sample_rate / prf));
+        if (n_nonzero > *std::min_element(pri.begin(), pri.end())) {
+            GR_LOG_WARN(d_logger, "Waveform is longer than the PRI")
+            return;
+        }
+        // Metadata-only updates reuse the padded buffer from the previous message
+        bool layout_changed = pri != pulsed_pri;
+        if (pulsed_data == pmt::PMT_NIL or layout_changed) {
+            size_t total = std::accumulate(pri.begin(), pri.end(), size_t(0));
+            std::vector<uint64_t> offsets(pri.size(), 0);
+            std::partial_sum(pri.begin(), pri.end() - 1, offsets.begin() + 1);
+
+            size_t io(0);
+            pulsed_data = pmt::make_c32vector(total, 0);
+            const gr_complex* in = pmt::c32vector_elements(last_data, io);
+            gr_complex* out = pmt::c32vector_writable_elements(pulsed_data, io);
+            for (uint64_t offset : offsets)
+                std::copy(in, in + n_nonzero, out + offset);
+            pulsed_pri = pri;
+            pulse_offsets = pmt::init_u64vector(offsets.size(), offsets);
+        }
+        // Stagger groups always carry their pulse offsets. Single-PRI trains carry them
+        // whenever there is metadata, and whenever the PRIs change (e.g., when a stagger
+        // is turned off), so that downstream blocks stop splitting.
+        if ((pri.size() > 1 or layout_changed) and meta == pmt::PMT_NIL)
+            meta = pmt::make_dict();
+        if (meta != pmt::PMT_NIL)
+            meta = pmt::dict_add(meta, PMT_PULSE_OFFSETS, pulse_offsets);
+
+        message_port_pub(out_port, pmt::cons(meta, pulsed_data));
     }
 }
 
@@ -96,6 +132,19 @@ void cw_to_pulsed_impl::parse_input_meta(pmt::pmt_t meta)
     }
 }
 
+void cw_to_pulsed_impl::set_prf_stagger(const std::vector<double>& prfs)
+{
+    gr::thread::scoped_lock lock(stagger_mutex);
+    prf_stagger.clear();
+    for (double p : prfs) {
+        if (p <= 0) {
+            GR_LOG_WARN(d_logger, "Ignoring non-positive PRF in stagger list")
+            continue;
+        }
+        prf_stagger.push_back(p);
+    }
+}
+
 void cw_to_pulsed_impl::init_meta_dict(const std::string& sample_rate_key,
                                        const std::string& prf_key)
 {
@@ -10,6 +10,7 @@
 
 #include <gnuradio/plasma/cw_to_pulsed.h>
 #include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/thread/thread.h>
 
 namespace gr {
 namespace plasma {
@@ -21,6 +22,15 @@ private:
     double sample_rate;
 
     pmt::pmt_t last_data;
+    // PRFs of a staggered pulse train (empty if the PRF is fixed)
+    std::vector<double> prf_stagger;
+    gr::thread::mutex stagger_mutex;
+
+    // last_data zero-padded to each PRI, rebuilt only when the waveform, PRF(s) or
+    // sample rate changes, and the start sample of each pulse
+    pmt::pmt_t pulsed_data;
+    std::vector<size_t> pulsed_pri;
+    pmt::pmt_t pulse_offsets;
 
     // TODO: Make this key user-configurable
     pmt::pmt_t nonzero_key = pmt::string_to_symbol("n_nonzero");
@@ -37,6 +47,7 @@ public:
     void parse_input_meta(pmt::pmt_t meta);
 
     void init_meta_dict(const std::string& sample_rate_key, const std::string& prf_key);
+    void set_prf_stagger(const std::vector<double>& prfs) override;
 };
 
 } // namespace plasma
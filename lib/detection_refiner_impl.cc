@@ -0,0 +1,203 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "detection_refiner_impl.h"
+#include <gnuradio/io_signature.h>
+#include <plasma_dsp/constants.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace gr {
+namespace plasma {
+
+namespace {
+/**
+ * @brief Offset (in bins) of the vertex of the parabola through three equally spaced
+ * samples around a peak
+ *
+ * @param left Sample before the peak
+ * @param center Peak sample
+ * @param right Sample after the peak
+ * @param peak Value at the vertex
+ */
+double parabolic_peak(double left, double center, double right, double& peak)
+{
+    double curvature = left - 2 * center + right;
+    if (curvature >= 0) {
+        // Not a local maximum, so there's nothing to interpolate
+        peak = center;
+        return 0;
+    }
+    double delta = std::clamp(0.5 * (left - right) / curvature, -0.5, 0.5);
+    peak = center - 0.25 * (left - right) * delta;
+    return delta;
+}
+} // namespace
+
+detection_refiner::sptr detection_refiner::make(size_t num_cols)
+{
+    return gnuradio::make_block_sptr<detection_refiner_impl>(num_cols);
+}
+
+
+/*
+ * The private constructor
+ */
+detection_refiner_impl::detection_refiner_impl(size_t num_cols)
+    : gr::block("detection_refiner",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_num_cols(num_cols),
+      d_num_beams(1),
+      d_samp_rate(0),
+      d_prf(0),
+      d_pulse_width(0),
+      d_center_freq(0),
+      d_range_gated(false),
+      d_range_gate_start(0),
+      d_detection_indices_key(pmt::intern("detection_indices")),
+      d_doppler_fft_size_key(PMT_DOPPLER_FFT_SIZE),
+      d_in_port(PMT_IN),
+      d_out_port(PMT_OUT)
+{
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+detection_refiner_impl::~detection_refiner_impl() {}
+
+void detection_refiner_impl::handle_msg(pmt::pmt_t msg)
+{
+    if (not pmt::is_pdu(msg)) {
+        GR_LOG_WARN(d_logger, "Message must be a PDU")
+        return;
+    }
+    pmt::pmt_t samples = pmt::cdr(msg);
+    bool is_power = pmt::is_f32vector(samples);
+    if (not is_power and not pmt::is_c32vector(samples)) {
+        GR_LOG_WARN(d_logger, "Input must be a complex or power map")
+        return;
+    }
+    RadarMeta meta = RadarMeta::parse(pmt::car(msg));
+    update_params(meta);
+
+    pmt::pmt_t indices = meta.ref(d_detection_indices_key, pmt::PMT_NIL);
+    size_t n = pmt::length(samples);
+    size_t ncol = d_num_cols;
+    size_t nbeam = d_num_beams;
+    if (not pmt::is_s32vector(indices) or ncol * nbeam == 0 or n % (ncol * nbeam) != 0) {
+        message_port_pub(d_out_port, msg);
+        return;
+    }
+    // The maps of stacked beams are placed side by side along doppler
+    size_t nrow = n / (ncol * nbeam);
+
+    // Magnitude of a cell in a beam's map, read directly from the input
+    size_t io(0);
+    const float* power = is_power ? pmt::f32vector_elements(samples, io) : nullptr;
+    const gr_complex* data = is_power ? nullptr : pmt::c32vector_elements(samples, io);
+    size_t beam = 0;
+    auto magnitude = [&](size_t row, size_t col) -> double {
+        size_t i = (beam * ncol + col) * nrow + row;
+        return is_power ? std::sqrt(power[i]) : std::abs(data[i]);
+    };
+
+    const double c = ::plasma::physconst::c;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    size_t ndet = pmt::length(indices);
+    const int32_t* idx = pmt::s32vector_elements(indices, io);
+    std::vector<double> range(ndet, nan), doppler(ndet, nan), velocity(ndet, nan),
+        peak_power(ndet, 0);
+    std::vector<uint64_t> beams(ndet, 0);
+    for (size_t i = 0; i < ndet; i++) {
+        if (idx[i] < 0 or size_t(idx[i]) >= n)
+            continue;
+        size_t row = idx[i] % nrow;
+        size_t col = (idx[i] / nrow) % ncol;
+        beam = idx[i] / (nrow * ncol);
+        beams[i] = beam;
+        double center = magnitude(row, col);
+
+        // Range bins end at the edges of the map
+        double range_peak = center;
+        double range_offset = 0;
+        if (row > 0 and row + 1 < nrow)
+            range_offset = parabolic_peak(
+                magnitude(row - 1, col), center, magnitude(row + 1, col), range_peak);
+        // Doppler bins wrap around
+        double doppler_peak = center;
+        double doppler_offset = 0;
+        if (ncol > 2)
+            doppler_offset = parabolic_peak(magnitude(row, (col + ncol - 1) % ncol),
+                                            center,
+                                            magnitude(row, (col + 1) % ncol),
+                                            doppler_peak);
+        double peak = std::max(range_peak, doppler_peak);
+        peak_power[i] = peak * peak;
+
+        // Row 0 is at the range gate start, or one pulse width before zero range
+        if (d_samp_rate > 0) {
+            double delay = d_range_gated
+                               ? (d_range_gate_start + row + range_offset) / d_samp_rate
+                               : (row + range_offset) / d_samp_rate - d_pulse_width;
+            range[i] = (c / 2) * delay;
+        }
+        // The doppler axis is shifted so zero doppler is in column ncol / 2
+        if (d_prf > 0) {
+            double fd = (col + doppler_offset - double(ncol / 2)) * d_prf / ncol;
+            doppler[i] = fd;
+            if (d_center_freq > 0)
+                velocity[i] = (c / d_center_freq / 2) * fd;
+        }
+    }
+
+    meta.add(PMT_DETECTION_RANGE, pmt::init_f64vector(ndet, range));
+    meta.add(PMT_DETECTION_DOPPLER, pmt::init_f64vector(ndet, doppler));
+    if (d_center_freq > 0)
+        meta.add(PMT_DETECTION_VELOCITY, pmt::init_f64vector(ndet, velocity));
+    meta.add(PMT_DETECTION_POWER, pmt::init_f64vector(ndet, peak_power));
+    meta.add(PMT_DETECTION_BEAM, pmt::init_u64vector(ndet, beams));
+    message_port_pub(d_out_port, pmt::cons(meta.pack(), samples));
+}
+
+void detection_refiner_impl::update_params(const RadarMeta& meta)
+{
+    if (meta.has(RadarMeta::SAMPLE_RATE))
+        d_samp_rate = meta.get_double(RadarMeta::SAMPLE_RATE);
+    if (meta.has(RadarMeta::PRF))
+        d_prf = meta.get_double(RadarMeta::PRF);
+    if (meta.has(RadarMeta::DURATION))
+        d_pulse_width = meta.get_double(RadarMeta::DURATION);
+    if (meta.has(RadarMeta::FREQUENCY))
+        d_center_freq = meta.get_double(RadarMeta::FREQUENCY);
+    // Range gated blocks tag every CPI, so a map without the tag covers every range
+    d_range_gated = meta.has(RadarMeta::RANGE_GATE_START);
+    if (d_range_gated)
+        d_range_gate_start = meta.get_long(RadarMeta::RANGE_GATE_START);
+    pmt::pmt_t fft_size = meta.ref(d_doppler_fft_size_key, pmt::PMT_NIL);
+    if (pmt::is_integer(fft_size))
+        d_num_cols = pmt::to_long(fft_size);
+    pmt::pmt_t num_beams = meta.ref(PMT_NUM_BEAMS, pmt::PMT_NIL);
+    if (pmt::is_integer(num_beams))
+        d_num_beams = pmt::to_long(num_beams);
+}
+
+void detection_refiner_impl::set_metadata_keys(std::string detection_indices_key,
+                                               std::string doppler_fft_size_key)
+{
+    d_detection_indices_key = pmt::intern(detection_indices_key);
+    d_doppler_fft_size_key = pmt::intern(doppler_fft_size_key);
+}
+
+} /* namespace plasma */
+} /* namespace gr */
@@ -0,0 +1,52 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_DETECTION_REFINER_IMPL_H
+#define INCLUDED_PLASMA_DETECTION_REFINER_IMPL_H
+
+#include "radar_meta.h"
+#include <gnuradio/plasma/detection_refiner.h>
+#include <gnuradio/plasma/pmt_constants.h>
+
+namespace gr {
+namespace plasma {
+
+class detection_refiner_impl : public detection_refiner
+{
+private:
+    // Parameters of the latest map. Upstream blocks only send them when they change.
+    size_t d_num_cols;
+    size_t d_num_beams;
+    double d_samp_rate;
+    double d_prf;
+    double d_pulse_width;
+    double d_center_freq;
+    // Range gate of the latest map, which is sent with every gated map
+    bool d_range_gated;
+    int64_t d_range_gate_start;
+
+    pmt::pmt_t d_detection_indices_key;
+    pmt::pmt_t d_doppler_fft_size_key;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+
+    void handle_msg(pmt::pmt_t msg);
+    void update_params(const RadarMeta& meta);
+
+public:
+    detection_refiner_impl(size_t num_cols);
+    ~detection_refiner_impl();
+
+    void set_metadata_keys(std::string detection_indices_key,
+                           std::string doppler_fft_size_key) override;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_DETECTION_REFINER_IMPL_H */
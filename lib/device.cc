@@ -7,8 +7,113 @@
 
 #include <gnuradio/io_signature.h>
 #include <gnuradio/plasma/device.h>
+#include <gnuradio/thread/thread.h>
 
 namespace gr {
 namespace plasma {
+
+Device::Device() : Device(DEFAULT, 0) {}
+
+Device::Device(Backend backend, int device_id)
+    : d_backend(backend), d_device_id(device_id), d_changed(true)
+{
+}
+
+Device::Device(const Device& other)
+{
+    std::lock_guard<std::mutex> lock(other.d_mutex);
+    d_backend = other.d_backend;
+    d_device_id = other.d_device_id;
+    d_cpu_affinity = other.d_cpu_affinity;
+    d_changed = true;
+}
+
+Device& Device::operator=(const Device& other)
+{
+    if (this == &other)
+        return *this;
+    std::scoped_lock lock(d_mutex, other.d_mutex);
+    d_backend = other.d_backend;
+    d_device_id = other.d_device_id;
+    d_cpu_affinity = other.d_cpu_affinity;
+    d_changed = true;
+    return *this;
+}
+
+void Device::set_backend(Backend backend)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_backend = backend;
+    d_changed = true;
+}
+
+void Device::set_device_id(int device_id)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_device_id = device_id;
+    d_changed = true;
+}
+
+void Device::set_cpu_affinity(const std::vector<int>& cores)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_cpu_affinity = cores;
+    d_changed = true;
+}
+
+Device::Backend Device::backend() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_backend;
+}
+
+int Device::device_id() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_device_id;
+}
+
+std::vector<int> Device::cpu_affinity() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_cpu_affinity;
+}
+
+bool Device::bind()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    // The backend and device are thread-local in ArrayFire and cheap to set, so always
+    // set them in case another context was bound on this thread since the last call
+    af::setBackend(to_af_backend(d_backend));
+    if (af::getDevice() != d_device_id)
+        af::setDevice(d_device_id);
+
+    std::thread::id id = std::this_thread::get_id();
+    if (d_changed or id != d_bound_thread) {
+        // Threads created by ArrayFire (e.g., the CPU backend's queue) inherit the
+        // affinity of the thread that first uses them
+        if (not d_cpu_affinity.empty())
+            gr::thread::thread_bind_to_processor(d_cpu_affinity);
+        d_bound_thread = id;
+        d_changed = false;
+        return true;
+    }
+    return false;
+}
+
+af::Backend Device::to_af_backend(Backend backend)
+{
+    switch (backend) {
+    case CPU:
+        return AF_BACKEND_CPU;
+    case CUDA:
+        return AF_BACKEND_CUDA;
+    case OPENCL:
+        return AF_BACKEND_OPENCL;
+    default:
+        return AF_BACKEND_DEFAULT;
+    }
+}
+
 } /* namespace plasma */
 } /* namespace gr */
@@ -6,6 +6,7 @@
  */
 
 #include "doppler_processing_impl.h"
+#include "latency_trace.h"
 #include <gnuradio/io_signature.h>
 #include <arrayfire.h>
 #include <chrono>
@@ -27,11 +28,16 @@ doppler_processing_impl::doppler_processing_impl(size_t num_pulse_cpi, size_t nf
                 gr::io_signature::make(0, 0, 0),
                 gr::io_signature::make(0, 0, 0)),
       d_num_pulse_cpi(num_pulse_cpi),
-      d_fftsize(nfft)
+      d_num_beams(1),
+      d_batch_num_beams(1),
+      d_fftsize(nfft),
+      d_latency_tracing(false),
+      d_mti_fused(false),
+      d_mti_changed(false),
+      d_mti_warned(false)
 {
     d_in_port = PMT_IN;
     d_out_port = PMT_OUT;
-    d_meta = pmt::make_dict();
     d_data = pmt::make_c32vector(0, 0);
     message_port_register_in(d_in_port);
     message_port_register_out(d_out_port);
@@ -45,30 +51,22 @@ doppler_processing_impl::~doppler_processing_impl() {}
 
 void doppler_processing_impl::handle_msg(pmt::pmt_t msg)
 {
-    if (this->nmsgs(d_in_port) > d_queue_depth) {
+    uint64_t entry_ns = latency_now_ns();
+    update_mti(d_device.bind());
+    if (not d_admission.admit(this, d_in_port, msg)) {
+        return;
+    }
+    if (d_batch.max_size() > 1) {
+        handle_batch(msg, entry_ns);
         return;
     }
 
     // Read the input PDU
     pmt::pmt_t samples;
-    if (pmt::is_pdu(msg)) {
-        pmt::pmt_t meta = pmt::car(msg);
-        samples = pmt::cdr(msg);
-
-        // Update block parameters with new metadata
-        if (pmt::dict_has_key(meta, d_n_pulse_cpi_key)) {
-            d_num_pulse_cpi =
-                pmt::to_long(pmt::dict_ref(meta, d_n_pulse_cpi_key, pmt::PMT_NIL));
-        }
-        d_meta = pmt::dict_update(d_meta, meta);
-
-
-    } else if (pmt::is_uniform_vector(msg)) {
-        samples = msg;
-    } else {
-        GR_LOG_WARN(d_logger, "Invalid message type")
+    RadarMeta meta;
+    if (not parse_msg(msg, meta, samples))
         return;
-    }
+    d_meta.update(meta);
 
     // Get pointers to the input and output arrays
     size_t n = pmt::length(samples);
@@ -77,22 +75,169 @@ void doppler_processing_impl::handle_msg(pmt::pmt_t msg)
         d_data = pmt::make_c32vector(n * d_fftsize / d_num_pulse_cpi, 0);
     const gr_complex* in = pmt::c32vector_elements(samples, io);
     gr_complex* out = pmt::c32vector_writable_elements(d_data, io);
-    int nrow = n / d_num_pulse_cpi;
+    int nbeam = d_num_beams;
     int ncol = d_num_pulse_cpi;
+    int nrow = n / (ncol * nbeam);
 
-    // Take an FFT across each row of the matrix to form a range-doppler map
-    af::array rdm(af::dim4(nrow, ncol), reinterpret_cast<const af::cfloat*>(in));
+    // Take an FFT across each row of the matrix to form a range-doppler map (one per
+    // beam)
+    af::array rdm(af::dim4(nrow, ncol, nbeam), reinterpret_cast<const af::cfloat*>(in));
     // The FFT function transforms each column of the input matrix by default,
-    // so we need to transpose it to do the FFT across rows.
-    rdm = rdm.T();
+    // so we need to move slow time to the first dimension to do the FFT across rows.
+    rdm = af::reorder(rdm, 1, 0, 2);
+    rdm = apply_mti(rdm);
     rdm = af::fftNorm(rdm, 1.0, d_fftsize);
-    rdm = ::plasma::fftshift(rdm, 0);
-    rdm = rdm.T();
+    rdm = apply_mti_response(rdm);
+    rdm = af::shift(rdm, d_fftsize / 2);
+    rdm = af::reorder(rdm, 1, 0, 2);
     rdm.host(out);
     // Send the data as a message
-    message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
+    pmt::pmt_t out_meta = d_meta.pack();
+    if (d_latency_tracing)
+        out_meta = latency_stamp(out_meta, alias(), entry_ns, latency_now_ns());
+    message_port_pub(d_out_port, pmt::cons(out_meta, d_data));
     // Reset the metadata output
-    d_meta = pmt::make_dict();
+    d_meta.clear();
+}
+
+void doppler_processing_impl::handle_batch(pmt::pmt_t msg, uint64_t entry_ns)
+{
+    // Gather the CPIs that are already waiting in the queue, flushing early if the
+    // dimensions change
+    for (const pmt::pmt_t& next : d_batch.drain(this, d_in_port, d_admission, msg)) {
+        pmt::pmt_t samples;
+        RadarMeta parsed;
+        // The batch holds the metadata as received, and parses it again when the batch
+        // is processed
+        pmt::pmt_t meta = pmt::is_pdu(next) ? pmt::car(next) : pmt::PMT_NIL;
+        if (parse_msg(next, parsed, samples)) {
+            // The stacked beams of a CPI look like extra pulses to the batch, so a
+            // change in the number of beams also starts a new batch
+            size_t ncol = d_num_pulse_cpi * d_num_beams;
+            if ((not d_batch.empty() and d_num_beams != d_batch_num_beams) or
+                not d_batch.push(meta, samples, ncol)) {
+                process_batch(entry_ns);
+                d_batch.push(meta, samples, ncol);
+            }
+            d_batch_num_beams = d_num_beams;
+        }
+    }
+    process_batch(entry_ns);
+}
+
+void doppler_processing_impl::process_batch(uint64_t entry_ns)
+{
+    if (d_batch.empty())
+        return;
+
+    // Move slow time to the first dimension so that a single batched FFT covers every
+    // range bin of every beam of every CPI
+    size_t nbeam = d_batch_num_beams;
+    af::array rdm = af::moddims(d_batch.cube(),
+                                d_batch.nrow(),
+                                d_batch.ncol() / nbeam,
+                                nbeam * d_batch.size());
+    rdm = af::reorder(rdm, 1, 0, 2);
+    rdm = apply_mti(rdm);
+    rdm = af::fftNorm(rdm, 1.0, d_fftsize);
+    rdm = apply_mti_response(rdm);
+    rdm = af::shift(rdm, d_fftsize / 2);
+    rdm = af::reorder(rdm, 1, 0, 2);
+
+    std::vector<pmt::pmt_t> data = d_batch.split(rdm);
+    for (size_t i = 0; i < data.size(); i++) {
+        d_meta.update(RadarMeta::parse(d_batch.meta(i)));
+        pmt::pmt_t meta = d_meta.pack();
+        if (d_latency_tracing)
+            meta = latency_stamp(meta, alias(), entry_ns, latency_now_ns());
+        message_port_pub(d_out_port, pmt::cons(meta, data[i]));
+        d_meta.clear();
+    }
+    d_batch.clear();
+}
+
+bool doppler_processing_impl::parse_msg(const pmt::pmt_t& msg,
+                                        RadarMeta& meta,
+                                        pmt::pmt_t& samples)
+{
+    if (pmt::is_pdu(msg)) {
+        meta = RadarMeta::parse(pmt::car(msg));
+        samples = pmt::cdr(msg);
+
+        // Update block parameters with new metadata
+        pmt::pmt_t n_pulse_cpi = meta.ref(d_n_pulse_cpi_key, pmt::PMT_NIL);
+        if (not pmt::is_null(n_pulse_cpi))
+            d_num_pulse_cpi = pmt::to_long(n_pulse_cpi);
+        d_num_beams = pmt::to_long(meta.ref(PMT_NUM_BEAMS, pmt::from_long(d_num_beams)));
+    } else if (pmt::is_uniform_vector(msg)) {
+        meta = RadarMeta();
+        samples = msg;
+    } else {
+        GR_LOG_WARN(d_logger, "Invalid message type")
+        return false;
+    }
+    return true;
+}
+
+void doppler_processing_impl::update_mti(bool rebuild)
+{
+    // The device arrays must be created under this block's backend, so they are built
+    // here rather than in set_mti_filter()
+    gr::thread::scoped_lock lock(d_mti_mutex);
+    if (not d_mti_changed and not rebuild)
+        return;
+    d_mti_changed = false;
+    d_mti_warned = false;
+    d_mti_taps = af::array();
+    d_mti_spectrum = af::array();
+    d_mti_response = af::array();
+    if (d_mti_taps_host.empty())
+        return;
+    af::array taps(d_mti_taps_host.size(),
+                   reinterpret_cast<const af::cfloat*>(d_mti_taps_host.data()));
+    if (d_mti_fused)
+        d_mti_spectrum = af::fft(taps, d_fftsize);
+    else
+        d_mti_taps = taps;
+}
+
+af::array doppler_processing_impl::apply_mti(const af::array& x)
+{
+    // Slow time is along the first dimension, so a single batched convolution filters
+    // every range bin (and every CPI in a batch)
+    dim_t ntaps = d_mti_taps.elements();
+    if (ntaps == 0)
+        return x;
+    if (x.dims(0) < ntaps) {
+        if (not d_mti_warned)
+            GR_LOG_WARN(d_logger,
+                        "CPIs have fewer pulses than MTI filter taps, so the MTI filter "
+                        "is not applied")
+        d_mti_warned = true;
+        return x;
+    }
+    af::array y = af::convolve1(x, d_mti_taps, AF_CONV_EXPAND, AF_CONV_AUTO);
+    // Only keep the outputs where the filter overlaps the CPI completely
+    return y.rows(ntaps - 1, x.dims(0) - 1);
+}
+
+af::array doppler_processing_impl::apply_mti_response(const af::array& x)
+{
+    if (d_mti_spectrum.elements() == 0)
+        return x;
+    if (d_mti_response.dims(0) != x.dims(0) or d_mti_response.dims(1) != x.dims(1) or
+        d_mti_response.dims(2) != x.dims(2))
+        d_mti_response = af::tile(d_mti_spectrum, 1, x.dims(1), x.dims(2));
+    return x * d_mti_response;
+}
+
+void doppler_processing_impl::set_mti_filter(const std::vector<gr_complex>& taps,
+                                             bool fused)
+{
+    gr::thread::scoped_lock lock(d_mti_mutex);
+    d_mti_taps_host = taps;
+    d_mti_fused = fused;
+    d_mti_changed = true;
 }
 
 void doppler_processing_impl::set_metadata_keys(const std::string& n_pulse_cpi_key,
@@ -101,28 +246,46 @@ void doppler_processing_impl::set_metadata_keys(const std::string& n_pulse_cpi_k
     d_n_pulse_cpi_key = pmt::intern(n_pulse_cpi_key);
     d_doppler_fft_size_key = pmt::intern(doppler_fft_size_key);
 
-    d_meta = pmt::dict_add(d_meta, d_doppler_fft_size_key, pmt::from_long(d_fftsize));
+    d_meta.add(d_doppler_fft_size_key, pmt::from_long(d_fftsize));
 }
 
-void doppler_processing_impl::set_msg_queue_depth(size_t depth) { d_queue_depth = depth; }
+void doppler_processing_impl::set_msg_queue_depth(size_t depth)
+{
+    d_admission.set_queue_depth(depth);
+}
+
+void doppler_processing_impl::set_admission_policy(AdmissionControl::Policy policy, double max_rate)
+{
+    d_admission.set_policy(policy);
+    d_admission.set_max_rate(max_rate);
+}
+
+uint64_t doppler_processing_impl::num_dropped() { return d_admission.num_dropped(); }
+
+void doppler_processing_impl::set_batch_size(size_t batch_size)
+{
+    d_batch.set_max_size(batch_size);
+}
 
 void doppler_processing_impl::set_backend(Device::Backend backend)
 {
-    switch (backend) {
-    case Device::CPU:
-        d_backend = AF_BACKEND_CPU;
-        break;
-    case Device::CUDA:
-        d_backend = AF_BACKEND_CUDA;
-        break;
-    case Device::OPENCL:
-        d_backend = AF_BACKEND_OPENCL;
-        break;
-    default:
-        d_backend = AF_BACKEND_DEFAULT;
-        break;
-    }
-    af::setBackend(d_backend);
+    d_device.set_backend(backend);
+}
+
+void doppler_processing_impl::set_device_id(int device_id)
+{
+    d_device.set_device_id(device_id);
+}
+
+void doppler_processing_impl::set_cpu_affinity(const std::vector<int>& cores)
+{
+    d_device.set_cpu_affinity(cores);
 }
+
+void doppler_processing_impl::set_latency_tracing(bool enable)
+{
+    d_latency_tracing = enable;
+}
+
 } /* namespace plasma */
 } /* namespace gr */
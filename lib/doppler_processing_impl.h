@@ -8,9 +8,12 @@
 #ifndef INCLUDED_PLASMA_DOPPLER_PROCESSING_IMPL_H
 #define INCLUDED_PLASMA_DOPPLER_PROCESSING_IMPL_H
 
+#include "cpi_batch.h"
+#include "radar_meta.h"
 #include <gnuradio/plasma/device.h>
 #include <gnuradio/plasma/doppler_processing.h>
 #include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/thread/thread.h>
 #include <plasma_dsp/fft.h>
 
 namespace gr {
@@ -20,19 +23,48 @@ class doppler_processing_impl : public doppler_processing
 {
 private:
     size_t d_num_pulse_cpi;
+    // Beams stacked in each CPI (from a beamformer), and the number in the current
+    // batch
+    size_t d_num_beams;
+    size_t d_batch_num_beams;
     size_t d_fftsize;
-    size_t d_queue_depth;
+    bool d_latency_tracing;
+    AdmissionControl d_admission;
 
     void handle_msg(pmt::pmt_t msg);
+    void handle_batch(pmt::pmt_t msg, uint64_t entry_ns);
+    void process_batch(uint64_t entry_ns);
+    bool parse_msg(const pmt::pmt_t& msg, RadarMeta& meta, pmt::pmt_t& samples);
+    void update_mti(bool rebuild);
+    af::array apply_mti(const af::array& x);
+    af::array apply_mti_response(const af::array& x);
 
     pmt::pmt_t d_out_port;
     pmt::pmt_t d_in_port;
     pmt::pmt_t d_data;
-    pmt::pmt_t d_meta;
+    RadarMeta d_meta;
     pmt::pmt_t d_n_pulse_cpi_key;
     pmt::pmt_t d_doppler_fft_size_key;
 
-    af::Backend d_backend;
+    Device d_device;
+    CpiBatch d_batch;
+
+    // MTI filter taps as set by the user (protected by d_mti_mutex), and their device
+    // copies. d_mti_response holds the filter's Doppler response tiled to the size of
+    // the last map it was applied to.
+    std::vector<gr_complex> d_mti_taps_host;
+    bool d_mti_fused;
+    bool d_mti_changed;
+    // Set after warning that the CPIs are too short for the filter, so that the
+    // warning is logged once per filter
+    bool d_mti_warned;
+    gr::thread::mutex d_mti_mutex;
+    af::array d_mti_taps;
+    af::array d_mti_spectrum;
+    af::array d_mti_response;
+
+    // The benchmarks in bench/ call the message handlers directly
+    friend class BlockBenchmark;
 
 public:
     doppler_processing_impl(size_t num_pulse_cpi, size_t nfft);
@@ -41,7 +73,15 @@ public:
     void set_metadata_keys(const std::string& n_pulse_cpi_key,
                            const std::string& doppler_fft_size_key);
     void set_msg_queue_depth(size_t) override;
+    void set_admission_policy(AdmissionControl::Policy policy,
+                              double max_rate) override;
+    uint64_t num_dropped() override;
+    void set_batch_size(size_t batch_size) override;
     void set_backend(Device::Backend) override;
+    void set_device_id(int device_id) override;
+    void set_cpu_affinity(const std::vector<int>& cores) override;
+    void set_latency_tracing(bool enable) override;
+    void set_mti_filter(const std::vector<gr_complex>& taps, bool fused) override;
 };
 
 } // namespace plasma
@@ -0,0 +1,33 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "fractional_delay.h"
+#include <cmath>
+
+namespace gr {
+namespace plasma {
+
+af::array fractional_delay_filter(const af::array& taps, double frac_delay)
+{
+    if (frac_delay == 0 or taps.elements() == 0)
+        return taps;
+
+    dim_t ntaps = taps.dims(0) + 1;
+    dim_t nfft = 1;
+    while (nfft < 2 * ntaps)
+        nfft *= 2;
+    af::array freq = af::range(af::dim4(nfft), 0, f32);
+    freq -= nfft * (freq >= nfft / 2).as(f32);
+    af::array phase = -2 * M_PI * (1 - frac_delay) * freq / nfft;
+    af::array ramp =
+        af::tile(af::complex(af::cos(phase), af::sin(phase)), 1, taps.dims(1));
+    af::array spec = af::fft(taps, nfft) * ramp;
+    return af::ifft(spec).rows(0, ntaps - 1);
+}
+
+} // namespace plasma
+} // namespace gr
@@ -0,0 +1,35 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_FRACTIONAL_DELAY_H
+#define INCLUDED_PLASMA_FRACTIONAL_DELAY_H
+
+#include <arrayfire.h>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief Correct matched filter taps for a fractional receive delay
+ *
+ * The taps are delayed by (1 - frac_delay) samples with a linear phase ramp across the
+ * filter spectrum, and one tap is added to hold the shifted response. The compressed
+ * output is delayed by one sample for the extra tap, so overall it is advanced by
+ * frac_delay samples, which cancels the residual receive delay. Range bins are
+ * still computed from the number of taps, so they line up with the integer delays.
+ *
+ * @param taps Matched filter taps, with one column per waveform
+ * @param frac_delay Receive delay (in samples) left over after the integer delay
+ * correction, between 0 and 1
+ * @return af::array The corrected taps, or taps itself if there is nothing to correct
+ */
+af::array fractional_delay_filter(const af::array& taps, double frac_delay);
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_FRACTIONAL_DELAY_H */
@@ -0,0 +1,142 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "latency_sink_impl.h"
+#include "latency_trace.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace gr {
+namespace plasma {
+
+namespace {
+/**
+ * @brief Nearest-rank percentile of x (which is reordered)
+ */
+double percentile(std::vector<double>& x, double p)
+{
+    if (x.empty())
+        return 0;
+    size_t rank = std::ceil(p * x.size());
+    size_t i = std::clamp<size_t>(rank, 1, x.size()) - 1;
+    std::nth_element(x.begin(), x.begin() + i, x.end());
+    return x[i];
+}
+
+pmt::pmt_t summarize(std::vector<double>& x, std::ostringstream& ss)
+{
+    double p50 = percentile(x, 0.5);
+    double p99 = percentile(x, 0.99);
+    double max = x.empty() ? 0 : *std::max_element(x.begin(), x.end());
+    ss << p50 << "/" << p99 << "/" << max;
+
+    pmt::pmt_t stats = pmt::make_dict();
+    stats = pmt::dict_add(stats, pmt::intern("p50"), pmt::from_double(p50));
+    stats = pmt::dict_add(stats, pmt::intern("p99"), pmt::from_double(p99));
+    stats = pmt::dict_add(stats, pmt::intern("max"), pmt::from_double(max));
+    return stats;
+}
+} // namespace
+
+latency_sink::sptr latency_sink::make(size_t report_interval)
+{
+    return gnuradio::make_block_sptr<latency_sink_impl>(report_interval);
+}
+
+
+/*
+ * The private constructor
+ */
+latency_sink_impl::latency_sink_impl(size_t report_interval)
+    : gr::block("latency_sink",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_report_interval(std::max<size_t>(report_interval, 1)),
+      d_count(0)
+{
+    d_in_port = PMT_IN;
+    d_stats_port = pmt::intern("stats");
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_stats_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+latency_sink_impl::~latency_sink_impl() {}
+
+void latency_sink_impl::handle_msg(pmt::pmt_t msg)
+{
+    uint64_t now_ns = latency_now_ns();
+    // Accept PDUs or bare metadata dictionaries
+    pmt::pmt_t meta = pmt::is_pair(msg) ? pmt::car(msg) : msg;
+    std::vector<LatencyStamp> trace = latency_trace(meta);
+    if (trace.empty())
+        return;
+
+    gr::thread::scoped_lock lock(d_mutex);
+    uint64_t prev_exit_ns = trace.front().entry_ns;
+    for (const LatencyStamp& stamp : trace) {
+        if (d_stages.count(stamp.stage) == 0)
+            d_stage_order.push_back(stamp.stage);
+        StageLatency& stage = d_stages[stamp.stage];
+        stage.processing.push_back(1e-6 * (int64_t)(stamp.exit_ns - stamp.entry_ns));
+        stage.added.push_back(1e-6 * (int64_t)(stamp.exit_ns - prev_exit_ns));
+        prev_exit_ns = stamp.exit_ns;
+    }
+    d_end_to_end.push_back(1e-6 * (int64_t)(now_ns - trace.front().entry_ns));
+
+    if (++d_count >= d_report_interval)
+        report();
+}
+
+void latency_sink_impl::report()
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Latency over " << d_count << " messages (p50/p99/max ms)";
+
+    pmt::pmt_t stats = pmt::make_dict();
+    for (const std::string& name : d_stage_order) {
+        StageLatency& stage = d_stages[name];
+        pmt::pmt_t stage_stats = pmt::make_dict();
+        ss << "\n  " << name << ": added ";
+        stage_stats = pmt::dict_add(
+            stage_stats, pmt::intern("added"), summarize(stage.added, ss));
+        ss << ", processing ";
+        stage_stats = pmt::dict_add(
+            stage_stats, pmt::intern("processing"), summarize(stage.processing, ss));
+        stats = pmt::dict_add(stats, pmt::intern(name), stage_stats);
+    }
+    ss << "\n  end to end: ";
+    stats = pmt::dict_add(stats, pmt::intern("end_to_end"), summarize(d_end_to_end, ss));
+
+    GR_LOG_INFO(d_logger, ss.str());
+    message_port_pub(d_stats_port, stats);
+    clear();
+}
+
+void latency_sink_impl::reset()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    clear();
+}
+
+void latency_sink_impl::clear()
+{
+    d_count = 0;
+    d_stage_order.clear();
+    d_stages.clear();
+    d_end_to_end.clear();
+}
+
+} /* namespace plasma */
+} /* namespace gr */
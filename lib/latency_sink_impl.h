@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_LATENCY_SINK_IMPL_H
+#define INCLUDED_PLASMA_LATENCY_SINK_IMPL_H
+
+#include <gnuradio/plasma/latency_sink.h>
+#include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/thread/thread.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace plasma {
+
+class latency_sink_impl : public latency_sink
+{
+private:
+    struct StageLatency {
+        std::vector<double> processing;
+        std::vector<double> added;
+    };
+
+    size_t d_report_interval;
+    size_t d_count;
+    // Stages in the order they were first seen in a trace
+    std::vector<std::string> d_stage_order;
+    std::map<std::string, StageLatency> d_stages;
+    std::vector<double> d_end_to_end;
+    gr::thread::mutex d_mutex;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_stats_port;
+
+    void handle_msg(pmt::pmt_t msg);
+    void report();
+    void clear();
+
+public:
+    latency_sink_impl(size_t report_interval);
+    ~latency_sink_impl();
+
+    void reset() override;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_LATENCY_SINK_IMPL_H */
@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "latency_trace.h"
+#include <gnuradio/plasma/pmt_constants.h>
+#include <algorithm>
+#include <chrono>
+
+namespace gr {
+namespace plasma {
+
+uint64_t latency_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+pmt::pmt_t latency_stamp(pmt::pmt_t meta,
+                         const std::string& stage,
+                         uint64_t entry_ns,
+                         uint64_t exit_ns)
+{
+    if (not pmt::is_dict(meta))
+        meta = pmt::make_dict();
+    pmt::pmt_t trace = pmt::dict_ref(meta, PMT_LATENCY, pmt::PMT_NIL);
+    if (not pmt::is_dict(trace))
+        trace = pmt::make_dict();
+
+    const uint64_t times[2] = { entry_ns, exit_ns };
+    trace = pmt::dict_add(trace, pmt::intern(stage), pmt::init_u64vector(2, times));
+    return pmt::dict_add(meta, PMT_LATENCY, trace);
+}
+
+std::vector<LatencyStamp> latency_trace(const pmt::pmt_t& meta)
+{
+    std::vector<LatencyStamp> stamps;
+    if (not pmt::is_dict(meta))
+        return stamps;
+    pmt::pmt_t trace = pmt::dict_ref(meta, PMT_LATENCY, pmt::PMT_NIL);
+    if (not pmt::is_dict(trace))
+        return stamps;
+
+    pmt::pmt_t items = pmt::dict_items(trace);
+    for (size_t i = 0; i < pmt::length(items); i++) {
+        pmt::pmt_t item = pmt::nth(i, items);
+        pmt::pmt_t times = pmt::cdr(item);
+        if (not pmt::is_u64vector(times) or pmt::length(times) != 2)
+            continue;
+        size_t len(0);
+        const uint64_t* t = pmt::u64vector_elements(times, len);
+        stamps.push_back({ pmt::symbol_to_string(pmt::car(item)), t[0], t[1] });
+    }
+    std::sort(stamps.begin(), stamps.end(), [](const auto& a, const auto& b) {
+        return a.entry_ns < b.entry_ns;
+    });
+    return stamps;
+}
+
+} /* namespace plasma */
+} /* namespace gr */
@@ -0,0 +1,59 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_LATENCY_TRACE_H
+#define INCLUDED_PLASMA_LATENCY_TRACE_H
+
+#include <pmt/pmt.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief One stage of a latency trace
+ */
+struct LatencyStamp {
+    std::string stage;
+    uint64_t entry_ns;
+    uint64_t exit_ns;
+};
+
+/**
+ * @brief Current system time in nanoseconds since the epoch
+ *
+ * The system clock is used so that traces stay comparable when a PDU crosses process
+ * boundaries on the same host.
+ */
+uint64_t latency_now_ns();
+
+/**
+ * @brief Record the entry and exit times of a stage in the latency trace of a
+ * metadata dictionary
+ *
+ * @param meta Metadata dictionary. If this is not a dictionary, a new one is created.
+ * @param stage Name of the stage
+ * @param entry_ns Time at which the stage received the data
+ * @param exit_ns Time at which the stage output the data
+ * @return pmt::pmt_t Updated metadata dictionary
+ */
+pmt::pmt_t latency_stamp(pmt::pmt_t meta,
+                         const std::string& stage,
+                         uint64_t entry_ns,
+                         uint64_t exit_ns);
+
+/**
+ * @brief Extract the latency trace of a metadata dictionary, sorted by entry time
+ */
+std::vector<LatencyStamp> latency_trace(const pmt::pmt_t& meta);
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_LATENCY_TRACE_H */
@@ -36,10 +36,7 @@ lfm_source_impl::lfm_source_impl(
       d_samp_rate(samp_rate),
       d_prf(prf)
 {
-    af::array waveform =
-        ::plasma::lfm(start_freq, bandwidth, pulse_width, samp_rate).as(c32);
-    d_data = pmt::init_c32vector(
-        waveform.elements(), reinterpret_cast<gr_complex*>(waveform.host<af::cfloat>()));
+    update_waveform();
 
     message_port_register_in(d_msg_port);
     message_port_register_out(d_out_port);
@@ -68,10 +65,37 @@ bool lfm_source_impl::start()
 
 void lfm_source_impl::handle_msg(pmt::pmt_t msg)
 {
-    // TODO: Handle dictionary inputs for changing many parameters at once
-    pmt::pmt_t key = pmt::car(msg);
-    pmt::pmt_t value = pmt::cdr(msg);
+    gr::thread::scoped_lock lock(d_mutex);
+    pmt::pmt_t effective_sample = pmt::PMT_NIL;
+    if (pmt::is_pair(msg) and pmt::is_symbol(pmt::car(msg))) {
+        // Single (key . value) pair
+        set_parameter(pmt::car(msg), pmt::cdr(msg));
+    } else if (pmt::is_dict(msg)) {
+        // Apply every parameter in the dictionary before regenerating the waveform
+        pmt::pmt_t items = pmt::dict_items(msg);
+        for (size_t i = 0; i < pmt::length(items); i++) {
+            pmt::pmt_t item = pmt::nth(i, items);
+            if (pmt::equal(pmt::car(item), PMT_EFFECTIVE_SAMPLE))
+                effective_sample = pmt::cdr(item);
+            else
+                set_parameter(pmt::car(item), pmt::cdr(item));
+        }
+    } else {
+        GR_LOG_WARN(d_logger, "Invalid message type")
+        return;
+    }
+
+    // Get the new waveform vector and emit it as a PDU. A scheduled update time only
+    // applies to the PDU of the message it arrived with.
+    update_waveform();
+    pmt::pmt_t meta = d_meta;
+    if (not pmt::is_null(effective_sample))
+        meta = pmt::dict_add(meta, PMT_EFFECTIVE_SAMPLE, effective_sample);
+    message_port_pub(d_out_port, pmt::cons(meta, d_data));
+}
 
+void lfm_source_impl::set_parameter(const pmt::pmt_t& key, const pmt::pmt_t& value)
+{
     if (pmt::equal(key, d_bandwidth_key)) {
         d_bandwidth = pmt::to_double(value);
         d_meta = pmt::dict_add(d_meta, d_bandwidth_key, pmt::from_double(d_bandwidth));
@@ -87,15 +111,30 @@ void lfm_source_impl::handle_msg(pmt::pmt_t msg)
     } else if (pmt::equal(key, d_prf_key)) {
         d_prf = pmt::to_double(value);
         d_meta = pmt::dict_add(d_meta, d_prf_key, pmt::from_double(d_prf));
+    } else {
+        GR_LOG_WARN(d_logger, "Unknown parameter " + pmt::write_string(key))
     }
+}
 
-    // Create the new waveform vector and emit it as a PDU
+void lfm_source_impl::update_waveform()
+{
+    WaveformKey key(d_bandwidth, d_start_freq, d_pulse_width, d_samp_rate);
+    if (pmt::pmt_t* data = d_cache.find(key)) {
+        d_data = *data;
+        return;
+    }
     af::array waveform =
         ::plasma::lfm(d_start_freq, d_bandwidth, d_pulse_width, d_samp_rate).as(c32);
-    d_data = pmt::init_c32vector(
-        waveform.elements(), reinterpret_cast<gr_complex*>(waveform.host<af::cfloat>()));
-    message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
+    size_t n(0);
+    d_data = pmt::make_c32vector(waveform.elements(), 0);
+    waveform.host(pmt::c32vector_writable_elements(d_data, n));
+    d_cache.insert(key, d_data);
+}
 
+void lfm_source_impl::set_cache_size(size_t size)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_cache.set_capacity(size);
 }
 
 void lfm_source_impl::init_meta_dict(const std::string& bandwidth_key,
@@ -8,10 +8,12 @@
 #ifndef INCLUDED_PLASMA_LFM_SOURCE_IMPL_H
 #define INCLUDED_PLASMA_LFM_SOURCE_IMPL_H
 
+#include "lru_cache.h"
 #include <gnuradio/plasma/lfm_source.h>
 #include <gnuradio/plasma/pmt_constants.h>
 #include <arrayfire.h>
 #include <plasma_dsp/lfm.h>
+#include <tuple>
 
 namespace gr {
 namespace plasma {
@@ -34,6 +36,11 @@ private:
 
     // Waveform object and IQ data
     pmt::pmt_t d_data;
+    // Previously generated waveforms, keyed by (bandwidth, start_freq, pulse_width,
+    // samp_rate)
+    using WaveformKey = std::tuple<double, double, double, double>;
+    LruCache<WaveformKey, pmt::pmt_t> d_cache;
+    gr::thread::mutex d_mutex;
     // std::unique_ptr<std::complex<float>> d_data;
     size_t d_num_samp;
     uint64_t d_start_time;
@@ -52,6 +59,8 @@ private:
     pmt::pmt_t d_meta;
 
     void handle_msg(pmt::pmt_t msg);
+    void set_parameter(const pmt::pmt_t& key, const pmt::pmt_t& value);
+    void update_waveform();
 
 
 public:
@@ -63,6 +72,7 @@ public:
     ~lfm_source_impl();
 
     bool start() override;
+    void set_cache_size(size_t size) override;
 
     void init_meta_dict(const std::string& bandwidth_key,
                         const std::string& start_freq_key,
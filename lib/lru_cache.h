@@ -0,0 +1,111 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_LRU_CACHE_H
+#define INCLUDED_PLASMA_LRU_CACHE_H
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief Fixed-capacity cache that evicts the least recently used entry
+ *
+ * Entries are kept in a list ordered from most to least recently used, with a map from
+ * each key to its list node. Lookups and insertions are O(log n), and a hit only splices
+ * the node to the front of the list, so cached values are never copied or moved.
+ *
+ * @tparam Key Key type. Must be less-than comparable.
+ * @tparam Value Value type
+ */
+template <typename Key, typename Value>
+class LruCache
+{
+public:
+    explicit LruCache(size_t capacity = 16) : d_capacity(capacity) {}
+
+    /**
+     * @brief Look up a key, marking it as the most recently used entry on a hit
+     *
+     * @return Value* Pointer to the cached value, or nullptr on a miss. The pointer is
+     * valid until the entry is evicted.
+     */
+    Value* find(const Key& key)
+    {
+        auto it = d_index.find(key);
+        if (it == d_index.end())
+            return nullptr;
+        d_entries.splice(d_entries.begin(), d_entries, it->second);
+        return &it->second->second;
+    }
+
+    /**
+     * @brief Add (or replace) an entry, evicting the least recently used entries if
+     * the cache is full
+     *
+     * @return Value& Reference to the cached value
+     */
+    Value& insert(const Key& key, Value value)
+    {
+        auto it = d_index.find(key);
+        if (it != d_index.end()) {
+            it->second->second = std::move(value);
+            d_entries.splice(d_entries.begin(), d_entries, it->second);
+            return it->second->second;
+        }
+        d_entries.emplace_front(key, std::move(value));
+        d_index[key] = d_entries.begin();
+        evict();
+        return d_entries.front().second;
+    }
+
+    /**
+     * @brief Set the maximum number of entries. With a capacity of zero, only the most
+     * recent entry is kept.
+     */
+    void set_capacity(size_t capacity)
+    {
+        d_capacity = capacity;
+        evict();
+    }
+
+    size_t capacity() const { return d_capacity; }
+    size_t size() const { return d_entries.size(); }
+
+    void clear()
+    {
+        d_entries.clear();
+        d_index.clear();
+    }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    void evict()
+    {
+        // Keep the newest entry even with a capacity of zero so that the reference
+        // returned by insert() stays valid
+        size_t capacity = std::max<size_t>(d_capacity, 1);
+        while (d_entries.size() > capacity) {
+            d_index.erase(d_entries.back().first);
+            d_entries.pop_back();
+        }
+    }
+
+    size_t d_capacity;
+    std::list<Entry> d_entries;
+    std::map<Key, typename std::list<Entry>::iterator> d_index;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_LRU_CACHE_H */
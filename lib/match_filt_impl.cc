@@ -6,8 +6,11 @@
  */
 
 #include "match_filt_impl.h"
+#include "fractional_delay.h"
+#include "latency_trace.h"
 #include <gnuradio/io_signature.h>
 #include <arrayfire.h>
+#include <algorithm>
 
 namespace gr {
 namespace plasma {
@@ -24,11 +27,17 @@ match_filt::sptr match_filt::make(size_t num_pulse_cpi)
 match_filt_impl::match_filt_impl(size_t num_pulse_cpi)
     : gr::block(
           "match_filt", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
-      d_num_pulse_cpi(num_pulse_cpi)
+      d_num_waveforms(1),
+      d_waveform_length(0),
+      d_frac_delay(0),
+      d_num_pulse_cpi(num_pulse_cpi),
+      d_num_beams(1),
+      d_samp_rate(0),
+      d_latency_tracing(false)
 {
 
     d_data = pmt::make_c32vector(1, 0);
-    d_meta = pmt::make_dict();
+    d_tx_samples = pmt::PMT_NIL;
 
     d_tx_port = PMT_TX;
     d_rx_port = PMT_RX;
@@ -46,15 +55,20 @@ match_filt_impl::match_filt_impl(size_t num_pulse_cpi)
 match_filt_impl::~match_filt_impl() {}
 
 
-int nextpow2(int x) { return pow(2, ceil(log(x) / log(2))); }
-
 void match_filt_impl::handle_tx_msg(pmt::pmt_t msg)
 {
+    bind_device();
     pmt::pmt_t samples;
+    RadarMeta meta;
+    size_t nwave = 1;
     if (pmt::is_pdu(msg)) {
         // Get the transmit data
         samples = pmt::cdr(msg);
-        d_meta = pmt::dict_update(d_meta, pmt::car(msg));
+        meta = RadarMeta::parse(pmt::car(msg));
+        nwave = pmt::to_uint64(meta.ref(PMT_NUM_WAVEFORMS, pmt::from_uint64(1)));
+        d_meta.update(meta);
+        if (meta.has(RadarMeta::SAMPLE_RATE))
+            d_samp_rate = meta.get_double(RadarMeta::SAMPLE_RATE);
     } else if (pmt::is_uniform_vector(msg)) {
         samples = msg;
     } else {
@@ -62,50 +76,84 @@ void match_filt_impl::handle_tx_msg(pmt::pmt_t msg)
         return;
     }
     size_t n = pmt::length(samples);
-    size_t io(0);
-    const gr_complex* tx_data = pmt::c32vector_elements(samples, io);
-    // Resize the matched filter array if necessary
+    if (nwave == 0 or n % nwave != 0) {
+        GR_LOG_WARN(d_logger, "Waveform bank size does not match its data")
+        return;
+    }
+    // Each waveform in a bank is padded to a full PRI, so only the first
+    // plasma:waveform_length samples of each are used
+    size_t ntaps = n / nwave;
+    if (nwave > 1) {
+        ntaps = pmt::to_uint64(meta.ref(PMT_WAVEFORM_LENGTH, pmt::from_uint64(ntaps)));
+        ntaps = std::clamp<size_t>(ntaps, 1, n / nwave);
+    }
+    d_tx_samples = samples;
+    d_num_waveforms = nwave;
+    d_waveform_length = ntaps;
 
-    if (d_match_filt.elements() != (int)n) {
-        d_match_filt = af::constant(0, n, c32);
+    // Sources that cache their waveforms (e.g., lfm_source) send the same PMT each time
+    // a waveform is reused, so its filter can be reused as well
+    if (auto* cached = d_filter_cache.find(samples.get())) {
+        d_taps = cached->taps;
+        d_match_filt = cached->match_filt;
+        return;
     }
-    // Create the matched filter
-    d_match_filt = af::array(af::dim4(n), reinterpret_cast<const af::cfloat*>(tx_data));
-    d_match_filt = af::conjg(d_match_filt);
-    d_match_filt = af::flip(d_match_filt, 0);
+    update_match_filt();
+    d_filter_cache.insert(samples.get(), CachedFilter{ samples, d_taps, d_match_filt });
 }
 
-void match_filt_impl::handle_rx_msg(pmt::pmt_t msg)
+void match_filt_impl::update_match_filt()
 {
+    size_t n = pmt::length(d_tx_samples);
+    size_t io(0);
+    const gr_complex* tx_data = pmt::c32vector_elements(d_tx_samples, io);
+
+    // Create the matched filter, with one column per waveform
+    d_taps = af::array(af::dim4(n / d_num_waveforms, d_num_waveforms),
+                       reinterpret_cast<const af::cfloat*>(tx_data));
+    d_taps = d_taps.rows(0, d_waveform_length - 1);
+    d_taps = af::conjg(d_taps);
+    d_taps = af::flip(d_taps, 0);
+    d_match_filt = fractional_delay_filter(d_taps, d_frac_delay);
+}
 
-    if (this->nmsgs(d_rx_port) > d_msg_queue_depth or d_match_filt.elements() == 0) {
+void match_filt_impl::bind_device()
+{
+    // Filters built for the previous backend/device can't be used on the new one, so
+    // the current filter is rebuilt from the host copy of its waveform
+    if (not d_device.bind())
         return;
-    }
-    // Get a copy of the input samples
-    pmt::pmt_t samples, meta;
-    if (pmt::is_pdu(msg)) {
-        meta = pmt::car(msg);
-        samples = pmt::cdr(msg);
-        
+    d_filter_cache.clear();
+    if (not pmt::is_null(d_tx_samples))
+        update_match_filt();
+}
 
-        // Update pulses per CPI parameter if it has changed
-        if (pmt::dict_has_key(meta, d_n_pulse_cpi_key)) {
-            d_num_pulse_cpi =
-                pmt::to_long(pmt::dict_ref(meta, d_n_pulse_cpi_key, pmt::PMT_NIL));
-        }
-        d_meta = pmt::dict_update(d_meta, meta);
-    } else if (pmt::is_uniform_vector(msg)) {
-        samples = msg;
-    } else {
-        GR_LOG_WARN(d_logger, "Invalid message type")
+void match_filt_impl::handle_rx_msg(pmt::pmt_t msg)
+{
+    uint64_t entry_ns = latency_now_ns();
+    bind_device();
+    if (d_match_filt.elements() == 0 or not d_admission.admit(this, d_rx_port, msg)) {
+        return;
+    }
+    if (d_batch.max_size() > 1) {
+        handle_batch(msg, entry_ns);
         return;
     }
+    // Get a copy of the input samples
+    pmt::pmt_t samples;
+    RadarMeta meta;
+    if (not parse_rx_msg(msg, meta, samples))
+        return;
+    set_fractional_delay(fractional_delay(meta));
+    d_meta.update(meta);
+
     // Compute matrix and vector dimensions
     size_t n = pmt::length(samples);
-    size_t ncol = d_num_pulse_cpi;
+    size_t ncol = d_num_pulse_cpi * d_num_beams;
     size_t nrow = n / ncol;
-    size_t nconv = nrow + d_match_filt.elements() - 1;
-    if (pmt::length(d_data) != n)
+    d_range_gate.update(nrow, d_match_filt.dims(0), d_samp_rate);
+    size_t nconv = d_range_gate.num_rows();
+    if (pmt::length(d_data) != nconv * ncol)
         d_data = pmt::make_c32vector(nconv * ncol, 0);
 
     // Get input and output data
@@ -115,12 +163,148 @@ void match_filt_impl::handle_rx_msg(pmt::pmt_t msg)
 
     // Apply the matched filter to each column
     af::array mf_resp(af::dim4(nrow, ncol), reinterpret_cast<const af::cfloat*>(in));
-    mf_resp = af::convolve1(mf_resp, d_match_filt, AF_CONV_EXPAND, AF_CONV_AUTO);
+    mf_resp = d_range_gate.compress(mf_resp, select_filters({ meta }, ncol));
     mf_resp.host(out);
 
-    message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
+    message_port_pub(d_out_port, pmt::cons(output_meta(d_meta, entry_ns), d_data));
     // Reset the metadata output
-    d_meta = pmt::make_dict();
+    d_meta.clear();
+}
+
+void match_filt_impl::handle_batch(pmt::pmt_t msg, uint64_t entry_ns)
+{
+    // Gather the CPIs that are already waiting in the queue, flushing early if the
+    // dimensions or the fractional delay change
+    for (const pmt::pmt_t& next : d_batch.drain(this, d_rx_port, d_admission, msg)) {
+        pmt::pmt_t samples;
+        RadarMeta parsed;
+        if (not parse_rx_msg(next, parsed, samples))
+            continue;
+        // The filters of the CPIs already in the batch are corrected for the old delay
+        double delay = fractional_delay(parsed);
+        if (delay != d_frac_delay) {
+            process_batch(entry_ns);
+            set_fractional_delay(delay);
+        }
+        // The batch holds the metadata as received, and parses it again when the batch
+        // is processed
+        pmt::pmt_t meta = pmt::is_pdu(next) ? pmt::car(next) : pmt::PMT_NIL;
+        if (not d_batch.push(meta, samples, d_num_pulse_cpi * d_num_beams)) {
+            process_batch(entry_ns);
+            d_batch.push(meta, samples, d_num_pulse_cpi * d_num_beams);
+        }
+    }
+    process_batch(entry_ns);
+}
+
+void match_filt_impl::process_batch(uint64_t entry_ns)
+{
+    if (d_batch.empty())
+        return;
+
+    // Every pulse in the batch is filtered independently, so the CPIs can be treated
+    // as extra columns of a single matrix
+    size_t nrow = d_batch.nrow();
+    size_t ncol = d_batch.ncol() * d_batch.size();
+    d_range_gate.update(nrow, d_match_filt.dims(0), d_samp_rate);
+    std::vector<RadarMeta> meta(d_batch.size());
+    for (size_t i = 0; i < d_batch.size(); i++)
+        meta[i] = RadarMeta::parse(d_batch.meta(i));
+    af::array filt = select_filters(meta, d_batch.ncol());
+    af::array mf_resp = af::moddims(d_batch.cube(), nrow, ncol);
+    mf_resp = d_range_gate.compress(mf_resp, filt);
+
+    std::vector<pmt::pmt_t> data = d_batch.split(mf_resp);
+    for (size_t i = 0; i < data.size(); i++) {
+        d_meta.update(meta[i]);
+        message_port_pub(d_out_port, pmt::cons(output_meta(d_meta, entry_ns), data[i]));
+        d_meta.clear();
+    }
+    d_batch.clear();
+}
+
+bool match_filt_impl::parse_rx_msg(const pmt::pmt_t& msg,
+                                   RadarMeta& meta,
+                                   pmt::pmt_t& samples)
+{
+    if (pmt::is_pdu(msg)) {
+        meta = RadarMeta::parse(pmt::car(msg));
+        samples = pmt::cdr(msg);
+
+        // Update pulses per CPI parameter if it has changed
+        pmt::pmt_t n_pulse_cpi = meta.ref(d_n_pulse_cpi_key, pmt::PMT_NIL);
+        if (not pmt::is_null(n_pulse_cpi))
+            d_num_pulse_cpi = pmt::to_long(n_pulse_cpi);
+        d_num_beams = pmt::to_long(meta.ref(PMT_NUM_BEAMS, pmt::from_long(d_num_beams)));
+        if (meta.has(RadarMeta::SAMPLE_RATE))
+            d_samp_rate = meta.get_double(RadarMeta::SAMPLE_RATE);
+    } else if (pmt::is_uniform_vector(msg)) {
+        meta = RadarMeta();
+        samples = msg;
+    } else {
+        GR_LOG_WARN(d_logger, "Invalid message type")
+        return false;
+    }
+    return true;
+}
+
+af::array match_filt_impl::select_filters(const std::vector<RadarMeta>& meta,
+                                          size_t ncol)
+{
+    // Without a waveform bank, every pulse uses the same filter
+    size_t nwave = d_match_filt.dims(1);
+    if (nwave == 1)
+        return d_match_filt;
+
+    // Otherwise, gather the filter of each pulse from its waveform index. Every beam
+    // of a CPI repeats the same pulses.
+    std::vector<uint32_t> index;
+    index.reserve(meta.size() * ncol);
+    for (const RadarMeta& m : meta) {
+        pmt::pmt_t cpi_index = m.ref(PMT_WAVEFORM_INDEX, pmt::PMT_NIL);
+        size_t npulse = pmt::is_u32vector(cpi_index) ? pmt::length(cpi_index) : 0;
+        if (npulse == 0 or ncol % npulse != 0) {
+            GR_LOG_WARN(d_logger, "Missing waveform indices, using the first waveform")
+            return d_match_filt.col(0);
+        }
+        size_t io(0);
+        const uint32_t* ptr = pmt::u32vector_elements(cpi_index, io);
+        for (size_t i = 0; i < ncol / npulse; i++)
+            index.insert(index.end(), ptr, ptr + npulse);
+    }
+    if (*std::max_element(index.begin(), index.end()) >= nwave) {
+        GR_LOG_WARN(d_logger, "Waveform index out of range, using the first waveform")
+        return d_match_filt.col(0);
+    }
+    return af::lookup(d_match_filt, af::array(index.size(), index.data()), 1);
+}
+
+double match_filt_impl::fractional_delay(const RadarMeta& meta) const
+{
+    pmt::pmt_t delay = meta.ref(PMT_FRACTIONAL_DELAY, pmt::PMT_NIL);
+    return pmt::is_number(delay) ? pmt::to_double(delay) : d_frac_delay;
+}
+
+void match_filt_impl::set_fractional_delay(double delay)
+{
+    if (delay == d_frac_delay)
+        return;
+    // Filters are cached with the correction already applied
+    d_frac_delay = delay;
+    d_filter_cache.clear();
+    d_match_filt = fractional_delay_filter(d_taps, d_frac_delay);
+}
+
+pmt::pmt_t match_filt_impl::output_meta(RadarMeta meta, uint64_t entry_ns)
+{
+    if (d_range_gate.enabled()) {
+        meta.set_long(RadarMeta::RANGE_GATE_START, d_range_gate.start_delay());
+        meta.set_long(RadarMeta::RANGE_GATE_STOP, d_range_gate.stop_delay());
+    }
+    pmt::pmt_t out = meta.pack();
+    if (d_latency_tracing)
+        out = latency_stamp(out, alias(), entry_ns, latency_now_ns());
+    return out;
 }
 
 void match_filt_impl::set_metadata_keys(const std::string& n_pulse_cpi_key)
@@ -128,25 +312,42 @@ void match_filt_impl::set_metadata_keys(const std::string& n_pulse_cpi_key)
     d_n_pulse_cpi_key = pmt::intern(n_pulse_cpi_key);
 }
 
-void match_filt_impl::set_msg_queue_depth(size_t depth) { d_msg_queue_depth = depth; }
+void match_filt_impl::set_msg_queue_depth(size_t depth)
+{
+    d_admission.set_queue_depth(depth);
+}
+
+void match_filt_impl::set_admission_policy(AdmissionControl::Policy policy, double max_rate)
+{
+    d_admission.set_policy(policy);
+    d_admission.set_max_rate(max_rate);
+}
+
+uint64_t match_filt_impl::num_dropped() { return d_admission.num_dropped(); }
+
+void match_filt_impl::set_batch_size(size_t batch_size)
+{
+    d_batch.set_max_size(batch_size);
+}
+
+void match_filt_impl::set_range_gates(double min_gate, double max_gate, bool in_meters)
+{
+    d_range_gate.set_limits(min_gate, max_gate, in_meters);
+}
 
 void match_filt_impl::set_backend(Device::Backend backend)
 {
-    switch (backend) {
-    case Device::CPU:
-        d_backend = AF_BACKEND_CPU;
-        break;
-    case Device::CUDA:
-        d_backend = AF_BACKEND_CUDA;
-        break;
-    case Device::OPENCL:
-        d_backend = AF_BACKEND_OPENCL;
-        break;
-    default:
-        d_backend = AF_BACKEND_DEFAULT;
-        break;
-    }
-    af::setBackend(d_backend);
+    d_device.set_backend(backend);
 }
+
+void match_filt_impl::set_device_id(int device_id) { d_device.set_device_id(device_id); }
+
+void match_filt_impl::set_cpu_affinity(const std::vector<int>& cores)
+{
+    d_device.set_cpu_affinity(cores);
+}
+
+void match_filt_impl::set_latency_tracing(bool enable) { d_latency_tracing = enable; }
+
 } /* namespace plasma */
 } /* namespace gr */
@@ -8,6 +8,10 @@
 #ifndef INCLUDED_PLASMA_MATCH_FILT_IMPL_H
 #define INCLUDED_PLASMA_MATCH_FILT_IMPL_H
 
+#include "cpi_batch.h"
+#include "lru_cache.h"
+#include "radar_meta.h"
+#include "range_gate.h"
 #include <gnuradio/plasma/match_filt.h>
 #include <gnuradio/plasma/pmt_constants.h>
 #include <arrayfire.h>
@@ -19,28 +23,72 @@ namespace plasma {
 class match_filt_impl : public match_filt
 {
 private:
+    // Matched filter taps, with one column per waveform if the transmit data is a
+    // waveform bank. d_taps is the filter before the fractional delay correction.
+    af::array d_taps;
     af::array d_match_filt;
-    af::Backend d_backend;
+    // Latest transmit waveform (or bank), kept so the filter can be rebuilt when the
+    // backend changes
+    pmt::pmt_t d_tx_samples;
+    size_t d_num_waveforms;
+    size_t d_waveform_length;
+    struct CachedFilter {
+        pmt::pmt_t waveform;
+        af::array taps;
+        af::array match_filt;
+    };
+    // Filters of recently used waveforms, keyed by the waveform PMT. Each entry holds a
+    // reference to its PMT so that the key can't be reused by another waveform.
+    LruCache<const pmt::pmt_base*, CachedFilter> d_filter_cache;
+    // Receive delay (in samples) left over after the radar's integer delay correction
+    double d_frac_delay;
+    Device d_device;
     size_t d_num_pulse_cpi;
-    size_t d_msg_queue_depth;
-    
-    pmt::pmt_t d_meta;
+    // Beams stacked in each CPI (from a beamformer), processed as extra columns
+    size_t d_num_beams;
+    AdmissionControl d_admission;
+    double d_samp_rate;
+    RangeGate d_range_gate;
+    CpiBatch d_batch;
+    bool d_latency_tracing;
+
+    RadarMeta d_meta;
     pmt::pmt_t d_n_pulse_cpi_key;
 
     pmt::pmt_t d_data;
     pmt::pmt_t d_tx_port;
     pmt::pmt_t d_rx_port;
     pmt::pmt_t d_out_port;
+    void update_match_filt();
+    void bind_device();
+    void handle_batch(pmt::pmt_t msg, uint64_t entry_ns);
+    void process_batch(uint64_t entry_ns);
+    bool parse_rx_msg(const pmt::pmt_t& msg, RadarMeta& meta, pmt::pmt_t& samples);
+    pmt::pmt_t output_meta(RadarMeta meta, uint64_t entry_ns);
+    af::array select_filters(const std::vector<RadarMeta>& meta, size_t ncol);
     void handle_tx_msg(pmt::pmt_t);
     void handle_rx_msg(pmt::pmt_t);
+    double fractional_delay(const RadarMeta& meta) const;
+    void set_fractional_delay(double delay);
+
+    // The benchmarks in bench/ call the message handlers directly
+    friend class BlockBenchmark;
 
 public:
     match_filt_impl(size_t num_pulse_cpi);
     ~match_filt_impl();
 
     void set_msg_queue_depth(size_t) override;
+    void set_admission_policy(AdmissionControl::Policy policy,
+                              double max_rate) override;
+    uint64_t num_dropped() override;
+    void set_batch_size(size_t batch_size) override;
     void set_backend(Device::Backend) override;
+    void set_device_id(int device_id) override;
+    void set_cpu_affinity(const std::vector<int>& cores) override;
     void set_metadata_keys(const std::string& n_pulse_cpi_key) override;
+    void set_range_gates(double min_gate, double max_gate, bool in_meters) override;
+    void set_latency_tracing(bool enable) override;
 };
 
 } // namespace plasma
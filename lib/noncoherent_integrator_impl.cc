@@ -0,0 +1,128 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "noncoherent_integrator_impl.h"
+#include "latency_trace.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+
+namespace gr {
+namespace plasma {
+
+noncoherent_integrator::sptr noncoherent_integrator::make(size_t num_cpi, Method method)
+{
+    return gnuradio::make_block_sptr<noncoherent_integrator_impl>(num_cpi, method);
+}
+
+
+/*
+ * The private constructor
+ */
+noncoherent_integrator_impl::noncoherent_integrator_impl(size_t num_cpi, Method method)
+    : gr::block("noncoherent_integrator",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_num_cpi(std::max<size_t>(num_cpi, 1)),
+      d_method(method),
+      d_count(0),
+      d_latency_tracing(false),
+      d_in_port(PMT_IN),
+      d_out_port(PMT_OUT)
+{
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+noncoherent_integrator_impl::~noncoherent_integrator_impl() {}
+
+void noncoherent_integrator_impl::handle_msg(pmt::pmt_t msg)
+{
+    uint64_t entry_ns = latency_now_ns();
+    if (not pmt::is_pdu(msg) or not pmt::is_c32vector(pmt::cdr(msg))) {
+        GR_LOG_WARN(d_logger, "Input must be a PDU of complex samples")
+        return;
+    }
+    gr::thread::scoped_lock lock(d_mutex);
+    // The accumulator belongs to the previous backend/device
+    if (d_device.bind())
+        reset();
+    pmt::pmt_t samples = pmt::cdr(msg);
+    size_t n = pmt::length(samples);
+    if ((size_t)d_power.elements() != n)
+        reset();
+    d_meta.update(RadarMeta::parse(pmt::car(msg)));
+
+    size_t io(0);
+    const gr_complex* in = pmt::c32vector_elements(samples, io);
+    af::array x(n, reinterpret_cast<const af::cfloat*>(in));
+    af::array power = af::real(x) * af::real(x) + af::imag(x) * af::imag(x);
+    if (d_count == 0)
+        d_power = power;
+    else if (d_method == SUM)
+        d_power += power;
+    else
+        d_power += (power - d_power) / d_num_cpi;
+    // Evaluate now so the JIT tree doesn't grow with each CPI
+    d_power.eval();
+    d_count++;
+
+    size_t num_integrated;
+    if (d_method == SUM) {
+        if (d_count < d_num_cpi)
+            return;
+        num_integrated = d_count;
+        d_count = 0;
+    } else {
+        // An exponential average with weight a has the variance of an average of
+        // (2 - a) / a independent CPIs
+        num_integrated = std::min(d_count, 2 * d_num_cpi - 1);
+    }
+
+    pmt::pmt_t data = pmt::make_f32vector(n, 0);
+    d_power.host(pmt::f32vector_writable_elements(data, io));
+    d_meta.add(PMT_NUM_INTEGRATED, pmt::from_long(num_integrated));
+    pmt::pmt_t meta = d_meta.pack();
+    if (d_latency_tracing)
+        meta = latency_stamp(meta, alias(), entry_ns, latency_now_ns());
+    message_port_pub(d_out_port, pmt::cons(meta, data));
+    d_meta.clear();
+}
+
+void noncoherent_integrator_impl::reset()
+{
+    d_power = af::array();
+    d_count = 0;
+}
+
+void noncoherent_integrator_impl::set_num_cpi(size_t num_cpi)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_num_cpi = std::max<size_t>(num_cpi, 1);
+    reset();
+}
+
+void noncoherent_integrator_impl::set_backend(Device::Backend backend)
+{
+    d_device.set_backend(backend);
+}
+
+void noncoherent_integrator_impl::set_device_id(int device_id)
+{
+    d_device.set_device_id(device_id);
+}
+
+void noncoherent_integrator_impl::set_latency_tracing(bool enable)
+{
+    d_latency_tracing = enable;
+}
+
+} /* namespace plasma */
+} /* namespace gr */
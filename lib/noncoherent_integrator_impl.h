@@ -0,0 +1,53 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_NONCOHERENT_INTEGRATOR_IMPL_H
+#define INCLUDED_PLASMA_NONCOHERENT_INTEGRATOR_IMPL_H
+
+#include "radar_meta.h"
+#include <gnuradio/plasma/noncoherent_integrator.h>
+#include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/thread/thread.h>
+#include <arrayfire.h>
+
+namespace gr {
+namespace plasma {
+
+class noncoherent_integrator_impl : public noncoherent_integrator
+{
+private:
+    size_t d_num_cpi;
+    Method d_method;
+    // Integrated power, kept on the device between CPIs, and the number of CPIs it
+    // holds
+    af::array d_power;
+    size_t d_count;
+    RadarMeta d_meta;
+    Device d_device;
+    bool d_latency_tracing;
+    gr::thread::mutex d_mutex;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+
+    void handle_msg(pmt::pmt_t msg);
+    void reset();
+
+public:
+    noncoherent_integrator_impl(size_t num_cpi, Method method);
+    ~noncoherent_integrator_impl();
+
+    void set_num_cpi(size_t num_cpi) override;
+    void set_backend(Device::Backend) override;
+    void set_device_id(int device_id) override;
+    void set_latency_tracing(bool enable) override;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_NONCOHERENT_INTEGRATOR_IMPL_H */
@@ -11,6 +11,38 @@
 namespace gr {
 namespace plasma {
 
+namespace {
+/**
+ * @brief Parse a phase code class given by name or by PhaseCode::Code value
+ */
+bool parse_code_type(const pmt::pmt_t& value, PhaseCode::Code& type)
+{
+    if (pmt::is_integer(value)) {
+        type = static_cast<PhaseCode::Code>(pmt::to_long(value));
+        return true;
+    }
+    if (not pmt::is_symbol(value))
+        return false;
+    std::string name = pmt::symbol_to_string(value);
+    for (auto code : { PhaseCode::BARKER,
+                       PhaseCode::FRANK,
+                       PhaseCode::P4,
+                       PhaseCode::P1,
+                       PhaseCode::P2,
+                       PhaseCode::P3,
+                       PhaseCode::PX,
+                       PhaseCode::ZADOFF_CHU,
+                       PhaseCode::COSTAS,
+                       PhaseCode::MPS }) {
+        if (PhaseCode::code_string(code) == name) {
+            type = code;
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
 pcfm_source::sptr
 pcfm_source::make(PhaseCode::Code code, int n, int over, double samp_rate)
 {
@@ -28,21 +60,25 @@ pcfm_source_impl::pcfm_source_impl(PhaseCode::Code code,
     : gr::block("pcfm_source",
                 gr::io_signature::make(0, 0, 0),
                 gr::io_signature::make(0, 0, 0)),
-      d_samp_rate(samp_rate)
+      d_code_type(code),
+      d_n_chips(n),
+      d_over(over),
+      d_samp_rate(samp_rate),
+      d_pulse_width(0),
+      d_in_port(PMT_IN),
+      d_out_port(PMT_OUT),
+      d_sample_rate_key(PMT_SAMPLE_RATE),
+      d_label_key(PMT_LABEL),
+      d_duration_key(PMT_DURATION),
+      d_phase_code_class_key(PMT_PHASE_CODE_CLASS),
+      d_n_phase_code_chips_key(PMT_NUM_PHASE_CODE_CHIPS)
 {
-    std::vector<double> codevec = PhaseCode::generate_code(code, n);
-    d_code_class = PhaseCode::code_string(code);
-    // Convert the code and filter to arrayfire arrays
-    d_code = af::array(codevec.size(), f64);
-    d_code.write(codevec.data(), codevec.size() * sizeof(double));
-    d_filter = af::constant(1, over);
-    // Generate the waveform
-    d_waveform = ::plasma::PCFMWaveform(d_code, d_filter, d_samp_rate);
-    af::array waveform_array = d_waveform.sample().as(c32);
-    d_data.reset(reinterpret_cast<gr_complex*>(waveform_array.host<af::cfloat>()));
-    d_n_samp = waveform_array.elements();
-    d_n_chips = n;
-   
+    update_waveform();
+    update_meta();
+
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
 }
 
 /*
@@ -52,39 +88,130 @@ pcfm_source_impl::~pcfm_source_impl() {}
 
 bool pcfm_source_impl::start()
 {
-    d_finished = false;
-    pmt::pmt_t data = pmt::init_c32vector(d_n_samp, d_data.get());
-    message_port_pub(d_out_port, pmt::cons(d_meta, data));
+    gr::thread::scoped_lock lock(d_mutex);
+    message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
 
     return block::start();
 }
 
+void pcfm_source_impl::handle_msg(pmt::pmt_t msg)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    // Keep the current parameters in case the new combination is invalid
+    auto code_type = d_code_type;
+    auto n_chips = d_n_chips;
+    auto over = d_over;
+    auto samp_rate = d_samp_rate;
+
+    pmt::pmt_t effective_sample = pmt::PMT_NIL;
+    if (pmt::is_pair(msg) and pmt::is_symbol(pmt::car(msg))) {
+        // Single (key . value) pair
+        set_parameter(pmt::car(msg), pmt::cdr(msg));
+    } else if (pmt::is_dict(msg)) {
+        // Apply every parameter in the dictionary before regenerating the waveform
+        pmt::pmt_t items = pmt::dict_items(msg);
+        for (size_t i = 0; i < pmt::length(items); i++) {
+            pmt::pmt_t item = pmt::nth(i, items);
+            if (pmt::equal(pmt::car(item), PMT_EFFECTIVE_SAMPLE))
+                effective_sample = pmt::cdr(item);
+            else
+                set_parameter(pmt::car(item), pmt::cdr(item));
+        }
+    } else {
+        GR_LOG_WARN(d_logger, "Invalid message type")
+        return;
+    }
+
+    try {
+        update_waveform();
+    } catch (const std::invalid_argument& e) {
+        GR_LOG_WARN(d_logger, std::string("Invalid waveform parameters: ") + e.what())
+        d_code_type = code_type;
+        d_n_chips = n_chips;
+        d_over = over;
+        d_samp_rate = samp_rate;
+        return;
+    }
+    update_meta();
+    pmt::pmt_t meta = d_meta;
+    if (not pmt::is_null(effective_sample))
+        meta = pmt::dict_add(meta, PMT_EFFECTIVE_SAMPLE, effective_sample);
+    message_port_pub(d_out_port, pmt::cons(meta, d_data));
+}
+
+void pcfm_source_impl::set_parameter(const pmt::pmt_t& key, const pmt::pmt_t& value)
+{
+    if (pmt::equal(key, d_phase_code_class_key)) {
+        if (not parse_code_type(value, d_code_type))
+            GR_LOG_WARN(d_logger, "Unknown phase code " + pmt::write_string(value))
+    } else if (pmt::equal(key, d_n_phase_code_chips_key)) {
+        d_n_chips = pmt::to_long(value);
+    } else if (pmt::equal(key, PMT_OVERSAMPLING)) {
+        d_over = pmt::to_long(value);
+    } else if (pmt::equal(key, d_sample_rate_key)) {
+        d_samp_rate = pmt::to_double(value);
+    } else {
+        GR_LOG_WARN(d_logger, "Unknown parameter " + pmt::write_string(key))
+    }
+}
+
+void pcfm_source_impl::update_waveform()
+{
+    WaveformKey key(d_code_type, d_n_chips, d_over, d_samp_rate);
+    if (auto* cached = d_cache.find(key)) {
+        d_data = cached->first;
+        d_pulse_width = cached->second;
+        return;
+    }
+    if (d_over < 1)
+        throw std::invalid_argument("Oversampling factor must be positive");
+
+    std::vector<double> codevec = PhaseCode::generate_code(d_code_type, d_n_chips);
+    // Convert the code and filter to arrayfire arrays
+    af::array code(codevec.size(), codevec.data());
+    if (d_filter.elements() != d_over)
+        d_filter = af::constant(1, d_over);
+    // Generate the waveform directly into the output PMT
+    ::plasma::PCFMWaveform waveform(code, d_filter, d_samp_rate);
+    af::array samples = waveform.sample().as(c32);
+    size_t n(0);
+    d_data = pmt::make_c32vector(samples.elements(), 0);
+    samples.host(pmt::c32vector_writable_elements(d_data, n));
+    d_pulse_width = waveform.pulse_width();
+    d_cache.insert(key, std::make_pair(d_data, d_pulse_width));
+}
+
+void pcfm_source_impl::update_meta()
+{
+    d_meta = pmt::make_dict();
+    d_meta = pmt::dict_add(d_meta, d_sample_rate_key, pmt::from_double(d_samp_rate));
+    d_meta = pmt::dict_add(d_meta, d_label_key, pmt::intern("pcfm"));
+    d_meta = pmt::dict_add(d_meta, d_duration_key, pmt::from_double(d_pulse_width));
+    d_meta = pmt::dict_add(
+        d_meta, d_phase_code_class_key, pmt::intern(PhaseCode::code_string(d_code_type)));
+    d_meta = pmt::dict_add(d_meta, d_n_phase_code_chips_key, pmt::from_long(d_n_chips));
+    d_meta = pmt::dict_add(d_meta, PMT_OVERSAMPLING, pmt::from_long(d_over));
+}
+
 void pcfm_source_impl::set_metadata_keys(const std::string& label_key,
                                          const std::string& phase_code_class_key,
                                          const std::string& n_phase_code_chips_key,
                                          const std::string& duration_key,
                                          const std::string& sample_rate_key)
 {
+    gr::thread::scoped_lock lock(d_mutex);
     d_label_key = pmt::intern(label_key);
     d_phase_code_class_key = pmt::intern(phase_code_class_key);
     d_n_phase_code_chips_key = pmt::intern(n_phase_code_chips_key);
     d_duration_key = pmt::intern(duration_key);
     d_sample_rate_key = pmt::intern(sample_rate_key);
+    update_meta();
+}
 
-    // Set up metadata
-    d_meta = pmt::make_dict();
-
-    d_meta = pmt::dict_add(
-        d_meta, d_sample_rate_key, pmt::from_double(d_waveform.samp_rate()));
-
-    d_meta = pmt::dict_add(d_meta, d_label_key, pmt::intern("pcfm"));
-    d_meta =
-        pmt::dict_add(d_meta, d_duration_key, pmt::from_double(d_waveform.pulse_width()));
-    d_meta = pmt::dict_add(d_meta, d_phase_code_class_key, pmt::intern(d_code_class));
-    d_meta = pmt::dict_add(d_meta, d_n_phase_code_chips_key, pmt::from_long(d_n_chips));
-
-    d_out_port = PMT_OUT;
-    message_port_register_out(d_out_port);
+void pcfm_source_impl::set_cache_size(size_t size)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_cache.set_capacity(size);
 }
 
 
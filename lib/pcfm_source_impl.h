@@ -8,10 +8,12 @@
 #ifndef INCLUDED_PLASMA_PCFM_SOURCE_IMPL_H
 #define INCLUDED_PLASMA_PCFM_SOURCE_IMPL_H
 
+#include "lru_cache.h"
 #include <gnuradio/plasma/pcfm_source.h>
 #include <gnuradio/plasma/pmt_constants.h>
 #include <plasma_dsp/pcfm.h>
 #include <plasma_dsp/phase_code.h>
+#include <tuple>
 
 namespace gr {
 namespace plasma {
@@ -19,19 +21,26 @@ namespace plasma {
 class pcfm_source_impl : public pcfm_source
 {
 private:
-    ::plasma::PCFMWaveform d_waveform;
-    std::unique_ptr<gr_complex> d_data;
-    size_t d_n_samp;
-    size_t d_n_chips;
-    af::array d_code;
-    af::array d_filter;
+    // Waveform parameters
+    PhaseCode::Code d_code_type;
+    int d_n_chips;
+    int d_over;
     double d_samp_rate;
-    std::atomic<bool> d_finished;
+    double d_pulse_width;
 
+    // Waveform IQ data
+    pmt::pmt_t d_data;
+    // Frequency shaping filter, rebuilt only when the oversampling factor changes
+    af::array d_filter;
+    // Previously generated waveforms and their pulse widths, keyed by (code type,
+    // number of chips, oversampling factor, sample rate)
+    using WaveformKey = std::tuple<int, int, int, double>;
+    LruCache<WaveformKey, std::pair<pmt::pmt_t, double>> d_cache;
+    gr::thread::mutex d_mutex;
 
     pmt::pmt_t d_meta;
+    pmt::pmt_t d_in_port;
     pmt::pmt_t d_out_port;
-    std::string d_code_class;
 
     // Metadata keys
     pmt::pmt_t d_sample_rate_key;
@@ -40,6 +49,11 @@ private:
     pmt::pmt_t d_phase_code_class_key;
     pmt::pmt_t d_n_phase_code_chips_key;
 
+    void handle_msg(pmt::pmt_t msg);
+    void set_parameter(const pmt::pmt_t& key, const pmt::pmt_t& value);
+    void update_waveform();
+    void update_meta();
+
 public:
     pcfm_source_impl(PhaseCode::Code code, int n, int over, double samp_rate);
     ~pcfm_source_impl();
@@ -47,10 +61,11 @@ public:
     bool start() override;
 
     void set_metadata_keys(const std::string& label_key,
-                      const std::string& phase_code_class_key,
-                      const std::string& n_phase_code_chips_key,
-                      const std::string& duration_key,
-                      const std::string& sample_rate_key);
+                           const std::string& phase_code_class_key,
+                           const std::string& n_phase_code_chips_key,
+                           const std::string& duration_key,
+                           const std::string& sample_rate_key) override;
+    void set_cache_size(size_t size) override;
 };
 
 } // namespace plasma
@@ -51,7 +51,9 @@ pdu_file_sink_impl::pdu_file_sink_impl(size_t itemsize,
                 gr::io_signature::make(0, 0, 0)),
       d_itemsize(itemsize),
       d_data_filename(data_filename),
-      d_meta_filename(meta_filename)
+      d_meta_filename(meta_filename),
+      d_writing(false),
+      d_first(true)
 {
 
     message_port_register_in(PMT_IN);
@@ -100,6 +102,7 @@ void pdu_file_sink_impl::handle_message(const pmt::pmt_t& msg)
 bool pdu_file_sink_impl::start()
 {
     d_finished = false;
+    d_first = true;
     d_thread = gr::thread::thread([this] { run(); });
 
     return block::start();
@@ -116,18 +119,18 @@ bool pdu_file_sink_impl::stop()
 
 void pdu_file_sink_impl::run()
 {
-    static bool first = true;
     while (true) {
         {
             gr::thread::scoped_lock lock(d_mutex);
             d_cond.wait(lock, [this] { return not d_data_queue.empty() || d_finished; });
-            if (d_finished)
+            // Write any PDUs that were queued before the block was stopped
+            if (d_finished and d_data_queue.empty())
                 return;
             d_data = d_data_queue.front();
             d_meta_dict = pmt::dict_update(d_meta_dict, d_meta_queue.front());
-            if (first) {
+            if (d_first) {
                 // Add global metadata fields for the first output dictionary
-                first = false;
+                d_first = false;
                 pmt::pmt_t input_global_dict =
                     pmt::dict_ref(d_meta_dict, PMT_GLOBAL, pmt::PMT_NIL);
                 pmt::pmt_t global = pmt::make_dict();
@@ -141,6 +144,7 @@ void pdu_file_sink_impl::run()
             }
             d_data_queue.pop();
             d_meta_queue.pop();
+            d_writing = true;
         }
         size_t n = pmt::length(d_data);
         d_data_file.write((char*)pmt::blob_data(d_data), n * d_itemsize);
@@ -149,9 +153,20 @@ void pdu_file_sink_impl::run()
             parse_meta(d_meta_dict, d_meta);
             d_meta_dict = pmt::make_dict();
         }
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            d_writing = false;
+        }
+        d_written_cond.notify_all();
     }
 }
 
+void pdu_file_sink_impl::flush()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_written_cond.wait(lock, [this] { return d_data_queue.empty() and not d_writing; });
+}
+
 void pdu_file_sink_impl::parse_meta(const pmt::pmt_t& dict, nlohmann::json& json)
 {
     pmt::pmt_t items = pmt::dict_items(dict);
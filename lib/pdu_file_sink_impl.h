@@ -80,12 +80,31 @@ private:
      */
     gr::thread::condition_variable d_cond;
 
+    /**
+     * @brief Signals flush() when the worker thread has written a PDU
+     *
+     */
+    gr::thread::condition_variable d_written_cond;
+
+    /**
+     * @brief Indicates that the worker thread is writing a PDU it took from the queue
+     *
+     */
+    bool d_writing;
+
     /**
      * @brief Indicates that the block should clean up and shut down
      *
      */
     std::atomic<bool> d_finished;
 
+    /**
+     * @brief Indicates that the next metadata written is the first since the block
+     * started, which also gets the global SigMF fields
+     *
+     */
+    bool d_first;
+
     /**
      * @brief Current data item to be written to file
      *
@@ -148,6 +167,12 @@ public:
      *
      */
     void run();
+
+    /**
+     * @brief Block until the worker thread has written every queued PDU
+     *
+     */
+    void flush();
 };
 
 } // namespace plasma
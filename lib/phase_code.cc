@@ -7,10 +7,77 @@
 
 #include <gnuradio/io_signature.h>
 #include <gnuradio/plasma/phase_code.h>
+#include <array>
+#include <cstdint>
 
 namespace gr {
 namespace plasma {
 
+namespace {
+
+/**
+ * @brief Binary code with the first chip in the most significant bit, where a set bit
+ * is a phase of pi
+ */
+struct BinaryCode {
+    int length;
+    uint64_t bits;
+};
+
+constexpr size_t max_binary_length = 64;
+using PhaseTable = std::array<double, max_binary_length>;
+
+/**
+ * @brief Expand binary codes to phase values at compile time
+ */
+template <size_t N>
+constexpr std::array<PhaseTable, N> make_phase_tables(const BinaryCode (&codes)[N])
+{
+    std::array<PhaseTable, N> tables{};
+    for (size_t i = 0; i < N; i++) {
+        for (int k = 0; k < codes[i].length; k++) {
+            bool set = (codes[i].bits >> (codes[i].length - 1 - k)) & 1;
+            tables[i][k] = set ? M_PI : 0;
+        }
+    }
+    return tables;
+}
+
+constexpr BinaryCode barker_codes[] = {
+    { 2, 0x1 }, { 3, 0x1 }, { 4, 0x1 }, { 5, 0x2 }, { 7, 0xD }, { 11, 0xED },
+    { 13, 0xCA },
+};
+
+// Minimum peak sidelobe codes of lengths 2 through 42, found by branch and bound
+// search. The peak sidelobe is 1 for the Barker lengths, 2 up to length 21 and for
+// lengths 25 and 28, and 3 otherwise.
+constexpr BinaryCode mps_codes[] = {
+    { 2, 0x0 }, { 3, 0x1 }, { 4, 0x2 }, { 5, 0x2 }, { 6, 0x4 }, { 7, 0xD }, { 8, 0x14 },
+    { 9, 0x2C }, { 10, 0x2C }, { 11, 0xED }, { 12, 0xD4 }, { 13, 0xCA }, { 14, 0x194 },
+    { 15, 0x194 }, { 16, 0xEA4 }, { 17, 0x3F59 }, { 18, 0x168C }, { 19, 0x7112 },
+    { 20, 0x4D4E }, { 21, 0x3EED6 }, { 22, 0x11968 }, { 23, 0x34B88 }, { 24, 0x34CA8 },
+    { 25, 0x31FAB6 }, { 26, 0x15B0C8 }, { 27, 0x34D588 }, { 28, 0x18FD5B6 },
+    { 29, 0x635268 }, { 30, 0x2B11D34 }, { 31, 0x18F49A8 }, { 32, 0x1B630A8 },
+    { 33, 0x459A9E8 }, { 34, 0x6716568 }, { 35, 0x796A998 }, { 36, 0x1D8D9628 },
+    { 37, 0xAC29F4C8 }, { 38, 0x444BB4878 }, { 39, 0x6348DDAE8 }, { 40, 0x60EE91AC8 },
+    { 41, 0x38EA520364 }, { 42, 0x4447B874B4 },
+};
+
+constexpr auto barker_tables = make_phase_tables(barker_codes);
+constexpr auto mps_tables = make_phase_tables(mps_codes);
+
+template <size_t N>
+std::vector<double> lookup_code(const BinaryCode (&codes)[N],
+                                const std::array<PhaseTable, N>& tables,
+                                int n)
+{
+    for (size_t i = 0; i < N; i++) {
+        if (codes[i].length == n)
+            return std::vector<double>(tables[i].begin(), tables[i].begin() + n);
+    }
+    return {};
+}
+
 /**
  * @brief Generate a barker code of length n
  *
@@ -19,38 +86,42 @@ namespace plasma {
  */
 std::vector<double> barker(int n)
 {
-    std::vector<double> code;
-    switch (n) {
-    case 2:
-        code = { 0, 1 };
-        break;
-    case 3:
-        code = { 0, 0, 1 };
-        break;
-    case 4:
-        code = { 0, 0, 0, 1 };
-        break;
-    case 5:
-        code = { 0, 0, 0, 1, 0 };
-        break;
-    case 7:
-        code = { 0, 0, 0, 1, 1, 0, 1 };
-        break;
-    case 11:
-        code = { 0, 0, 0, 1, 1, 1, 0, 1, 1, 0, 1 };
-        break;
-    case 13:
-        code = { 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 1, 0 };
-        break;
-    default:
+    std::vector<double> code = lookup_code(barker_codes, barker_tables, n);
+    if (code.empty())
         throw std::invalid_argument("Invalid barker code length: " + std::to_string(n));
-    }
-    for (auto& c : code) {
-        c *= M_PI;
-    }
     return code;
 }
 
+/**
+ * @brief Generate a minimum peak sidelobe code of length n
+ *
+ * @param n Code length
+ * @return std::vector<double> MPS code phase values
+ */
+std::vector<double> mps(int n)
+{
+    std::vector<double> code = lookup_code(mps_codes, mps_tables, n);
+    if (code.empty())
+        throw std::invalid_argument("Invalid MPS code length: " + std::to_string(n));
+    return code;
+}
+
+/**
+ * @brief Return the square root of a code length that must be a perfect square
+ */
+int square_root(int M)
+{
+    int L = std::round(std::sqrt(M));
+    if (L * L != M)
+        throw std::invalid_argument("Code length must be a perfect square");
+    return L;
+}
+
+/*
+ * The generators below evaluate each phase in closed form, without wrapping, so that
+ * the inner loops vectorize. The phases are wrapped in a single pass afterwards.
+ */
+
 /**
  * @brief Generate a Frank code of (perfect square) length-M
  *
@@ -59,33 +130,152 @@ std::vector<double> barker(int n)
  */
 std::vector<double> frank(int M)
 {
-    // Check that M is a perfect square (i.e., L is an integer)
-    int L = std::round(std::sqrt(M));
-    if (L * L != M)
-        throw std::invalid_argument("Code length must be a perfect square");
-    // Generate the code
+    int L = square_root(M);
     std::vector<double> code(M);
     for (auto n = 0; n < L; n++) {
-        for (auto k = 0; k < L; k++) {
-            code[n * L + k] = std::fmod((2 * M_PI / L) * (n * k), 2 * M_PI);
-        }
+        double step = 2 * M_PI / L * n;
+        for (auto k = 0; k < L; k++)
+            code[n * L + k] = step * k;
     }
     return code;
 }
 
+std::vector<double> p1(int M)
+{
+    int L = square_root(M);
+    std::vector<double> code(M);
+    for (auto j = 0; j < L; j++) {
+        double scale = -M_PI / L * (L - (2 * j + 1));
+        for (auto i = 0; i < L; i++)
+            code[j * L + i] = scale * (j * L + i);
+    }
+    return code;
+}
+
+std::vector<double> p2(int M)
+{
+    int L = square_root(M);
+    if (L % 2 != 0)
+        throw std::invalid_argument(
+            "P2 code length must be the square of an even number");
+    std::vector<double> code(M);
+    for (auto i = 0; i < L; i++) {
+        double scale = M_PI / (2 * L) * (L - 1 - 2 * i);
+        for (auto j = 0; j < L; j++)
+            code[i * L + j] = scale * (L - 1 - 2 * j);
+    }
+    return code;
+}
+
+std::vector<double> p3(int M)
+{
+    std::vector<double> phi(M);
+    for (int m = 0; m < M; m++)
+        phi[m] = M_PI / M * ((double)m * m);
+    return phi;
+}
+
 std::vector<double> p4(int M)
 {
     std::vector<double> phi(M);
-    for (int m = 1; m <= M; m++) {
-        phi[m - 1] = 2 * M_PI / M * (m - 1) * (m - 1 - M) / 2;
+    for (int m = 0; m < M; m++)
+        phi[m] = M_PI / M * ((double)m * (m - M));
+    return phi;
+}
+
+std::vector<double> px(int M)
+{
+    int L = square_root(M);
+    // The group offset differs by half a step for odd L
+    double offset_i = (L + 1) / 2.0;
+    double offset_j = (L % 2 == 0) ? (L + 1) / 2.0 : L / 2.0;
+    std::vector<double> code(M);
+    for (auto i = 0; i < L; i++) {
+        double scale = 2 * M_PI / L * (offset_i - (i + 1));
+        for (auto j = 0; j < L; j++)
+            code[i * L + j] = scale * (offset_j - (j + 1));
     }
+    return code;
+}
+
+std::vector<double> zadoff_chu(int N)
+{
+    // Root index 1. Odd lengths use m(m+1) so that the sequence is periodic in N.
+    int shift = N % 2;
+    std::vector<double> phi(N);
+    for (int m = 0; m < N; m++)
+        phi[m] = -M_PI / N * ((double)m * (m + shift));
     return phi;
 }
 
+/**
+ * @brief Generate the phases of a Costas frequency hopping code of length M = N^2
+ *
+ * Hop k lasts N chips at a frequency of f_k / N cycles per chip, so the phase advances
+ * by a whole number of cycles each hop and is continuous at the hop boundaries. This
+ * is a Frank code with its frequency steps reordered by a Costas sequence.
+ */
+std::vector<double> costas(int M)
+{
+    int L = square_root(M);
+    std::vector<int> freq = PhaseCode::costas_sequence(L);
+    std::vector<double> code(M);
+    for (auto n = 0; n < L; n++) {
+        double step = 2 * M_PI / L * freq[n];
+        for (auto k = 0; k < L; k++)
+            code[n * L + k] = step * k;
+    }
+    return code;
+}
+
+bool is_prime(int p)
+{
+    if (p < 2)
+        return false;
+    for (int d = 2; d * d <= p; d++) {
+        if (p % d == 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
 void PhaseCode::wrapToPi(std::vector<double>& x)
 {
+    // Branch-free so that the loop vectorizes
+    constexpr double two_pi = 2 * M_PI;
     for (auto& v : x)
-        v = -M_PI + fmod(2 * M_PI + fmod(v + M_PI, 2 * M_PI), 2 * M_PI);
+        v -= two_pi * std::floor((v + M_PI) / two_pi);
+}
+
+std::vector<int> PhaseCode::costas_sequence(int n)
+{
+    // Welch construction: f_i = a^i mod p for a primitive root a of p = n + 1
+    int p = n + 1;
+    if (not is_prime(p))
+        throw std::invalid_argument("Costas sequence length plus one must be prime");
+    if (n == 1)
+        return { 0 };
+    std::vector<int> seq(n);
+    for (int a = 2; a < p; a++) {
+        // a is a primitive root if its powers visit every nonzero residue exactly once
+        std::vector<bool> seen(p, false);
+        long x = 1;
+        bool primitive = true;
+        for (int i = 0; i < n; i++) {
+            x = x * a % p;
+            if (seen[x]) {
+                primitive = false;
+                break;
+            }
+            seen[x] = true;
+            seq[i] = x - 1;
+        }
+        if (primitive)
+            break;
+    }
+    return seq;
 }
 
 std::vector<double> PhaseCode::generate_code(Code code_type, int n)
@@ -103,6 +293,27 @@ std::vector<double> PhaseCode::generate_code(Code code_type, int n)
     case P4:
         code = p4(n);
         break;
+    case P1:
+        code = p1(n);
+        break;
+    case P2:
+        code = p2(n);
+        break;
+    case P3:
+        code = p3(n);
+        break;
+    case PX:
+        code = px(n);
+        break;
+    case ZADOFF_CHU:
+        code = zadoff_chu(n);
+        break;
+    case COSTAS:
+        code = costas(n);
+        break;
+    case MPS:
+        code = mps(n);
+        break;
     default:
         throw std::invalid_argument("Invalid phase code type");
         break;
@@ -120,6 +331,20 @@ std::string PhaseCode::code_string(Code type)
         return "frank";
     case P4:
         return "p4";
+    case P1:
+        return "p1";
+    case P2:
+        return "p2";
+    case P3:
+        return "p3";
+    case PX:
+        return "px";
+    case ZADOFF_CHU:
+        return "zadoff_chu";
+    case COSTAS:
+        return "costas";
+    case MPS:
+        return "mps";
     default:
         return "generic";
     }
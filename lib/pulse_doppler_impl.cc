@@ -6,6 +6,7 @@
  */
 
 #include "pulse_doppler_impl.h"
+#include "fractional_delay.h"
 #include <gnuradio/io_signature.h>
 
 namespace gr {
@@ -25,9 +26,12 @@ pulse_doppler_impl::pulse_doppler_impl(int num_pulse_cpi, int doppler_fft_size)
                 gr::io_signature::make(0, 0, 0),
                 gr::io_signature::make(0, 0, 0)),
       d_num_pulse_cpi(num_pulse_cpi),
-      d_fftsize(doppler_fft_size)
+      d_fftsize(doppler_fft_size),
+      d_samp_rate(0),
+      d_frac_delay(0)
 {
     d_data = pmt::make_c32vector(0, 0);
+    d_tx_samples = pmt::PMT_NIL;
 
     d_tx_port = PMT_TX;
     d_rx_port = PMT_RX;
@@ -47,38 +51,65 @@ pulse_doppler_impl::~pulse_doppler_impl() {}
 
 void pulse_doppler_impl::handle_tx_msg(pmt::pmt_t msg)
 {
-    if (this->nmsgs(d_tx_port) > d_msg_queue_depth)
+    d_device.bind();
+    if (this->nmsgs(d_tx_port) > d_admission.queue_depth())
         return;
     pmt::pmt_t samples;
     if (pmt::is_pdu(msg)) {
         samples = pmt::cdr(msg);
-        d_meta = pmt::dict_update(d_meta, pmt::car(msg));
+        RadarMeta meta = RadarMeta::parse(pmt::car(msg));
+        d_meta.update(meta);
+        if (meta.has(RadarMeta::SAMPLE_RATE))
+            d_samp_rate = meta.get_double(RadarMeta::SAMPLE_RATE);
     } else if (pmt::is_uniform_vector(msg)) {
         samples = msg;
     } else {
         GR_LOG_WARN(d_logger, "Invalid message type")
         return;
     }
-    size_t n = pmt::length(samples);
+    d_tx_samples = samples;
+    update_match_filt();
+}
+
+void pulse_doppler_impl::update_match_filt()
+{
+    size_t n = pmt::length(d_tx_samples);
     size_t io(0);
-    const gr_complex* tx_data = pmt::c32vector_elements(samples, io);
+    const gr_complex* tx_data = pmt::c32vector_elements(d_tx_samples, io);
 
     // Create the matched filter
     d_match_filt = af::array(af::dim4(n), reinterpret_cast<const af::cfloat*>(tx_data));
     d_match_filt = af::conjg(d_match_filt);
     d_match_filt = af::flip(d_match_filt, 0);
+    d_match_filt = fractional_delay_filter(d_match_filt, d_frac_delay);
+}
+
+void pulse_doppler_impl::set_fractional_delay(const RadarMeta& meta)
+{
+    pmt::pmt_t delay = meta.ref(PMT_FRACTIONAL_DELAY, pmt::PMT_NIL);
+    if (not pmt::is_number(delay) or pmt::to_double(delay) == d_frac_delay)
+        return;
+    d_frac_delay = pmt::to_double(delay);
+    update_match_filt();
 }
 
 void pulse_doppler_impl::handle_rx_msg(pmt::pmt_t msg)
 {
+    // The matched filter must be on this block's current backend
+    if (d_device.bind() and d_match_filt.elements() > 0)
+        update_match_filt();
     pmt::pmt_t samples;
-    if (this->nmsgs(d_rx_port) > d_msg_queue_depth or d_match_filt.elements() == 0) {
+    if (d_match_filt.elements() == 0 or not d_admission.admit(this, d_rx_port, msg)) {
         return;
     }
     // Get a copy of the input samples
     if (pmt::is_pdu(msg)) {
         samples = pmt::cdr(msg);
-        d_meta = pmt::dict_update(d_meta, pmt::car(msg));
+        RadarMeta meta = RadarMeta::parse(pmt::car(msg));
+        d_meta.update(meta);
+        if (meta.has(RadarMeta::SAMPLE_RATE))
+            d_samp_rate = meta.get_double(RadarMeta::SAMPLE_RATE);
+        set_fractional_delay(meta);
     } else if (pmt::is_uniform_vector(msg)) {
         samples = msg;
     } else {
@@ -89,7 +120,8 @@ void pulse_doppler_impl::handle_rx_msg(pmt::pmt_t msg)
     size_t n = pmt::length(samples);
     size_t ncol = d_num_pulse_cpi;
     size_t nrow = n / ncol;
-    size_t nconv = nrow + d_match_filt.elements() - 1;
+    d_range_gate.update(nrow, d_match_filt.elements(), d_samp_rate);
+    size_t nconv = d_range_gate.num_rows();
     if (pmt::length(d_data) != nconv * d_fftsize)
         d_data = pmt::make_c32vector(nconv * d_fftsize, 0);
 
@@ -101,7 +133,7 @@ void pulse_doppler_impl::handle_rx_msg(pmt::pmt_t msg)
     // Apply the matched filter to each column
     af::array rdm(af::dim4(nrow, d_num_pulse_cpi),
                   reinterpret_cast<const af::cfloat*>(in));
-    rdm = af::convolve1(rdm, d_match_filt, AF_CONV_EXPAND, AF_CONV_AUTO);
+    rdm = d_range_gate.compress(rdm, d_match_filt);
 
     // Do a doppler FFT for each range bin
     rdm = rdm.T();
@@ -109,38 +141,54 @@ void pulse_doppler_impl::handle_rx_msg(pmt::pmt_t msg)
     rdm = ::plasma::fftshift(rdm, 0);
     rdm = rdm.T();
     rdm.host(out);
+    if (d_range_gate.enabled()) {
+        d_meta.set_long(RadarMeta::RANGE_GATE_START, d_range_gate.start_delay());
+        d_meta.set_long(RadarMeta::RANGE_GATE_STOP, d_range_gate.stop_delay());
+    }
 
-    message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
-    d_meta = pmt::make_dict();
+    message_port_pub(d_out_port, pmt::cons(d_meta.pack(), d_data));
+    d_meta.clear();
     // init_meta_dict(pmt::symbol_to_string(d_doppler_fft_size_key));
 }
 
-void pulse_doppler_impl::set_msg_queue_depth(size_t depth) { d_msg_queue_depth = depth; }
+void pulse_doppler_impl::set_msg_queue_depth(size_t depth)
+{
+    d_admission.set_queue_depth(depth);
+}
+
+void pulse_doppler_impl::set_admission_policy(AdmissionControl::Policy policy, double max_rate)
+{
+    d_admission.set_policy(policy);
+    d_admission.set_max_rate(max_rate);
+}
+
+uint64_t pulse_doppler_impl::num_dropped() { return d_admission.num_dropped(); }
+
+void pulse_doppler_impl::set_range_gates(double min_gate, double max_gate, bool in_meters)
+{
+    d_range_gate.set_limits(min_gate, max_gate, in_meters);
+}
 
 void pulse_doppler_impl::set_backend(Device::Backend backend)
 {
-    switch (backend) {
-    case Device::CPU:
-        d_backend = AF_BACKEND_CPU;
-        break;
-    case Device::CUDA:
-        d_backend = AF_BACKEND_CUDA;
-        break;
-    case Device::OPENCL:
-        d_backend = AF_BACKEND_OPENCL;
-        break;
-    default:
-        d_backend = AF_BACKEND_DEFAULT;
-        break;
-    }
-    af::setBackend(d_backend);
+    d_device.set_backend(backend);
+}
+
+void pulse_doppler_impl::set_device_id(int device_id)
+{
+    d_device.set_device_id(device_id);
+}
+
+void pulse_doppler_impl::set_cpu_affinity(const std::vector<int>& cores)
+{
+    d_device.set_cpu_affinity(cores);
 }
 
 void pulse_doppler_impl::init_meta_dict(std::string doppler_fft_size_key)
 {
     d_doppler_fft_size_key = pmt::intern(doppler_fft_size_key);
-    d_meta = pmt::make_dict();
-    d_meta = pmt::dict_add(d_meta, d_doppler_fft_size_key, pmt::from_long(d_fftsize));
+    d_meta.clear();
+    d_meta.add(d_doppler_fft_size_key, pmt::from_long(d_fftsize));
 }
 
 } /* namespace plasma */
@@ -8,6 +8,8 @@
 #ifndef INCLUDED_PLASMA_PULSE_DOPPLER_IMPL_H
 #define INCLUDED_PLASMA_PULSE_DOPPLER_IMPL_H
 
+#include "radar_meta.h"
+#include "range_gate.h"
 #include <gnuradio/plasma/pmt_constants.h>
 #include <gnuradio/plasma/pulse_doppler.h>
 #include <plasma_dsp/fft.h>
@@ -18,30 +20,45 @@ namespace plasma {
 class pulse_doppler_impl : public pulse_doppler
 {
 private:
+    // Matched filter, built on the device from the latest transmit waveform (which is
+    // kept so the filter can be rebuilt when the backend changes) and corrected for the
+    // fractional receive delay
     af::array d_match_filt;
-    af::Backend d_backend;
-    size_t d_msg_queue_depth;
+    pmt::pmt_t d_tx_samples;
+    Device d_device;
+    AdmissionControl d_admission;
     int d_num_pulse_cpi;
     int d_fftsize;
+    double d_samp_rate;
+    double d_frac_delay;
+    RangeGate d_range_gate;
 
     pmt::pmt_t d_tx_port;
     pmt::pmt_t d_rx_port;
     pmt::pmt_t d_out_port;
-    pmt::pmt_t d_meta;
+    RadarMeta d_meta;
     pmt::pmt_t d_data;
     // Metadata keys
     pmt::pmt_t d_doppler_fft_size_key;
 
     void handle_tx_msg(pmt::pmt_t);
     void handle_rx_msg(pmt::pmt_t);
+    void update_match_filt();
+    void set_fractional_delay(const RadarMeta& meta);
 
 public:
     pulse_doppler_impl(int num_pulse_cpi, int doppler_fft_size);
     ~pulse_doppler_impl();
 
     void set_msg_queue_depth(size_t) override;
+    void set_admission_policy(AdmissionControl::Policy policy,
+                              double max_rate) override;
+    uint64_t num_dropped() override;
     void set_backend(Device::Backend) override;
+    void set_device_id(int device_id) override;
+    void set_cpu_affinity(const std::vector<int>& cores) override;
     void init_meta_dict(std::string doppler_fft_size_key) override;
+    void set_range_gates(double min_gate, double max_gate, bool in_meters) override;
 };
 
 } // namespace plasma
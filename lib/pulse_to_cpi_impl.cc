@@ -6,7 +6,9 @@
  */
 
 #include "pulse_to_cpi_impl.h"
+#include "latency_trace.h"
 #include <gnuradio/io_signature.h>
+#include <algorithm>
 #include <chrono>
 
 namespace gr {
@@ -28,6 +30,11 @@ pulse_to_cpi_impl::pulse_to_cpi_impl(size_t n_pulse_cpi)
       pulses_per_cpi(n_pulse_cpi)
 {
     pulse_count = 0;
+    latency_tracing = false;
+    first_trace = pmt::PMT_NIL;
+    first_time = pmt::PMT_NIL;
+    has_waveform_index = false;
+    num_indexed = 0;
     in_port = PMT_IN;
     out_port = PMT_OUT;
 
@@ -44,23 +51,73 @@ pulse_to_cpi_impl::~pulse_to_cpi_impl() {}
 
 void pulse_to_cpi_impl::handle_msg(pmt::pmt_t msg)
 {
-    pmt::pmt_t samples;
-    if (pmt::is_pdu(msg)) {
-        // Update input metadata
-        meta = pmt::dict_update(meta, pmt::car(msg));
-        samples = pmt::cdr(msg);
-    } else {
+    uint64_t entry_ns = latency_now_ns();
+    if (not pmt::is_pdu(msg)) {
         GR_LOG_WARN(d_logger, "Invalid message type")
+        return;
     }
+    pmt::pmt_t in_meta = pmt::car(msg);
+    pmt::pmt_t samples = pmt::cdr(msg);
+    pmt::pmt_t offsets = pmt::dict_ref(in_meta, PMT_PULSE_OFFSETS, pmt::PMT_NIL);
+    if (pmt::is_u64vector(offsets))
+        pulse_offsets = pmt::u64vector_elements(offsets);
 
     size_t num_samples = pmt::length(samples);
+    const gr_complex* samples_ptr = pmt::c32vector_elements(samples, num_samples);
+    // Each PDU from a staggered PRF train holds a full stagger group. The pulses have
+    // different PRIs, so each one is truncated to the shortest PRI.
+    size_t pulse_len = num_samples;
+    if (pulse_offsets.size() > 1) {
+        pulse_len = num_samples - std::min<size_t>(pulse_offsets.back(), num_samples);
+        for (size_t i = 0; i + 1 < pulse_offsets.size(); i++) {
+            pulse_len =
+                std::min<size_t>(pulse_len, pulse_offsets[i + 1] - pulse_offsets[i]);
+        }
+        if (pulse_len == 0) {
+            GR_LOG_WARN(d_logger, "Pulse offsets do not match the received data")
+            return;
+        }
+    }
+    // A new PRI or stagger changes the pulse length, and the pulses gathered so far
+    // can't be stacked with the new ones
+    if (pulse_count > 0 and data.size() != pulses_per_cpi * pulse_len) {
+        GR_LOG_WARN(d_logger, "Pulse length changed, dropping the partial CPI")
+        reset_cpi();
+    }
+
+    // Update input metadata
+    meta.update(RadarMeta::parse(in_meta));
+    // Measure latency from the oldest pulse in the CPI, which also gives its time
+    if (pulse_count == 0) {
+        first_trace = pmt::dict_ref(in_meta, PMT_LATENCY, pmt::PMT_NIL);
+        first_time = pmt::dict_ref(in_meta, PMT_RX_TIME, pmt::PMT_NIL);
+    }
+    pmt::pmt_t index = pmt::dict_ref(in_meta, PMT_WAVEFORM_INDEX, pmt::PMT_NIL);
+    if (not pmt::is_null(index)) {
+        waveform_index.resize(pulses_per_cpi);
+        waveform_index[pulse_count] = pmt::to_uint64(index);
+        has_waveform_index = true;
+        num_indexed++;
+    }
+
+    if (pulse_offsets.size() <= 1) {
+        add_pulse(samples_ptr, pulse_len, entry_ns);
+        return;
+    }
+    for (uint64_t offset : pulse_offsets)
+        add_pulse(samples_ptr + offset, pulse_len, entry_ns);
+}
+
+void pulse_to_cpi_impl::add_pulse(const gr_complex* samples_ptr,
+                                  size_t num_samples,
+                                  uint64_t entry_ns)
+{
     if (pulse_count == 0) {
         if (data.size() != pulses_per_cpi * num_samples) {
             data = std::vector<gr_complex>(pulses_per_cpi * num_samples);
         }
     }
     // Store the new PDU data
-    const gr_complex* samples_ptr = pmt::c32vector_elements(samples, num_samples);
     size_t start = pulse_count * num_samples;
     // Replace the for-loop above with std::copy
     std::copy(samples_ptr, samples_ptr + num_samples, data.begin() + start);
@@ -68,19 +125,47 @@ void pulse_to_cpi_impl::handle_msg(pmt::pmt_t msg)
     pulse_count++;
     // Output a PDU containing all the pulses in a column-major format
     if (pulse_count == pulses_per_cpi) {
+        if (not pmt::is_null(first_trace))
+            meta.add(PMT_LATENCY, first_trace);
+        if (not pmt::is_null(first_time))
+            meta.add(PMT_RX_TIME, first_time);
+        // Replace the index of the last pulse with the index of every pulse. If some
+        // pulses weren't tagged (e.g., after a receive overflow), their waveforms are
+        // unknown, so no indices are sent and match_filt falls back to its default.
+        if (has_waveform_index and num_indexed == pulses_per_cpi) {
+            meta.add(PMT_WAVEFORM_INDEX,
+                     pmt::init_u32vector(pulses_per_cpi, waveform_index));
+        } else if (has_waveform_index) {
+            GR_LOG_WARN(d_logger, "Some pulses in the CPI have no waveform index")
+            meta.remove(PMT_WAVEFORM_INDEX);
+        }
+        pmt::pmt_t out_meta = meta.pack();
+        if (latency_tracing)
+            out_meta = latency_stamp(out_meta, alias(), entry_ns, latency_now_ns());
         message_port_pub(out_port,
-                         pmt::cons(meta, pmt::init_c32vector(data.size(), data)));
-        // Reset the metadata
-        meta = pmt::make_dict();
-        pulse_count = 0;
+                         pmt::cons(out_meta, pmt::init_c32vector(data.size(), data)));
+        reset_cpi();
     }
 }
 
+void pulse_to_cpi_impl::reset_cpi()
+{
+    meta.clear();
+    first_trace = pmt::PMT_NIL;
+    first_time = pmt::PMT_NIL;
+    has_waveform_index = false;
+    num_indexed = 0;
+    pulse_count = 0;
+}
+
 void pulse_to_cpi_impl::init_meta_dict(std::string n_pulse_cpi_key)
 {
     this->pulses_per_cpi_key = pmt::string_to_symbol(n_pulse_cpi_key);
-    meta = pmt::make_dict();
-    meta = pmt::dict_add(meta, pulses_per_cpi_key, pmt::from_long(pulses_per_cpi));
+    meta.clear();
+    meta.add(pulses_per_cpi_key, pmt::from_long(pulses_per_cpi));
 }
+
+void pulse_to_cpi_impl::set_latency_tracing(bool enable) { latency_tracing = enable; }
+
 } /* namespace plasma */
 } /* namespace gr */
@@ -8,6 +8,7 @@
 #ifndef INCLUDED_PLASMA_PULSE_TO_CPI_IMPL_H
 #define INCLUDED_PLASMA_PULSE_TO_CPI_IMPL_H
 
+#include "radar_meta.h"
 #include <gnuradio/plasma/pulse_to_cpi.h>
 #include <gnuradio/plasma/pmt_constants.h>
 
@@ -21,11 +22,26 @@ private:
     pmt::pmt_t pulses_per_cpi_key;
     pmt::pmt_t in_port;
     pmt::pmt_t out_port;
-    pmt::pmt_t meta;
+    RadarMeta meta;
 
     std::vector<gr_complex> data;
     size_t pulses_per_cpi;
     size_t pulse_count;
+    bool latency_tracing;
+    // Latency trace and receive time of the first pulse in the CPI
+    pmt::pmt_t first_trace;
+    pmt::pmt_t first_time;
+    // Waveform bank index of each pulse in the CPI, if the pulses are tagged, and
+    // the number of pulses that carried one
+    std::vector<uint32_t> waveform_index;
+    bool has_waveform_index;
+    size_t num_indexed;
+    // Start sample of each pulse in the received buffers (from plasma:pulse_offsets)
+    std::vector<uint64_t> pulse_offsets;
+
+    void add_pulse(const gr_complex* samples_ptr, size_t num_samples, uint64_t entry_ns);
+    // Start a new CPI, discarding any pulses and metadata gathered so far
+    void reset_cpi();
 
 
 public:
@@ -34,6 +50,7 @@ public:
     ~pulse_to_cpi_impl();
 
     void init_meta_dict(std::string n_pulse_cpi_key) override;
+    void set_latency_tracing(bool enable) override;
 };
 
 } // namespace plasma
@@ -0,0 +1,134 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/plasma/admission_control.h>
+#include <gnuradio/plasma/pmt_constants.h>
+#include <boost/test/unit_test.hpp>
+
+namespace gr {
+namespace plasma {
+
+namespace {
+
+// A block with a single input port whose queue the tests fill by hand
+class queue_block : public gr::block
+{
+public:
+    queue_block()
+        : gr::block("queue_block",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0))
+    {
+        message_port_register_in(PMT_IN);
+    }
+};
+
+std::shared_ptr<queue_block> make_queue(long nmsgs)
+{
+    auto block = gnuradio::make_block_sptr<queue_block>();
+    for (long i = 0; i < nmsgs; i++)
+        block->_post(PMT_IN, pmt::from_long(i));
+    return block;
+}
+
+// Take the next message off the queue, the way the scheduler does before it calls a
+// message handler, and pass it to the admission control
+bool deliver(AdmissionControl& admission, gr::basic_block* block, long& value)
+{
+    pmt::pmt_t msg = block->delete_head_nowait(PMT_IN);
+    bool admitted = admission.admit(block, PMT_IN, msg);
+    value = pmt::to_long(msg);
+    return admitted;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_admission_control_keep_latest)
+{
+    AdmissionControl admission;
+    BOOST_CHECK_EQUAL(admission.policy(), AdmissionControl::KEEP_LATEST);
+    BOOST_CHECK_EQUAL(admission.queue_depth(), 1u);
+
+    // With 4 messages still queued behind the first, the block skips ahead until one
+    // is left waiting
+    auto block = make_queue(5);
+    long value;
+    BOOST_CHECK(deliver(admission, block.get(), value));
+    BOOST_CHECK_EQUAL(value, 3);
+    BOOST_CHECK_EQUAL(block->nmsgs(PMT_IN), 1u);
+    BOOST_CHECK(deliver(admission, block.get(), value));
+    BOOST_CHECK_EQUAL(value, 4);
+    BOOST_CHECK_EQUAL(admission.num_dropped(), 3u);
+    BOOST_CHECK_EQUAL(admission.num_processed(), 2u);
+
+    // A depth of zero always jumps to the newest message
+    admission.reset_counters();
+    admission.set_queue_depth(0);
+    block = make_queue(5);
+    BOOST_CHECK(deliver(admission, block.get(), value));
+    BOOST_CHECK_EQUAL(value, 4);
+    BOOST_CHECK_EQUAL(block->nmsgs(PMT_IN), 0u);
+    BOOST_CHECK_EQUAL(admission.num_dropped(), 4u);
+    BOOST_CHECK_EQUAL(admission.num_processed(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_admission_control_fifo)
+{
+    AdmissionControl admission;
+    admission.set_policy(AdmissionControl::FIFO);
+
+    // Every message is processed, in order
+    auto block = make_queue(5);
+    for (long i = 0; i < 5; i++) {
+        long value;
+        BOOST_CHECK(deliver(admission, block.get(), value));
+        BOOST_CHECK_EQUAL(value, i);
+    }
+    BOOST_CHECK_EQUAL(admission.num_dropped(), 0u);
+    BOOST_CHECK_EQUAL(admission.num_processed(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(test_admission_control_rate_limited)
+{
+    AdmissionControl admission;
+    admission.set_policy(AdmissionControl::RATE_LIMITED);
+
+    // Without a rate, nothing is limited
+    auto block = make_queue(2);
+    long value;
+    BOOST_CHECK(deliver(admission, block.get(), value));
+    BOOST_CHECK(deliver(admission, block.get(), value));
+    BOOST_CHECK_EQUAL(admission.num_dropped(), 0u);
+
+    // At one message per second, only the first of a burst gets through
+    AdmissionControl limited;
+    limited.set_policy(AdmissionControl::RATE_LIMITED);
+    limited.set_max_rate(1);
+    block = make_queue(3);
+    BOOST_CHECK(deliver(limited, block.get(), value));
+    BOOST_CHECK_EQUAL(value, 0);
+    BOOST_CHECK(not deliver(limited, block.get(), value));
+    BOOST_CHECK(not deliver(limited, block.get(), value));
+    BOOST_CHECK_EQUAL(limited.num_dropped(), 2u);
+    BOOST_CHECK_EQUAL(limited.num_processed(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_admission_control_record_drop)
+{
+    AdmissionControl admission;
+    admission.record_drop();
+    admission.record_drop(2);
+    BOOST_CHECK_EQUAL(admission.num_dropped(), 3u);
+    admission.reset_counters();
+    BOOST_CHECK_EQUAL(admission.num_dropped(), 0u);
+}
+
+} /* namespace plasma */
+} /* namespace gr */
@@ -8,13 +8,160 @@
 #include <gnuradio/attributes.h>
 #include <gnuradio/plasma/phase_code.h>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <complex>
+#include <set>
 
 namespace gr {
 namespace plasma {
 
-BOOST_AUTO_TEST_CASE(test_phase_code_replace_with_specific_test_name)
+namespace {
+
+std::vector<std::complex<double>> to_complex(const std::vector<double>& phase)
+{
+    std::vector<std::complex<double>> x(phase.size());
+    for (size_t i = 0; i < phase.size(); i++)
+        x[i] = std::polar(1.0, phase[i]);
+    return x;
+}
+
+/**
+ * @brief Magnitude of the aperiodic (or periodic) autocorrelation at each nonzero lag
+ */
+std::vector<double> sidelobes(const std::vector<double>& phase, bool periodic)
+{
+    auto x = to_complex(phase);
+    size_t n = x.size();
+    std::vector<double> out;
+    for (size_t lag = 1; lag < n; lag++) {
+        std::complex<double> sum = 0;
+        size_t len = periodic ? n : n - lag;
+        for (size_t i = 0; i < len; i++)
+            sum += x[(i + lag) % n] * std::conj(x[i]);
+        out.push_back(std::abs(sum));
+    }
+    return out;
+}
+
+double peak_sidelobe(const std::vector<double>& phase, bool periodic = false)
+{
+    auto s = sidelobes(phase, periodic);
+    return *std::max_element(s.begin(), s.end());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_phase_code_barker)
+{
+    for (int n : { 2, 3, 4, 5, 7, 11, 13 }) {
+        auto code = PhaseCode::generate_code(PhaseCode::BARKER, n);
+        BOOST_REQUIRE_EQUAL(code.size(), n);
+        BOOST_CHECK_SMALL(peak_sidelobe(code) - 1, 1e-9);
+    }
+    // The 13-chip code is unchanged from the original table
+    auto code = PhaseCode::generate_code(PhaseCode::BARKER, 13);
+    std::vector<int> expected = { 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 1, 0 };
+    for (size_t i = 0; i < code.size(); i++)
+        BOOST_CHECK_SMALL(std::abs(std::cos(code[i]) - (expected[i] ? -1 : 1)), 1e-12);
+    BOOST_CHECK_THROW(PhaseCode::generate_code(PhaseCode::BARKER, 6),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_code_mps)
+{
+    for (int n = 2; n <= 42; n++) {
+        auto code = PhaseCode::generate_code(PhaseCode::MPS, n);
+        BOOST_REQUIRE_EQUAL(code.size(), n);
+        double psl = peak_sidelobe(code);
+        double expected = 3;
+        if (n <= 21 or n == 25 or n == 28)
+            expected = 2;
+        if (n <= 5 or n == 7 or n == 11 or n == 13)
+            expected = 1;
+        BOOST_CHECK_SMALL(psl - expected, 1e-9);
+    }
+    BOOST_CHECK_THROW(PhaseCode::generate_code(PhaseCode::MPS, 43),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_code_perfect_periodic)
+{
+    // Frank, P3 and Zadoff-Chu codes have ideal periodic autocorrelations
+    for (auto type : { PhaseCode::FRANK, PhaseCode::ZADOFF_CHU }) {
+        for (int n : { 16, 64 })
+            BOOST_CHECK_SMALL(
+                peak_sidelobe(PhaseCode::generate_code(type, n), true), 1e-9);
+    }
+    BOOST_CHECK_SMALL(
+        peak_sidelobe(PhaseCode::generate_code(PhaseCode::ZADOFF_CHU, 63), true), 1e-9);
+    BOOST_CHECK_SMALL(
+        peak_sidelobe(PhaseCode::generate_code(PhaseCode::P3, 64), true), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_code_polyphase)
+{
+    // P4 is P3 with a linear phase term of -pi per chip
+    int n = 100;
+    auto p3 = PhaseCode::generate_code(PhaseCode::P3, n);
+    auto p4 = PhaseCode::generate_code(PhaseCode::P4, n);
+    for (int m = 0; m < n; m++) {
+        auto diff = std::polar(1.0, p3[m] - p4[m]) - std::polar(1.0, M_PI * m);
+        BOOST_CHECK_SMALL(std::abs(diff), 1e-9);
+    }
+
+    // The Frank-like codes all have a low peak sidelobe relative to their length
+    for (auto type : { PhaseCode::FRANK, PhaseCode::P1, PhaseCode::P2, PhaseCode::PX }) {
+        auto code = PhaseCode::generate_code(type, 64);
+        BOOST_REQUIRE_EQUAL(code.size(), 64);
+        BOOST_CHECK_LT(peak_sidelobe(code), 64 / 4.0);
+    }
+    BOOST_CHECK_THROW(PhaseCode::generate_code(PhaseCode::P1, 63),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(PhaseCode::generate_code(PhaseCode::P2, 49),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_code_costas)
+{
+    for (int n : { 4, 6, 10, 12, 16 }) {
+        auto seq = PhaseCode::costas_sequence(n);
+        BOOST_REQUIRE_EQUAL(seq.size(), n);
+        // Permutation of 0, ..., n - 1
+        std::set<int> values(seq.begin(), seq.end());
+        BOOST_CHECK_EQUAL(values.size(), n);
+        BOOST_CHECK_EQUAL(*values.begin(), 0);
+        BOOST_CHECK_EQUAL(*values.rbegin(), n - 1);
+        // Costas property: the differences at each spacing are distinct
+        for (int h = 1; h < n; h++) {
+            std::set<int> diffs;
+            for (int i = 0; i + h < n; i++)
+                diffs.insert(seq[i + h] - seq[i]);
+            BOOST_CHECK_EQUAL(diffs.size(), n - h);
+        }
+    }
+    BOOST_CHECK_EQUAL(PhaseCode::generate_code(PhaseCode::COSTAS, 36).size(), 36);
+    BOOST_CHECK_THROW(PhaseCode::costas_sequence(8), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_code_long)
 {
-    // Put test here
+    // Long codes are wrapped to [-pi, pi] (to within rounding error)
+    for (auto type : { PhaseCode::FRANK,
+                       PhaseCode::P1,
+                       PhaseCode::P2,
+                       PhaseCode::P3,
+                       PhaseCode::P4,
+                       PhaseCode::PX,
+                       PhaseCode::ZADOFF_CHU }) {
+        auto code = PhaseCode::generate_code(type, 4096);
+        BOOST_REQUIRE_EQUAL(code.size(), 4096);
+        for (double phi : code) {
+            BOOST_CHECK_GE(phi, -M_PI - 1e-9);
+            BOOST_CHECK_LE(phi, M_PI + 1e-9);
+        }
+    }
+    auto code = PhaseCode::generate_code(PhaseCode::COSTAS, 66 * 66);
+    BOOST_CHECK_EQUAL(code.size(), 66 * 66);
 }
 
 } /* namespace plasma */
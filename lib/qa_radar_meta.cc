@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "radar_meta.h"
+#include <gnuradio/attributes.h>
+#include <gnuradio/plasma/pmt_constants.h>
+#include <boost/test/unit_test.hpp>
+
+namespace gr {
+namespace plasma {
+
+namespace {
+
+pmt::pmt_t example_dict()
+{
+    pmt::pmt_t meta = pmt::make_dict();
+    meta = pmt::dict_add(meta, PMT_SAMPLE_RATE, pmt::from_double(10e6));
+    meta = pmt::dict_add(meta, PMT_PRF, pmt::from_double(1e3));
+    meta = pmt::dict_add(meta, PMT_NUM_PULSE_CPI, pmt::from_long(128));
+    meta = pmt::dict_add(meta, PMT_SAMPLE_START, pmt::from_uint64(42));
+    meta = pmt::dict_add(meta, pmt::intern("user:label"), pmt::intern("target"));
+    return meta;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_parse)
+{
+    RadarMeta meta = RadarMeta::parse(example_dict());
+
+    BOOST_CHECK(meta.has(RadarMeta::SAMPLE_RATE));
+    BOOST_CHECK(meta.has(RadarMeta::PRF));
+    BOOST_CHECK(not meta.has(RadarMeta::FREQUENCY));
+    BOOST_CHECK_EQUAL(meta.get_double(RadarMeta::SAMPLE_RATE), 10e6);
+    BOOST_CHECK_EQUAL(meta.get_long(RadarMeta::NUM_PULSE_CPI), 128);
+    BOOST_CHECK_EQUAL(meta.get_long(RadarMeta::SAMPLE_START), 42);
+
+    // Keys that aren't typed fields are kept in the extension dictionary
+    BOOST_CHECK(not pmt::dict_has_key(meta.ext(), PMT_PRF));
+    BOOST_CHECK(pmt::eq(meta.ref(pmt::intern("user:label"), pmt::PMT_NIL),
+                        pmt::intern("target")));
+    BOOST_CHECK(pmt::eq(meta.ref(pmt::intern("user:missing"), pmt::PMT_F),
+                        pmt::PMT_F));
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_parse_non_dict)
+{
+    BOOST_CHECK(RadarMeta::parse(pmt::PMT_NIL).empty());
+    BOOST_CHECK(RadarMeta::parse(pmt::from_long(1)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_integer_fields)
+{
+    // A real value can't be stored in an integer field, so it is kept as is
+    RadarMeta meta;
+    meta.add(PMT_NUM_PULSE_CPI, pmt::from_double(1.5));
+    BOOST_CHECK(not meta.has(RadarMeta::NUM_PULSE_CPI));
+    BOOST_CHECK_EQUAL(pmt::to_double(meta.ref(PMT_NUM_PULSE_CPI, pmt::PMT_NIL)), 1.5);
+
+    // Integers are readable as doubles
+    meta.add(PMT_PRF, pmt::from_long(500));
+    BOOST_CHECK_EQUAL(meta.get_double(RadarMeta::PRF), 500);
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_pack_round_trip)
+{
+    RadarMeta meta = RadarMeta::parse(example_dict());
+    pmt::pmt_t packed = meta.pack();
+
+    // The fields are ordinary dictionary keys on the wire
+    BOOST_CHECK(pmt::is_dict(packed));
+    BOOST_CHECK_EQUAL(pmt::to_double(pmt::dict_ref(packed, PMT_PRF, pmt::PMT_NIL)),
+                      1e3);
+    BOOST_CHECK_EQUAL(
+        pmt::to_long(pmt::dict_ref(packed, PMT_NUM_PULSE_CPI, pmt::PMT_NIL)), 128);
+    BOOST_CHECK(pmt::eq(pmt::dict_ref(packed, pmt::intern("user:label"), pmt::PMT_NIL),
+                        pmt::intern("target")));
+
+    RadarMeta copy = RadarMeta::parse(packed);
+    for (int i = 0; i < RadarMeta::NUM_FIELDS; i++) {
+        RadarMeta::Field field = RadarMeta::Field(i);
+        BOOST_CHECK_EQUAL(copy.has(field), meta.has(field));
+        if (meta.has(field)) {
+            BOOST_CHECK_EQUAL(copy.get_double(field), meta.get_double(field));
+            BOOST_CHECK_EQUAL(copy.get_long(field), meta.get_long(field));
+        }
+    }
+    BOOST_CHECK(pmt::eq(copy.ref(pmt::intern("user:label"), pmt::PMT_NIL),
+                        pmt::intern("target")));
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_update)
+{
+    RadarMeta meta = RadarMeta::parse(example_dict());
+    RadarMeta other;
+    other.set_double(RadarMeta::PRF, 2e3);
+    other.set_double(RadarMeta::FREQUENCY, 1e9);
+    other.add(pmt::intern("user:label"), pmt::intern("clutter"));
+    meta.update(other);
+
+    // Fields and extension keys of other overwrite the existing ones, and the rest
+    // are kept
+    BOOST_CHECK_EQUAL(meta.get_double(RadarMeta::PRF), 2e3);
+    BOOST_CHECK_EQUAL(meta.get_double(RadarMeta::FREQUENCY), 1e9);
+    BOOST_CHECK_EQUAL(meta.get_double(RadarMeta::SAMPLE_RATE), 10e6);
+    BOOST_CHECK(pmt::eq(meta.ref(pmt::intern("user:label"), pmt::PMT_NIL),
+                        pmt::intern("clutter")));
+
+    meta.clear();
+    BOOST_CHECK(meta.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_remove)
+{
+    RadarMeta meta = RadarMeta::parse(example_dict());
+    meta.remove(PMT_PRF);
+    meta.remove(pmt::intern("user:label"));
+    meta.remove(pmt::intern("user:missing"));
+
+    BOOST_CHECK(not meta.has(RadarMeta::PRF));
+    BOOST_CHECK(meta.has(RadarMeta::SAMPLE_RATE));
+    pmt::pmt_t packed = meta.pack();
+    BOOST_CHECK(not pmt::dict_has_key(packed, PMT_PRF));
+    BOOST_CHECK(not pmt::dict_has_key(packed, pmt::intern("user:label")));
+    BOOST_CHECK_EQUAL(pmt::length(pmt::dict_keys(packed)), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_meta_later_keys_take_precedence)
+{
+    // Keys added after parsing (e.g., by a processing block) replace the ones that
+    // came in, whether or not they are typed fields
+    RadarMeta meta = RadarMeta::parse(example_dict());
+    meta.add(PMT_PRF, pmt::from_double(4e3));
+    meta.add(pmt::intern("user:label"), pmt::intern("clutter"));
+    pmt::pmt_t packed = meta.pack();
+
+    BOOST_CHECK_EQUAL(pmt::to_double(pmt::dict_ref(packed, PMT_PRF, pmt::PMT_NIL)),
+                      4e3);
+    BOOST_CHECK(pmt::eq(pmt::dict_ref(packed, pmt::intern("user:label"), pmt::PMT_NIL),
+                        pmt::intern("clutter")));
+    BOOST_CHECK_EQUAL(pmt::length(pmt::dict_keys(packed)),
+                      pmt::length(pmt::dict_keys(example_dict())));
+}
+
+} /* namespace plasma */
+} /* namespace gr */
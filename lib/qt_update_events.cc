@@ -2,25 +2,67 @@
 #include <pmt/pmt.h>
 #include <iostream>
 
-RangeDopplerUpdateEvent::RangeDopplerUpdateEvent(const double* data,
+RangeDopplerUpdateEvent::RangeDopplerUpdateEvent(std::vector<float>&& data,
                                                  size_t rows,
                                                  size_t cols,
+                                                 size_t input_rows,
+                                                 size_t input_cols,
+                                                 double zmin,
+                                                 double zmax,
                                                  pmt::pmt_t meta)
-    : QEvent(QEvent::Type(RadarUpdateEventType))
+    : QEvent(QEvent::Type(RadarUpdateEventType)), d_data(std::move(data))
 {
     d_rows = rows;
     d_cols = cols;
-    d_data = new double[rows * cols];
-    memcpy(d_data, data, rows * cols * sizeof(double));
+    d_input_rows = input_rows;
+    d_input_cols = input_cols;
+    d_zmin = zmin;
+    d_zmax = zmax;
     d_meta = meta;
 }
 
-RangeDopplerUpdateEvent::~RangeDopplerUpdateEvent() { delete[] d_data; }
+RangeDopplerUpdateEvent::~RangeDopplerUpdateEvent() {}
 
 const size_t RangeDopplerUpdateEvent::cols() { return d_cols; }
 
 const size_t RangeDopplerUpdateEvent::rows() { return d_rows; }
 
-double* RangeDopplerUpdateEvent::data() { return d_data; }
+const size_t RangeDopplerUpdateEvent::input_cols() { return d_input_cols; }
 
-const pmt::pmt_t RangeDopplerUpdateEvent::meta() { return d_meta; }
\ No newline at end of file
+const size_t RangeDopplerUpdateEvent::input_rows() { return d_input_rows; }
+
+double RangeDopplerUpdateEvent::zmin() const { return d_zmin; }
+
+double RangeDopplerUpdateEvent::zmax() const { return d_zmax; }
+
+std::vector<float>& RangeDopplerUpdateEvent::data() { return d_data; }
+
+const pmt::pmt_t RangeDopplerUpdateEvent::meta() { return d_meta; }
+
+WaterfallUpdateEvent::WaterfallUpdateEvent(std::vector<float>&& row,
+                                           int mode,
+                                           size_t history,
+                                           double zmin,
+                                           double zmax,
+                                           pmt::pmt_t meta)
+    : QEvent(QEvent::Type(WaterfallUpdateEventType)),
+      d_row(std::move(row)),
+      d_mode(mode),
+      d_history(history),
+      d_zmin(zmin),
+      d_zmax(zmax),
+      d_meta(meta)
+{
+}
+
+std::vector<float>& WaterfallUpdateEvent::row() { return d_row; }
+
+int WaterfallUpdateEvent::mode() const { return d_mode; }
+
+size_t WaterfallUpdateEvent::history() const { return d_history; }
+
+double WaterfallUpdateEvent::zmin() const { return d_zmin; }
+
+double WaterfallUpdateEvent::zmax() const { return d_zmax; }
+
+const pmt::pmt_t WaterfallUpdateEvent::meta() { return d_meta; }
\ No newline at end of file
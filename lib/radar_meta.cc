@@ -0,0 +1,165 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "radar_meta.h"
+#include <gnuradio/plasma/pmt_constants.h>
+
+namespace gr {
+namespace plasma {
+
+RadarMeta::RadarMeta() : d_present(0), d_real{}, d_int{}, d_ext(pmt::make_dict()) {}
+
+pmt::pmt_t RadarMeta::key(Field field)
+{
+    static const std::array<pmt::pmt_t, NUM_FIELDS> keys = { PMT_SAMPLE_RATE,
+                                                            PMT_FREQUENCY,
+                                                            PMT_SAMPLE_START,
+                                                            PMT_BANDWIDTH,
+                                                            PMT_DURATION,
+                                                            PMT_PRF,
+                                                            PMT_NUM_PULSE_CPI,
+                                                            PMT_DOPPLER_FFT_SIZE,
+                                                            PMT_RANGE_GATE_START,
+                                                            PMT_RANGE_GATE_STOP };
+    return keys[field];
+}
+
+bool RadarMeta::is_integer_field(Field field)
+{
+    switch (field) {
+    case SAMPLE_START:
+    case NUM_PULSE_CPI:
+    case DOPPLER_FFT_SIZE:
+    case RANGE_GATE_START:
+    case RANGE_GATE_STOP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool RadarMeta::find_field(const pmt::pmt_t& key, Field& field)
+{
+    // Keys are interned symbols, so this is a handful of pointer comparisons
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        if (pmt::eq(key, RadarMeta::key(Field(i)))) {
+            field = Field(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+RadarMeta RadarMeta::parse(const pmt::pmt_t& meta)
+{
+    RadarMeta out;
+    if (not pmt::is_dict(meta))
+        return out;
+
+    // Walk the association list once. The keys of a dictionary are unique, so the
+    // extension keys can be consed on without searching for duplicates.
+    for (pmt::pmt_t p = meta; pmt::is_pair(p); p = pmt::cdr(p)) {
+        pmt::pmt_t item = pmt::car(p);
+        if (not pmt::is_pair(item))
+            break;
+        if (not out.add_field(pmt::car(item), pmt::cdr(item)))
+            out.d_ext = pmt::cons(item, out.d_ext);
+    }
+    return out;
+}
+
+pmt::pmt_t RadarMeta::pack() const
+{
+    pmt::pmt_t meta = d_ext;
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        if (has(Field(i)))
+            meta = pmt::dict_add(meta, key(Field(i)), value(Field(i)));
+    }
+    return meta;
+}
+
+void RadarMeta::update(const RadarMeta& other)
+{
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        if (other.has(Field(i))) {
+            d_real[i] = other.d_real[i];
+            d_int[i] = other.d_int[i];
+        }
+    }
+    d_present |= other.d_present;
+    if (pmt::is_null(d_ext))
+        d_ext = other.d_ext;
+    else if (not pmt::is_null(other.d_ext))
+        d_ext = pmt::dict_update(d_ext, other.d_ext);
+}
+
+void RadarMeta::clear()
+{
+    d_present = 0;
+    d_ext = pmt::make_dict();
+}
+
+void RadarMeta::set_double(Field field, double value)
+{
+    d_real[field] = value;
+    d_present |= 1u << field;
+}
+
+void RadarMeta::set_long(Field field, int64_t value)
+{
+    d_int[field] = value;
+    d_real[field] = value;
+    d_present |= 1u << field;
+}
+
+pmt::pmt_t RadarMeta::ref(const pmt::pmt_t& key, const pmt::pmt_t& not_found) const
+{
+    Field field;
+    if (find_field(key, field) and has(field))
+        return value(field);
+    return pmt::dict_ref(d_ext, key, not_found);
+}
+
+void RadarMeta::add(const pmt::pmt_t& key, const pmt::pmt_t& value)
+{
+    if (not add_field(key, value))
+        d_ext = pmt::dict_add(d_ext, key, value);
+}
+
+void RadarMeta::remove(const pmt::pmt_t& key)
+{
+    Field field;
+    if (find_field(key, field))
+        d_present &= ~(1u << field);
+    d_ext = pmt::dict_delete(d_ext, key);
+}
+
+bool RadarMeta::add_field(const pmt::pmt_t& key, const pmt::pmt_t& value)
+{
+    Field field;
+    if (not find_field(key, field))
+        return false;
+    if (pmt::is_integer(value))
+        set_long(field, pmt::to_long(value));
+    else if (pmt::is_uint64(value))
+        set_long(field, pmt::to_uint64(value));
+    else if (pmt::is_real(value) and not is_integer_field(field))
+        set_double(field, pmt::to_double(value));
+    else
+        return false;
+    return true;
+}
+
+pmt::pmt_t RadarMeta::value(Field field) const
+{
+    if (is_integer_field(field))
+        return pmt::from_long(d_int[field]);
+    return pmt::from_double(d_real[field]);
+}
+
+} // namespace plasma
+} // namespace gr
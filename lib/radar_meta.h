@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_RADAR_META_H
+#define INCLUDED_PLASMA_RADAR_META_H
+
+#include <pmt/pmt.h>
+#include <array>
+#include <cstdint>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief Typed metadata for the SigMF and radar fields that every processing block
+ * carries.
+ *
+ * Each field is stored at a fixed offset, with a bitmap recording which fields are
+ * present, so reading or merging them doesn't search (or copy) an association list.
+ * Any other keys are kept in an extension dictionary.
+ *
+ * Between blocks, the fields travel as ordinary dictionary keys (see pack()), so
+ * message_debug, ZMQ serialization and Python code can read them.
+ */
+class RadarMeta
+{
+public:
+    enum Field {
+        SAMPLE_RATE,
+        FREQUENCY,
+        SAMPLE_START,
+        BANDWIDTH,
+        DURATION,
+        PRF,
+        NUM_PULSE_CPI,
+        DOPPLER_FFT_SIZE,
+        RANGE_GATE_START,
+        RANGE_GATE_STOP,
+        NUM_FIELDS
+    };
+
+    RadarMeta();
+
+    /**
+     * @brief Parse a metadata dictionary
+     *
+     * Anything that isn't a dictionary (e.g., PMT_NIL) gives empty metadata.
+     */
+    static RadarMeta parse(const pmt::pmt_t& meta);
+
+    /**
+     * @brief Dictionary key of a field
+     */
+    static pmt::pmt_t key(Field field);
+
+    /**
+     * @brief Metadata dictionary with the extension keys and one key per field
+     */
+    pmt::pmt_t pack() const;
+
+    /**
+     * @brief Overwrite fields with those present in other
+     */
+    void update(const RadarMeta& other);
+
+    /**
+     * @brief Remove every field
+     */
+    void clear();
+
+    bool empty() const { return d_present == 0 and pmt::is_null(d_ext); }
+    bool has(Field field) const { return d_present & (1u << field); }
+
+    // Integer fields (sample start, pulses per CPI, FFT size, and range gates) are
+    // read with get_long() and set with set_long(). Either getter works for the rest.
+    double get_double(Field field) const { return d_real[field]; }
+    int64_t get_long(Field field) const { return d_int[field]; }
+    void set_double(Field field, double value);
+    void set_long(Field field, int64_t value);
+
+    /**
+     * @brief Look up a value by key, whether or not it is a typed field
+     */
+    pmt::pmt_t ref(const pmt::pmt_t& key, const pmt::pmt_t& not_found) const;
+
+    /**
+     * @brief Add a value by key. Known keys with numeric values are stored as typed
+     * fields, and everything else goes in the extension dictionary.
+     */
+    void add(const pmt::pmt_t& key, const pmt::pmt_t& value);
+
+    /**
+     * @brief Remove a value by key, whether or not it is a typed field
+     */
+    void remove(const pmt::pmt_t& key);
+
+    /**
+     * @brief Extension dictionary holding the keys that aren't typed fields
+     */
+    const pmt::pmt_t& ext() const { return d_ext; }
+
+private:
+    uint32_t d_present;
+    std::array<double, NUM_FIELDS> d_real;
+    std::array<int64_t, NUM_FIELDS> d_int;
+    pmt::pmt_t d_ext;
+
+    static bool is_integer_field(Field field);
+    static bool find_field(const pmt::pmt_t& key, Field& field);
+    bool add_field(const pmt::pmt_t& key, const pmt::pmt_t& value);
+    pmt::pmt_t value(Field field) const;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_RADAR_META_H */
@@ -6,13 +6,49 @@
  */
 
 #include "range_doppler_sink_impl.h"
+#include "latency_trace.h"
 #include <gnuradio/io_signature.h>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <thread>
 
 namespace gr {
 namespace plasma {
 
+namespace {
+/**
+ * @brief Reduce a (non-negative) 2D array to at most rows x cols by taking the maximum
+ * over blocks of adjacent cells
+ */
+af::array max_pool(const af::array& x, size_t rows, size_t cols)
+{
+    size_t nrow = x.dims(0);
+    size_t ncol = x.dims(1);
+    size_t row_factor = rows > 0 ? (nrow + rows - 1) / rows : 1;
+    size_t col_factor = cols > 0 ? (ncol + cols - 1) / cols : 1;
+    if (row_factor <= 1 and col_factor <= 1)
+        return x;
+
+    // Zero-pad so that each dimension is a multiple of its pooling factor
+    size_t out_rows = (nrow + row_factor - 1) / row_factor;
+    size_t out_cols = (ncol + col_factor - 1) / col_factor;
+    af::array y = x;
+    if (out_rows * row_factor != nrow or out_cols * col_factor != ncol) {
+        y = af::constant(0, out_rows * row_factor, out_cols * col_factor, x.type());
+        y(af::seq(nrow), af::seq(ncol)) = x;
+    }
+    y = af::max(af::moddims(y, row_factor, out_rows, out_cols * col_factor), 0);
+    y = af::max(af::moddims(y, out_rows, col_factor, out_cols), 1);
+    return af::moddims(y, out_rows, out_cols);
+}
+
+// Maximum length of a waterfall row. Unlike maps, rows are not decimated to the current
+// display size, so that the history is kept when the window is resized.
+const size_t max_waterfall_bins = 1024;
+} // namespace
+
 
 range_doppler_sink::sptr range_doppler_sink::make(double samp_rate,
                                                   size_t ncol,
@@ -36,8 +72,12 @@ range_doppler_sink_impl::range_doppler_sink_impl(double samp_rate,
                 gr::io_signature::make(0, 0, 0)),
       d_samp_rate(samp_rate),
       d_ncol(ncol),
-      d_center_freq(center_freq)
-
+      d_center_freq(center_freq),
+      d_display_mode(RANGE_DOPPLER),
+      d_history(256),
+      d_waterfall_ref_db(-std::numeric_limits<float>::infinity()),
+      d_waterfall_ref_mode(RANGE_DOPPLER),
+      d_latency_tracing(false)
 {
     // Initialize the QApplication
     d_argc = 1;
@@ -51,7 +91,9 @@ range_doppler_sink_impl::range_doppler_sink_impl(double samp_rate,
 
     // Initialize message ports
     d_in_port = PMT_IN;
+    d_trace_port = PMT_TRACE;
     message_port_register_in(d_in_port);
+    message_port_register_out(d_trace_port);
     set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_rx_msg(msg); });
 }
 
@@ -92,7 +134,13 @@ void* range_doppler_sink_impl::pyqwidget() { return nullptr; }
 
 void range_doppler_sink_impl::handle_rx_msg(pmt::pmt_t msg)
 {
-    if (d_main_gui->busy() or this->nmsgs(d_in_port) > d_msg_queue_depth) {
+    uint64_t entry_ns = latency_now_ns();
+    // Updates that arrive while the GUI is still drawing are discarded
+    if (d_main_gui->busy()) {
+        d_admission.record_drop();
+        return;
+    }
+    if (not d_admission.admit(this, d_in_port, msg)) {
         return;
     }
     pmt::pmt_t samples;
@@ -102,17 +150,78 @@ void range_doppler_sink_impl::handle_rx_msg(pmt::pmt_t msg)
     }
     size_t n = pmt::length(samples);
     size_t nrow = n / d_ncol;
-    const gr_complex* in = pmt::c32vector_elements(samples, n);
-
-    // convert the input data to dB, normalize, and set the dynamic range
-    af::array plot_data(af::dim4(nrow, d_ncol), reinterpret_cast<const af::cfloat*>(in));
-    plot_data = 20 * log10(abs(plot_data));
-    plot_data -= af::tile(af::max(af::flat(plot_data)), nrow, d_ncol);
-    plot_data = af::clamp(plot_data, -d_dynamic_range_db, 0);
-    plot_data = plot_data.T();
-    double* out = plot_data.as(f64).host<double>();
-    d_qapp->postEvent(d_main_gui, new RangeDopplerUpdateEvent(out, nrow, d_ncol, d_meta));
-    delete[] out;
+    af::array mag;
+    if (pmt::is_f32vector(samples)) {
+        // Power from noncoherent_integrator
+        const float* in = pmt::f32vector_elements(samples, n);
+        mag = af::sqrt(af::array(af::dim4(nrow, d_ncol), in));
+    } else {
+        const gr_complex* in = pmt::c32vector_elements(samples, n);
+        mag = af::abs(
+            af::array(af::dim4(nrow, d_ncol), reinterpret_cast<const af::cfloat*>(in)));
+    }
+    DisplayMode mode = d_display_mode;
+    if (mode != RANGE_DOPPLER) {
+        // Reduce the CPI to a single waterfall row holding the peak over doppler (RTI)
+        // or over range
+        af::array row = mode == RANGE_TIME ? af::max(mag, 1) : af::flat(af::max(mag, 0));
+        row = max_pool(row, max_waterfall_bins, 1);
+        row = 20 * af::log10(row);
+        // Normalizing each row to its own peak would hide fading targets and raise
+        // noise-only CPIs to 0 dB. Instead, the reference is the running peak, which
+        // decays by the dynamic range over the length of the history.
+        if (mode != d_waterfall_ref_mode) {
+            d_waterfall_ref_db = -std::numeric_limits<float>::infinity();
+            d_waterfall_ref_mode = mode;
+        }
+        float decay = d_dynamic_range_db / d_history;
+        d_waterfall_ref_db = std::max(af::max<float>(row), d_waterfall_ref_db - decay);
+        if (std::isfinite(d_waterfall_ref_db))
+            row -= d_waterfall_ref_db;
+        row = af::clamp(row, -d_dynamic_range_db, 0);
+
+        std::vector<float> out(row.elements());
+        row.host(out.data());
+        d_qapp->postEvent(d_main_gui,
+                          new WaterfallUpdateEvent(std::move(out),
+                                                   mode,
+                                                   d_history,
+                                                   -d_dynamic_range_db,
+                                                   0,
+                                                   d_meta));
+    } else {
+        // Decimate the map to the display resolution before the GUI handoff. The
+        // magnitude is max-pooled so that peaks survive, and the dB conversion is
+        // applied afterwards
+        af::array plot_data =
+            max_pool(mag, d_main_gui->display_rows(), d_main_gui->display_cols());
+        // convert the input data to dB, normalize, and set the dynamic range
+        plot_data = 20 * af::log10(plot_data);
+        plot_data -= af::max<float>(plot_data);
+        plot_data = af::clamp(plot_data, -d_dynamic_range_db, 0);
+
+        // The window stores the map in row-major order
+        size_t rows = plot_data.dims(0);
+        size_t cols = plot_data.dims(1);
+        std::vector<float> out(rows * cols);
+        plot_data.T().host(out.data());
+        // Compute the color scale limits here so the GUI thread only has to render
+        double zmin(0), zmax(0);
+        if (not out.empty()) {
+            auto [min, max] = std::minmax_element(out.begin(), out.end());
+            zmin = *min;
+            zmax = *max;
+        }
+        d_qapp->postEvent(
+            d_main_gui,
+            new RangeDopplerUpdateEvent(
+                std::move(out), rows, cols, nrow, d_ncol, zmin, zmax, d_meta));
+    }
+
+    if (d_latency_tracing) {
+        message_port_pub(d_trace_port,
+                         latency_stamp(d_meta, alias(), entry_ns, latency_now_ns()));
+    }
 }
 
 
@@ -121,11 +230,25 @@ void range_doppler_sink_impl::set_dynamic_range(const double r)
     d_dynamic_range_db = r;
 }
 
+void range_doppler_sink_impl::set_display_mode(DisplayMode mode, size_t history)
+{
+    d_display_mode = mode;
+    d_history = std::max<size_t>(history, 1);
+}
+
 void range_doppler_sink_impl::set_msg_queue_depth(size_t depth)
 {
-    d_msg_queue_depth = depth;
+    d_admission.set_queue_depth(depth);
 }
 
+void range_doppler_sink_impl::set_admission_policy(AdmissionControl::Policy policy, double max_rate)
+{
+    d_admission.set_policy(policy);
+    d_admission.set_max_rate(max_rate);
+}
+
+uint64_t range_doppler_sink_impl::num_dropped() { return d_admission.num_dropped(); }
+
 void range_doppler_sink_impl::set_metadata_keys(std::string samp_rate_key,
                                                 std::string n_matrix_col_key,
                                                 std::string center_freq_key,
@@ -142,5 +265,10 @@ void range_doppler_sink_impl::set_metadata_keys(std::string samp_rate_key,
     d_main_gui->set_metadata_keys(prf_key, pulsewidth_key, samp_rate_key, center_freq_key, detection_indices_key);
 }
 
+void range_doppler_sink_impl::set_latency_tracing(bool enable)
+{
+    d_latency_tracing = enable;
+}
+
 } /* namespace plasma */
 } /* namespace gr */
\ No newline at end of file
@@ -24,6 +24,12 @@ private:
     size_t d_ncol;
     double d_center_freq;
     double d_dynamic_range_db;
+    std::atomic<DisplayMode> d_display_mode;
+    std::atomic<size_t> d_history;
+    // Waterfall rows are normalized to a running peak (dB) that decays slowly, so
+    // rows keep their intensity relative to each other
+    float d_waterfall_ref_db;
+    DisplayMode d_waterfall_ref_mode;
     // GUI parameters
     int d_argc;
     char* d_argv;
@@ -31,7 +37,9 @@ private:
 
     std::atomic<bool> d_finished;
     pmt::pmt_t d_in_port;
-    size_t d_msg_queue_depth;
+    pmt::pmt_t d_trace_port;
+    bool d_latency_tracing;
+    AdmissionControl d_admission;
 
     pmt::pmt_t d_meta;
     // Metadata keys
@@ -62,7 +70,12 @@ public:
     void handle_rx_msg(pmt::pmt_t msg);
 
     void set_dynamic_range(const double) override;
+    void set_display_mode(DisplayMode mode, size_t history) override;
     void set_msg_queue_depth(size_t) override;
+    void set_admission_policy(AdmissionControl::Policy policy,
+                              double max_rate) override;
+    uint64_t num_dropped() override;
+    void set_latency_tracing(bool enable) override;
     void set_metadata_keys(std::string samp_rate_key,
                            std::string n_matrix_col_key,
                            std::string center_freq_key,
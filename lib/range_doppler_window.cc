@@ -1,4 +1,8 @@
 #include "range_doppler_window.h"
+#include <QPainter>
+#include <QResizeEvent>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 class ColorMap : public QwtLinearColorMap
@@ -29,6 +33,179 @@ public:
     }
 };
 
+ColorMappedItem::ColorMappedItem() : QwtPlotItem()
+{
+    setItemAttribute(QwtPlotItem::AutoScale, true);
+    setZ(8);
+}
+
+void ColorMappedItem::setColorMap(const QwtColorMap& colorMap)
+{
+    const QwtInterval lut_interval(0, 255);
+    d_lut.resize(256);
+    for (int i = 0; i < d_lut.size(); i++)
+        d_lut[i] = colorMap.rgb(lut_interval, i);
+    itemChanged();
+}
+
+void ColorMappedItem::setInterval(Qt::Axis axis, const QwtInterval& interval)
+{
+    d_intervals[axis] = interval;
+    itemChanged();
+}
+
+QwtInterval ColorMappedItem::interval(Qt::Axis axis) const { return d_intervals[axis]; }
+
+void ColorMappedItem::colorize(const float* in, int n, QRgb* out) const
+{
+    if (d_lut.isEmpty())
+        return;
+    const QwtInterval& z = d_intervals[Qt::ZAxis];
+    const float zmin = z.minValue();
+    const float imax = d_lut.size() - 1;
+    const float scale = z.width() > 0 ? imax / z.width() : 0;
+    const QRgb* lut = d_lut.constData();
+
+    // Quantize to colormap indices. Written without branches so the loop vectorizes,
+    // and NaNs map to the bottom of the scale.
+    d_indices.resize(n);
+    for (int i = 0; i < n; i++) {
+        float t = (in[i] - zmin) * scale;
+        t = t > 0 ? t : 0;
+        t = t < imax ? t : imax;
+        d_indices[i] = static_cast<uint8_t>(t + 0.5f);
+    }
+    for (int i = 0; i < n; i++)
+        out[i] = lut[d_indices[i]];
+}
+
+RangeDopplerImage::RangeDopplerImage()
+    : ColorMappedItem(), d_num_rows(0), d_num_columns(0), d_dirty(false)
+{
+}
+
+void RangeDopplerImage::setInterval(Qt::Axis axis, const QwtInterval& interval)
+{
+    if (axis == Qt::ZAxis)
+        d_dirty = true;
+    ColorMappedItem::setInterval(axis, interval);
+}
+
+void RangeDopplerImage::setValueMatrix(std::vector<float>&& values, int numColumns)
+{
+    d_values = std::move(values);
+    d_num_columns = numColumns;
+    d_num_rows = numColumns > 0 ? d_values.size() / numColumns : 0;
+    d_dirty = true;
+    itemChanged();
+}
+
+QRectF RangeDopplerImage::boundingRect() const
+{
+    const QwtInterval& x = d_intervals[Qt::XAxis];
+    const QwtInterval& y = d_intervals[Qt::YAxis];
+    if (not x.isValid() or not y.isValid())
+        return QwtPlotItem::boundingRect();
+    return QRectF(x.minValue(), y.minValue(), x.width(), y.width());
+}
+
+void RangeDopplerImage::draw(QPainter* painter,
+                             const QwtScaleMap& xMap,
+                             const QwtScaleMap& yMap,
+                             const QRectF& canvasRect) const
+{
+    // The image is only rendered when the map or z interval changes
+    if (d_dirty)
+        render();
+    QRectF rect = boundingRect();
+    if (d_image.isNull() or not rect.isValid())
+        return;
+    rect = QwtScaleMap::transform(xMap, yMap, rect).normalized();
+
+    painter->save();
+    // Nearest-neighbor scaling keeps the pooled peaks sharp
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(rect, d_image);
+    painter->restore();
+}
+
+void RangeDopplerImage::render() const
+{
+    d_dirty = false;
+    if (d_values.empty() or d_lut.isEmpty())
+        return;
+    if (d_image.width() != d_num_columns or d_image.height() != d_num_rows)
+        d_image = QImage(d_num_columns, d_num_rows, QImage::Format_RGB32);
+
+    for (int row = 0; row < d_num_rows; row++) {
+        // Image rows run top to bottom, while the map rows run bottom to top
+        colorize(d_values.data() + row * d_num_columns,
+                 d_num_columns,
+                 reinterpret_cast<QRgb*>(d_image.scanLine(d_num_rows - 1 - row)));
+    }
+}
+
+WaterfallImage::WaterfallImage() : ColorMappedItem(), d_head(0) {}
+
+void WaterfallImage::append(const std::vector<float>& row, size_t history)
+{
+    if (row.empty() or history == 0 or d_lut.isEmpty())
+        return;
+    if (d_image.width() != (int)row.size() or d_image.height() != (int)history) {
+        d_image = QImage(row.size(), history, QImage::Format_RGB32);
+        clear();
+    }
+    colorize(row.data(), row.size(), reinterpret_cast<QRgb*>(d_image.scanLine(d_head)));
+    d_head = (d_head + d_image.height() - 1) % d_image.height();
+    itemChanged();
+}
+
+void WaterfallImage::clear()
+{
+    if (not d_lut.isEmpty())
+        d_image.fill(d_lut.front());
+    d_head = d_image.height() - 1;
+    itemChanged();
+}
+
+QRectF WaterfallImage::boundingRect() const
+{
+    if (d_image.isNull())
+        return QwtPlotItem::boundingRect();
+    QwtInterval x = d_intervals[Qt::XAxis];
+    QwtInterval y = d_intervals[Qt::YAxis];
+    if (not x.isValid())
+        x = QwtInterval(0, d_image.width());
+    if (not y.isValid())
+        y = QwtInterval(-d_image.height(), 0);
+    return QRectF(x.minValue(), y.minValue(), x.width(), y.width());
+}
+
+void WaterfallImage::draw(QPainter* painter,
+                          const QwtScaleMap& xMap,
+                          const QwtScaleMap& yMap,
+                          const QRectF& canvasRect) const
+{
+    if (d_image.isNull())
+        return;
+    QRectF rect = QwtScaleMap::transform(xMap, yMap, boundingRect()).normalized();
+
+    // The newest row is on the line after the head. Draw from there to the end of the
+    // image at the top of the plot, then the start of the image below it
+    int height = d_image.height();
+    int newest = (d_head + 1) % height;
+    double line_height = rect.height() / height;
+    QRectF top(rect.left(), rect.top(), rect.width(), (height - newest) * line_height);
+    QRectF bottom(rect.left(), top.bottom(), rect.width(), newest * line_height);
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(top, d_image, QRectF(0, newest, d_image.width(), height - newest));
+    if (newest > 0)
+        painter->drawImage(bottom, d_image, QRectF(0, 0, d_image.width(), newest));
+    painter->restore();
+}
+
 RangeDopplerWindow::RangeDopplerWindow(QWidget* parent,
                                        double samp_rate,
                                        double center_freq)
@@ -49,10 +226,14 @@ RangeDopplerWindow::RangeDopplerWindow(QWidget* parent,
 
     // Spectrogram
     d_plot = new QwtPlot();
-    d_spectro = new QwtPlotSpectrogram();
-    d_spectro->setColorMap(new ColorMap());
-    d_spectro->attach(d_plot);
-    d_data = new RangeDopplerData();
+    d_image = new RangeDopplerImage();
+    d_image->setColorMap(ColorMap());
+    d_image->attach(d_plot);
+    d_waterfall = new WaterfallImage();
+    d_waterfall->setColorMap(ColorMap());
+    d_waterfall->setVisible(false);
+    d_waterfall->attach(d_plot);
+    d_mode = gr::plasma::range_doppler_sink::RANGE_DOPPLER;
     d_plot->setAutoReplot(true);
 
     // Colorbar setup
@@ -73,6 +254,8 @@ RangeDopplerWindow::RangeDopplerWindow(QWidget* parent,
     d_panner = new QwtPlotPanner(d_plot->canvas());
     d_panner->setAxisEnabled(QwtPlot::yRight, false);
     d_panner->setMouseButton(Qt::MiddleButton);
+    // Track the canvas size to set the display resolution
+    d_plot->canvas()->installEventFilter(this);
 
     // GUI layout
     v_layout = new QVBoxLayout();
@@ -85,6 +268,12 @@ RangeDopplerWindow::RangeDopplerWindow(QWidget* parent,
     d_busy = false;
     d_prf = 0;
     d_pulsewidth = 0;
+    d_range_gated = false;
+    d_range_gate_start = 0;
+    d_range_gate_stop = 0;
+    // Used until the canvas is first laid out
+    d_display_rows = 1024;
+    d_display_cols = 1024;
 }
 
 RangeDopplerWindow::~RangeDopplerWindow() { d_closed = true; }
@@ -93,14 +282,21 @@ bool RangeDopplerWindow::is_closed() const { return d_closed; }
 
 bool RangeDopplerWindow::busy() const { return d_busy; }
 
+size_t RangeDopplerWindow::display_rows() const { return d_display_rows; }
+
+size_t RangeDopplerWindow::display_cols() const { return d_display_cols; }
+
 void RangeDopplerWindow::xlim(double x1, double x2)
 {
-    d_data->setInterval(Qt::XAxis, QwtInterval(x1, x2));
+    if (d_mode == gr::plasma::range_doppler_sink::RANGE_DOPPLER)
+        d_image->setInterval(Qt::XAxis, QwtInterval(x1, x2));
+    else
+        d_waterfall->setInterval(Qt::XAxis, QwtInterval(x1, x2));
 }
 
 void RangeDopplerWindow::ylim(double y1, double y2)
 {
-    d_data->setInterval(Qt::YAxis, QwtInterval(y1, y2));
+    d_image->setInterval(Qt::YAxis, QwtInterval(y1, y2));
 }
 
 
@@ -132,70 +328,134 @@ void RangeDopplerWindow::customEvent(QEvent* e)
     if (e->type() == RangeDopplerUpdateEvent::Type()) {
 
         RangeDopplerUpdateEvent* event = (RangeDopplerUpdateEvent*)e;
-        double* data = event->data();
-        auto rows = event->rows();
-        auto cols = event->cols();
-
-
-        // Create a new vector
-        QVector<double> vec(rows * cols);
-        std::copy(data, data + vec.size(), vec.data());
-        // Also map the vector to an array to easily compute the minimum
-        // and maximum values
-        af::array tmp(vec.size(), f64);
-        tmp.write(vec.data(), sizeof(double) * vec.size());
-        d_data->setInterval(Qt::ZAxis,
-                            QwtInterval(af::min<double>(tmp), af::max<double>(tmp)));
-        d_data->setValueMatrix(vec, cols);
-        d_spectro->setData(d_data);
-
-
-        const QwtInterval zInterval = d_spectro->data()->interval(Qt::ZAxis);
-        QwtScaleWidget* rightAxis = d_plot->axisWidget(QwtPlot::yRight);
-        rightAxis->setColorMap(zInterval, new ColorMap());
-        d_plot->setAxisScale(QwtPlot::yRight, zInterval.minValue(), zInterval.maxValue());
-
+        set_display_mode(gr::plasma::range_doppler_sink::RANGE_DOPPLER);
+        d_image->setInterval(Qt::ZAxis, QwtInterval(event->zmin(), event->zmax()));
+        d_image->setValueMatrix(std::move(event->data()), event->cols());
+        set_color_scale(d_image->interval(Qt::ZAxis));
 
         // Parse the input metadata
         pmt::pmt_t meta = event->meta();
-        d_prf = pmt::to_double(pmt::dict_ref(meta, d_prf_key, pmt::from_double(d_prf)));
-        d_pulsewidth = pmt::to_double(
-            pmt::dict_ref(meta, d_pulsewidth_key, pmt::from_double(d_pulsewidth)));
-        d_samp_rate = pmt::to_double(
-            pmt::dict_ref(meta, d_samp_rate_key, pmt::from_double(d_samp_rate)));
-        d_center_freq = pmt::to_double(
-            pmt::dict_ref(meta, d_center_freq_key, pmt::from_double(d_center_freq)));
+        parse_metadata(meta);
 
         // If the metadata exists,
         set_range_axis();
         set_velocity_axis();
 
 
-        // CFAR plotting
+        // CFAR plotting, at the interpolated locations from a detection_refiner if
+        // there are any
         pmt::pmt_t indices = pmt::dict_ref(meta, d_detection_indices_key, pmt::PMT_NIL);
-        if (not pmt::is_null(indices)) {
-          plot_detections(indices, rows, cols);
+        if (pmt::dict_has_key(meta, PMT_DETECTION_RANGE)) {
+            plot_refined_detections(meta);
+        } else if (not pmt::is_null(indices)) {
+          plot_detections(indices, event->input_rows(), event->input_cols());
         }
 
-        d_zoomer->setZoomBase(d_spectro->boundingRect());
+        d_zoomer->setZoomBase(d_image->boundingRect());
+        d_plot->replot();
+    } else if (e->type() == WaterfallUpdateEvent::Type()) {
+
+        WaterfallUpdateEvent* event = (WaterfallUpdateEvent*)e;
+        set_display_mode(event->mode());
+        d_waterfall->setInterval(Qt::ZAxis, QwtInterval(event->zmin(), event->zmax()));
+        d_waterfall->setInterval(Qt::YAxis, QwtInterval(-(double)event->history(), 0));
+        d_waterfall->append(event->row(), event->history());
+        set_color_scale(d_waterfall->interval(Qt::ZAxis));
+
+        parse_metadata(event->meta());
+        if (d_mode == gr::plasma::range_doppler_sink::RANGE_TIME)
+            set_range_axis();
+        else
+            set_velocity_axis();
+
+        d_zoomer->setZoomBase(d_waterfall->boundingRect());
         d_plot->replot();
     }
     d_busy = false;
 }
 
+void RangeDopplerWindow::set_display_mode(int mode)
+{
+    if (mode == d_mode)
+        return;
+    d_mode = mode;
+    bool waterfall = mode != gr::plasma::range_doppler_sink::RANGE_DOPPLER;
+    d_image->setVisible(not waterfall);
+    d_curve->setVisible(not waterfall);
+    d_checkBox->setEnabled(not waterfall);
+    d_waterfall->setVisible(waterfall);
+    d_waterfall->clear();
+    // The x axis of a waterfall is reset from the metadata of its first row
+    d_waterfall->setInterval(Qt::XAxis, QwtInterval());
+
+    QwtScaleWidget* y = d_plot->axisWidget(QwtPlot::yLeft);
+    QwtScaleWidget* x = d_plot->axisWidget(QwtPlot::xBottom);
+    y->setTitle(waterfall ? "Time (CPIs)" : "");
+    x->setTitle("");
+}
+
+void RangeDopplerWindow::set_color_scale(const QwtInterval& zInterval)
+{
+    QwtScaleWidget* rightAxis = d_plot->axisWidget(QwtPlot::yRight);
+    rightAxis->setColorMap(zInterval, new ColorMap());
+    d_plot->setAxisScale(QwtPlot::yRight, zInterval.minValue(), zInterval.maxValue());
+}
+
+void RangeDopplerWindow::parse_metadata(const pmt::pmt_t& meta)
+{
+    d_prf = pmt::to_double(pmt::dict_ref(meta, d_prf_key, pmt::from_double(d_prf)));
+    d_pulsewidth = pmt::to_double(
+        pmt::dict_ref(meta, d_pulsewidth_key, pmt::from_double(d_pulsewidth)));
+    d_samp_rate = pmt::to_double(
+        pmt::dict_ref(meta, d_samp_rate_key, pmt::from_double(d_samp_rate)));
+    d_center_freq = pmt::to_double(
+        pmt::dict_ref(meta, d_center_freq_key, pmt::from_double(d_center_freq)));
+    // Range gated blocks tag every CPI, so a map without the tag covers every range
+    d_range_gated = pmt::dict_has_key(meta, PMT_RANGE_GATE_START);
+    if (d_range_gated) {
+        d_range_gate_start =
+            pmt::to_long(pmt::dict_ref(meta, PMT_RANGE_GATE_START, pmt::PMT_NIL));
+        d_range_gate_stop =
+            pmt::to_long(pmt::dict_ref(meta, PMT_RANGE_GATE_STOP, pmt::PMT_NIL));
+    }
+}
+
+bool RangeDopplerWindow::eventFilter(QObject* obj, QEvent* e)
+{
+    if (obj == d_plot->canvas() and e->type() == QEvent::Resize) {
+        QSize size = static_cast<QResizeEvent*>(e)->size();
+        d_display_rows = std::max(size.height(), 1);
+        d_display_cols = std::max(size.width(), 1);
+    }
+    return QWidget::eventFilter(obj, e);
+}
+
 void RangeDopplerWindow::set_range_axis()
 {
-    if (d_prf == 0 or d_pulsewidth == 0 or d_samp_rate == 0) {
+    const double c = ::plasma::physconst::c;
+    if (d_range_gated and d_samp_rate != 0) {
+        // Range gated data: the limits are given directly by the gate delays
+        double rmin = (c / 2) * d_range_gate_start / d_samp_rate;
+        double rmax = (c / 2) * d_range_gate_stop / d_samp_rate;
+        set_range_limits(rmin, rmax);
+    } else if (d_prf == 0 or d_pulsewidth == 0 or d_samp_rate == 0) {
         return;
     } else {
-        const double c = ::plasma::physconst::c;
         double rmin = -(c / 2) * d_pulsewidth;
         double rmax = (c / 2) * (1 / d_prf);
+        set_range_limits(rmin, rmax);
+    }
+}
+
+void RangeDopplerWindow::set_range_limits(double rmin, double rmax)
+{
+    // Range is along the x axis of a range-time waterfall, and the y axis of a map
+    if (d_mode == gr::plasma::range_doppler_sink::RANGE_TIME) {
+        d_waterfall->setInterval(Qt::XAxis, QwtInterval(rmin, rmax));
+        d_plot->axisWidget(QwtPlot::xBottom)->setTitle("Range (m)");
+    } else {
         ylim(rmin, rmax);
-        // Update the axes if we're plotting range and doppler
-        QwtScaleWidget* y = d_plot->axisWidget(QwtPlot::yLeft);
-        y->setTitle("Range (m)");
-        y = d_plot->axisWidget(QwtPlot::xBottom);
+        d_plot->axisWidget(QwtPlot::yLeft)->setTitle("Range (m)");
     }
 }
 
@@ -239,12 +499,38 @@ void RangeDopplerWindow::plot_detections(pmt::pmt_t indices, int nrow, int ncol)
             int detection_col = idx[i] / nrow;
             int detection_row = idx[i] % nrow;
             // Compute the x and y values
-            xData[i] = detection_col / (float)ncol * d_data->interval(Qt::XAxis).width() +
-                       d_data->interval(Qt::XAxis).minValue();
-            yData[i] = detection_row / (float)nrow * d_data->interval(Qt::YAxis).width() +
-                       d_data->interval(Qt::YAxis).minValue();
+            xData[i] = detection_col / (float)ncol * d_image->interval(Qt::XAxis).width() +
+                       d_image->interval(Qt::XAxis).minValue();
+            yData[i] = detection_row / (float)nrow * d_image->interval(Qt::YAxis).width() +
+                       d_image->interval(Qt::YAxis).minValue();
         }
 
         d_curve->setSamples(xData, yData);
     }
-}
\ No newline at end of file
+}
+
+void RangeDopplerWindow::plot_refined_detections(const pmt::pmt_t& meta)
+{
+    // Match the units of the velocity axis
+    bool velocity =
+        d_center_freq != 0 and pmt::dict_has_key(meta, PMT_DETECTION_VELOCITY);
+    pmt::pmt_t x_key = velocity ? PMT_DETECTION_VELOCITY : PMT_DETECTION_DOPPLER;
+    pmt::pmt_t x = pmt::dict_ref(meta, x_key, pmt::PMT_NIL);
+    pmt::pmt_t y = pmt::dict_ref(meta, PMT_DETECTION_RANGE, pmt::PMT_NIL);
+    if (not pmt::is_f64vector(x) or not pmt::is_f64vector(y))
+        return;
+
+    size_t n = std::min(pmt::length(x), pmt::length(y));
+    size_t io(0);
+    const double* x_ptr = pmt::f64vector_elements(x, io);
+    const double* y_ptr = pmt::f64vector_elements(y, io);
+    QVector<double> xData, yData;
+    for (size_t i = 0; i < n; i++) {
+        // Detections without enough metadata to locate them are skipped
+        if (std::isnan(x_ptr[i]) or std::isnan(y_ptr[i]))
+            continue;
+        xData.append(x_ptr[i]);
+        yData.append(y_ptr[i]);
+    }
+    d_curve->setSamples(xData, yData);
+}
@@ -3,6 +3,7 @@
 
 #include <gnuradio/plasma/pmt_constants.h>
 #include <gnuradio/plasma/qt_update_events.h>
+#include <gnuradio/plasma/range_doppler_sink.h>
 #include <plasma_dsp/file.h>
 #include <plasma_dsp/lfm.h>
 #include <pmt/pmt.h>
@@ -10,21 +11,23 @@
 #include <qwt/qwt_plot.h>
 #include <qwt/qwt_thermo.h>
 #include <qwt_color_map.h>
-#include <qwt_matrix_raster_data.h>
 #include <qwt_plot.h>
 #include <qwt_plot_canvas.h>
 #include <qwt_plot_curve.h>
 #include <qwt_plot_layout.h>
+#include <qwt_plot_item.h>
 #include <qwt_plot_panner.h>
 #include <qwt_plot_renderer.h>
 #include <qwt_plot_spectrogram.h>
 #include <qwt_plot_zoomer.h>
 #include <qwt_scale_draw.h>
+#include <qwt_scale_map.h>
 #include <qwt_scale_widget.h>
 #include <qwt_symbol.h>
 
 #include <QBoxLayout>
 #include <QCheckBox>
+#include <QImage>
 #include <QWidget>
 
 #include <pmt/pmt.h>
@@ -32,65 +35,112 @@
 #include <iostream>
 #include <vector>
 
-class RangeDopplerData : public QwtMatrixRasterData
+/**
+ * @brief Base class for plot items that convert data to colors through a lookup table
+ */
+class ColorMappedItem : public QwtPlotItem
 {
 public:
-    RangeDopplerData() : QwtMatrixRasterData() {}
+    ColorMappedItem();
 
-    virtual void setValueMatrix(const QVector<double>& values, int numColumns)
-    {
-        this->values = values;
-        this->numColumns = numColumns;
-        numRows = values.size() / numColumns;
+    /**
+     * @brief Sample the colormap over the z interval into the lookup table
+     */
+    void setColorMap(const QwtColorMap& colorMap);
 
-        const QwtInterval xInterval = interval(Qt::XAxis);
-        const QwtInterval yInterval = interval(Qt::YAxis);
-        if (xInterval.isValid())
-            dx = xInterval.width() / numColumns;
-        if (yInterval.isValid())
-            dy = yInterval.width() / numRows;
-    }
+    virtual void setInterval(Qt::Axis axis, const QwtInterval& interval);
+    QwtInterval interval(Qt::Axis axis) const;
 
-    virtual void setInterval(Qt::Axis axis, const QwtInterval& interval)
-    {
-        QwtRasterData::setInterval(axis, interval);
-        if (axis == Qt::XAxis) {
-            dx = interval.width() / numColumns;
-        } else if (axis == Qt::YAxis) {
-            dy = interval.width() / numRows;
-        }
-    }
+protected:
+    /**
+     * @brief Map n values in the z interval to colors
+     */
+    void colorize(const float* in, int n, QRgb* out) const;
 
-    virtual double value(double x, double y) const
-    {
-        const QwtInterval xInterval = interval(Qt::XAxis);
-        const QwtInterval yInterval = interval(Qt::YAxis);
+    QwtInterval d_intervals[3];
+    QVector<QRgb> d_lut;
 
-        if (!(xInterval.contains(x) && yInterval.contains(y)))
-            return qQNaN();
+private:
+    mutable std::vector<uint8_t> d_indices;
+};
 
-        double value;
+/**
+ * @brief Plot item that draws a range-doppler map as a color-mapped image
+ *
+ * The map is converted to an RGB image through a lookup-table colormap once per update
+ * (on the first draw after it changes), so drawing only has to scale the image onto the
+ * canvas rather than evaluating the colormap for every screen pixel.
+ */
+class RangeDopplerImage : public ColorMappedItem
+{
+public:
+    RangeDopplerImage();
 
-        int row = round((y - yInterval.minValue()) / dy);
-        int col = round((x - xInterval.minValue()) / dx);
+    int rtti() const override { return QwtPlotItem::Rtti_PlotUserItem; }
 
-        if (row >= numRows)
-            row = numRows - 1;
+    void setInterval(Qt::Axis axis, const QwtInterval& interval) override;
 
-        if (col >= numColumns)
-            col = numColumns - 1;
+    /**
+     * @brief Replace the map
+     *
+     * @param values Row-major map data. Row 0 is drawn at the bottom of the plot.
+     * @param numColumns Number of columns in the map
+     */
+    void setValueMatrix(std::vector<float>&& values, int numColumns);
 
-        value = values[row * numColumns + col];
+    QRectF boundingRect() const override;
+    void draw(QPainter* painter,
+              const QwtScaleMap& xMap,
+              const QwtScaleMap& yMap,
+              const QRectF& canvasRect) const override;
 
-        return value;
-    }
+private:
+    void render() const;
+
+    std::vector<float> d_values;
+    int d_num_rows;
+    int d_num_columns;
+    mutable bool d_dirty;
+    mutable QImage d_image;
+};
+
+/**
+ * @brief Plot item that draws a scrolling waterfall from a ring buffer
+ *
+ * Each new row is colored into the oldest line of a fixed-size image, so the history
+ * is never re-rendered and memory use is set by the history length. Drawing blits the
+ * two halves of the ring so that the newest row is at the top of the plot. Without an
+ * x interval, the columns are plotted against their bin index, and without a y interval
+ * the rows are plotted against their age in rows.
+ */
+class WaterfallImage : public ColorMappedItem
+{
+public:
+    WaterfallImage();
+
+    int rtti() const override { return QwtPlotItem::Rtti_PlotUserItem + 1; }
+
+    /**
+     * @brief Add a row to the waterfall, using the current z interval
+     *
+     * @param row Row data. If its length differs from the previous rows, the history
+     * is cleared.
+     * @param history Number of rows to keep. If this changes, the history is cleared.
+     */
+    void append(const std::vector<float>& row, size_t history);
+    void clear();
+
+    QRectF boundingRect() const override;
+    void draw(QPainter* painter,
+              const QwtScaleMap& xMap,
+              const QwtScaleMap& yMap,
+              const QRectF& canvasRect) const override;
 
 private:
-    QVector<double> values;
-    int numColumns;
-    int numRows;
-    double dx;
-    double dy;
+    QImage d_image;
+    // Image line that the next row is written to. Lines are written in decreasing
+    // order so that the newest rows come first when the image is read from the top.
+    int d_head;
 };
 
 class RangeDopplerWindow : public QWidget
@@ -105,6 +155,12 @@ public:
 
     bool is_closed() const;
     bool busy() const;
+    /**
+     * @brief Size of the plot canvas in pixels. Maps are decimated to this size before
+     * they are sent to the GUI thread.
+     */
+    size_t display_rows() const;
+    size_t display_cols() const;
 
     void xlim(double x1, double x2);
     void ylim(double y1, double y2);
@@ -117,16 +173,17 @@ public:
                            std::string detection_indices_key);
 public slots:
     void customEvent(QEvent* e) override;
+    bool eventFilter(QObject* obj, QEvent* e) override;
 
     void show_detections(bool checked);
 
 private:
     // Qwt plot objects
-    QwtPlotSpectrogram* d_spectro;
+    RangeDopplerImage* d_image;
+    WaterfallImage* d_waterfall;
     QwtPlot* d_debug_plot;
     QwtPlot* d_plot;
     QwtPlotCurve* d_debug_curve;
-    RangeDopplerData* d_data;
     QwtPlotZoomer* d_zoomer;
     QwtPlotPanner* d_panner;
 
@@ -141,10 +198,16 @@ private:
     double d_samp_rate;
     double d_pulsewidth;
     double d_center_freq;
+    // Delay (in samples) of the first and last range bins if the data is range gated
+    bool d_range_gated;
+    long d_range_gate_start;
+    long d_range_gate_stop;
 
     // Status variables
     std::atomic<bool> d_busy;
     bool d_closed;
+    std::atomic<size_t> d_display_rows;
+    std::atomic<size_t> d_display_cols;
 
     // Metadata keys
     pmt::pmt_t d_prf_key;
@@ -153,9 +216,17 @@ private:
     pmt::pmt_t d_center_freq_key;
     pmt::pmt_t d_detection_indices_key;
 
+    // Display mode (gr::plasma::range_doppler_sink::DisplayMode) of the last update
+    int d_mode;
+
+    void set_display_mode(int mode);
+    void set_color_scale(const QwtInterval& zInterval);
+    void parse_metadata(const pmt::pmt_t& meta);
     void set_range_axis();
+    void set_range_limits(double rmin, double rmax);
     void set_velocity_axis();
     void plot_detections(pmt::pmt_t indices, int nrow, int ncol);
+    void plot_refined_detections(const pmt::pmt_t& meta);
 };
 
 #endif /* C63B8235_0BB0_46FF_A644_A4CCB87E809D */
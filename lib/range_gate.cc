@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "range_gate.h"
+#include <plasma_dsp/constants.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+namespace plasma {
+
+RangeGate::RangeGate()
+    : d_min_gate(0),
+      d_max_gate(0),
+      d_in_meters(false),
+      d_ntaps(1),
+      d_first_row(0),
+      d_last_row(0)
+{
+}
+
+void RangeGate::set_limits(double min_gate, double max_gate, bool in_meters)
+{
+    d_min_gate = min_gate;
+    d_max_gate = max_gate;
+    d_in_meters = in_meters;
+}
+
+void RangeGate::update(size_t nrow, size_t ntaps, double samp_rate)
+{
+    d_ntaps = ntaps;
+    d_first_row = 0;
+    d_last_row = nrow + ntaps - 1;
+    // Range gates in meters can't be applied until the sample rate is known
+    if (not enabled() or (d_in_meters and samp_rate <= 0))
+        return;
+
+    double min_delay = d_min_gate;
+    double max_delay = d_max_gate;
+    if (d_in_meters) {
+        const double c = ::plasma::physconst::c;
+        min_delay *= 2 * samp_rate / c;
+        max_delay *= 2 * samp_rate / c;
+    }
+    // Convert the delays to rows of the full convolution output, keeping at least one
+    // row so that the output is never empty
+    long offset = ntaps - 1;
+    long nfull = nrow + ntaps - 1;
+    long first = std::clamp<long>(std::ceil(min_delay) + offset, 0, nfull - 1);
+    long last = std::clamp<long>(std::floor(max_delay) + offset + 1, first + 1, nfull);
+    d_first_row = first;
+    d_last_row = last;
+}
+
+af::array RangeGate::compress(const af::array& x, const af::array& filt) const
+{
+    size_t nrow = x.dims(0);
+    if (d_first_row == 0 and d_last_row == nrow + d_ntaps - 1)
+        return af::convolve1(x, filt, AF_CONV_EXPAND, AF_CONV_AUTO);
+
+    // Only the input samples that overlap the gate contribute to the output
+    size_t in_first = d_first_row > d_ntaps - 1 ? d_first_row - (d_ntaps - 1) : 0;
+    size_t in_last = std::min(d_last_row, nrow);
+    af::array y = af::convolve1(
+        x.rows(in_first, in_last - 1), filt, AF_CONV_EXPAND, AF_CONV_AUTO);
+    return y.rows(d_first_row - in_first, d_last_row - in_first - 1);
+}
+
+bool RangeGate::enabled() const { return d_max_gate > d_min_gate; }
+
+size_t RangeGate::num_rows() const { return d_last_row - d_first_row; }
+
+long RangeGate::start_delay() const { return (long)d_first_row - (long)(d_ntaps - 1); }
+
+long RangeGate::stop_delay() const { return (long)d_last_row - (long)(d_ntaps - 1); }
+
+} /* namespace plasma */
+} /* namespace gr */
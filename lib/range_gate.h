@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_RANGE_GATE_H
+#define INCLUDED_PLASMA_RANGE_GATE_H
+
+#include <arrayfire.h>
+
+namespace gr {
+namespace plasma {
+
+/**
+ * @brief Restricts the output of pulse compression to a window of range bins.
+ *
+ * Row r of the full (AF_CONV_EXPAND) convolution of an nrow-sample pulse with an
+ * ntaps-sample matched filter corresponds to a delay of r - (ntaps - 1) samples. The
+ * gate selects the rows between a minimum and maximum delay, and only the input
+ * samples that contribute to those rows are convolved.
+ */
+class RangeGate
+{
+public:
+    RangeGate();
+
+    /**
+     * @brief Set the limits of the range gate
+     *
+     * @param min_gate Minimum range gate
+     * @param max_gate Maximum range gate. If this is not greater than min_gate, gating
+     * is disabled and the full convolution output is used.
+     * @param in_meters If true, the limits are ranges in meters. Otherwise, they are
+     * delays in samples.
+     */
+    void set_limits(double min_gate, double max_gate, bool in_meters);
+
+    /**
+     * @brief Compute the output rows for a new pulse/filter size
+     *
+     * @param nrow Number of samples per pulse
+     * @param ntaps Number of matched filter taps
+     * @param samp_rate Sample rate, used to convert gates given in meters to samples
+     */
+    void update(size_t nrow, size_t ntaps, double samp_rate);
+
+    /**
+     * @brief Pulse compress each column of x, keeping only the gated rows
+     *
+     * @param x Input data, with fast time along the first dimension
+     * @param filt Matched filter taps. Must be consistent with the last call to update()
+     * @return af::array Compressed data with num_rows() rows
+     */
+    af::array compress(const af::array& x, const af::array& filt) const;
+
+    bool enabled() const;
+    size_t num_rows() const;
+    /**
+     * @brief Delay (in samples) of the first output row
+     */
+    long start_delay() const;
+    /**
+     * @brief Delay (in samples) one past the last output row
+     */
+    long stop_delay() const;
+
+private:
+    double d_min_gate;
+    double d_max_gate;
+    bool d_in_meters;
+
+    size_t d_ntaps;
+    size_t d_first_row;
+    size_t d_last_row;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_RANGE_GATE_H */
@@ -0,0 +1,167 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "tracker_impl.h"
+#include <gnuradio/io_signature.h>
+#include <cmath>
+
+namespace gr {
+namespace plasma {
+
+tracker::sptr tracker::make(double range_gate,
+                            double velocity_gate,
+                            double alpha,
+                            double beta,
+                            size_t num_confirm,
+                            size_t max_misses)
+{
+    return gnuradio::make_block_sptr<tracker_impl>(
+        range_gate, velocity_gate, alpha, beta, num_confirm, max_misses);
+}
+
+
+/*
+ * The private constructor
+ */
+tracker_impl::tracker_impl(double range_gate,
+                           double velocity_gate,
+                           double alpha,
+                           double beta,
+                           size_t num_confirm,
+                           size_t max_misses)
+    : gr::block(
+          "tracker", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+      d_tracker(range_gate, velocity_gate, alpha, beta, num_confirm, max_misses),
+      d_prf(0),
+      d_num_pulse_cpi(0),
+      d_last_time(NAN),
+      d_in_port(PMT_IN),
+      d_out_port(PMT_OUT)
+{
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+tracker_impl::~tracker_impl() {}
+
+void tracker_impl::handle_msg(pmt::pmt_t msg)
+{
+    if (not pmt::is_pdu(msg)) {
+        GR_LOG_WARN(d_logger, "Message must be a PDU")
+        return;
+    }
+    RadarMeta meta = RadarMeta::parse(pmt::car(msg));
+    pmt::pmt_t range = meta.ref(PMT_DETECTION_RANGE, pmt::PMT_NIL);
+    if (not pmt::is_f64vector(range)) {
+        GR_LOG_WARN(d_logger, "Detections must be refined by a detection_refiner")
+        return;
+    }
+    pmt::pmt_t velocity = meta.ref(PMT_DETECTION_VELOCITY, pmt::PMT_NIL);
+    size_t n = pmt::length(range);
+    size_t io(0);
+    const double* range_ptr = pmt::f64vector_elements(range, io);
+
+    // The refined velocity is positive for closing targets, while the tracks hold the
+    // range rate
+    std::vector<double> range_rate;
+    if (pmt::is_f64vector(velocity) and pmt::length(velocity) == n) {
+        const double* velocity_ptr = pmt::f64vector_elements(velocity, io);
+        range_rate.resize(n);
+        for (size_t i = 0; i < n; i++)
+            range_rate[i] = -velocity_ptr[i];
+    }
+
+    gr::thread::scoped_lock lock(d_mutex);
+    d_tracker.update(update_interval(meta),
+                     range_ptr,
+                     range_rate.empty() ? nullptr : range_rate.data(),
+                     n);
+
+    // Copy the confirmed tracks into the output
+    std::vector<uint64_t> ids;
+    std::vector<double> data;
+    ids.reserve(d_tracker.size());
+    data.reserve(2 * d_tracker.size());
+    for (size_t i = 0; i < d_tracker.size(); i++) {
+        if (d_tracker.confirmed(i)) {
+            ids.push_back(d_tracker.id(i));
+            data.push_back(d_tracker.range(i));
+        }
+    }
+    for (size_t i = 0; i < d_tracker.size(); i++) {
+        if (d_tracker.confirmed(i))
+            data.push_back(d_tracker.velocity(i));
+    }
+
+    pmt::pmt_t out_meta = pmt::make_dict();
+    if (meta.has(RadarMeta::SAMPLE_START))
+        out_meta = pmt::dict_add(out_meta,
+                                 PMT_SAMPLE_START,
+                                 pmt::from_long(meta.get_long(RadarMeta::SAMPLE_START)));
+    out_meta =
+        pmt::dict_add(out_meta, PMT_TRACK_ID, pmt::init_u64vector(ids.size(), ids));
+    message_port_pub(d_out_port,
+                     pmt::cons(out_meta, pmt::init_f64vector(data.size(), data)));
+}
+
+double tracker_impl::update_interval(const RadarMeta& meta)
+{
+    if (meta.has(RadarMeta::PRF))
+        d_prf = meta.get_double(RadarMeta::PRF);
+    if (meta.has(RadarMeta::NUM_PULSE_CPI))
+        d_num_pulse_cpi = meta.get_long(RadarMeta::NUM_PULSE_CPI);
+
+    // The receive time of each CPI still gives the interval when CPIs are dropped
+    // along the way (e.g., by a KEEP_LATEST admission policy) or several of them are
+    // integrated into one map
+    pmt::pmt_t time = meta.ref(PMT_RX_TIME, pmt::PMT_NIL);
+    if (pmt::is_number(time)) {
+        double t = pmt::to_double(time);
+        double dt = t > d_last_time ? t - d_last_time : 0;
+        d_last_time = t;
+        return dt;
+    }
+
+    // Otherwise, assume the CPIs are back to back. core:sample_start can't be used
+    // here, since it is only sent when the waveform changes and counts transmit
+    // samples.
+    if (d_prf > 0)
+        return d_num_pulse_cpi / d_prf;
+    return 0;
+}
+
+void tracker_impl::set_gates(double range_gate, double velocity_gate)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_tracker.set_gates(range_gate, velocity_gate);
+}
+
+void tracker_impl::set_gains(double alpha, double beta)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_tracker.set_gains(alpha, beta);
+}
+
+void tracker_impl::set_confirmation(size_t num_confirm, size_t max_misses)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_tracker.set_confirmation(num_confirm, max_misses);
+}
+
+void tracker_impl::reset()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_tracker.clear();
+    d_last_time = NAN;
+}
+
+} /* namespace plasma */
+} /* namespace gr */
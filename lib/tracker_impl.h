@@ -0,0 +1,57 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_TRACKER_IMPL_H
+#define INCLUDED_PLASMA_TRACKER_IMPL_H
+
+#include "alpha_beta_tracker.h"
+#include "radar_meta.h"
+#include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/plasma/tracker.h>
+#include <gnuradio/thread/thread.h>
+
+namespace gr {
+namespace plasma {
+
+class tracker_impl : public tracker
+{
+private:
+    AlphaBetaTracker d_tracker;
+    gr::thread::mutex d_mutex;
+
+    // Parameters used to find the time between CPIs. Upstream blocks only send them
+    // when they change.
+    double d_prf;
+    int64_t d_num_pulse_cpi;
+    // Receive time of the last CPI (NaN before the first one)
+    double d_last_time;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+
+    void handle_msg(pmt::pmt_t msg);
+    double update_interval(const RadarMeta& meta);
+
+public:
+    tracker_impl(double range_gate,
+                 double velocity_gate,
+                 double alpha,
+                 double beta,
+                 size_t num_confirm,
+                 size_t max_misses);
+    ~tracker_impl();
+
+    void set_gates(double range_gate, double velocity_gate) override;
+    void set_gains(double alpha, double beta) override;
+    void set_confirmation(size_t num_confirm, size_t max_misses) override;
+    void reset() override;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_TRACKER_IMPL_H */
@@ -5,7 +5,10 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 #include "usrp_radar_impl.h"
+#include "latency_trace.h"
 #include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
 
 namespace gr {
 namespace plasma {
@@ -72,7 +75,11 @@ usrp_radar_impl::usrp_radar_impl(const std::string& args,
 
     this->n_tx_total = 0;
     this->new_msg_received = false;
-    this->next_meta = pmt::make_dict();
+    this->pending_meta = pmt::make_dict();
+    this->pending_sample = 0;
+    this->tx_bank = nullptr;
+    this->tx_schedule_pos = 0;
+    this->latency_tracing = false;
 
     config_usrp(this->usrp,
                 this->usrp_args,
@@ -87,6 +94,7 @@ usrp_radar_impl::usrp_radar_impl(const std::string& args,
                 this->verbose);
 
     n_delay = 0;
+    frac_delay = 0;
     if (not cal_file.empty()) {
         read_calibration_file(cal_file);
     }
@@ -115,14 +123,50 @@ bool usrp_radar_impl::stop()
 void usrp_radar_impl::handle_message(const pmt::pmt_t& msg)
 {
     if (pmt::is_pdu(msg)) {
-        next_meta = pmt::dict_update(next_meta, pmt::car(msg));
-        tx_data = pmt::cdr(msg);
-        tx_buff_size = pmt::length(tx_data);
+        // The waveform is swapped in by the transmit thread. If more than one arrives
+        // before it takes effect, only the newest is kept.
+        gr::thread::scoped_lock lock(tx_mutex);
+        pmt::pmt_t meta = pmt::car(msg);
+        pending_sample = pmt::to_uint64(
+            pmt::dict_ref(meta, PMT_EFFECTIVE_SAMPLE, pmt::from_uint64(0)));
+        pending_meta = pmt::dict_delete(meta, PMT_EFFECTIVE_SAMPLE);
+        pending_tx_data = pmt::cdr(msg);
 
         new_msg_received = true;
     }
 }
 
+void usrp_radar_impl::apply_pending_waveform()
+{
+    // Must be called with tx_mutex held
+    tx_data = pending_tx_data;
+    tx_buff_size = pmt::length(tx_data);
+    tx_bank = pmt::c32vector_elements(tx_data, tx_buff_size);
+    tx_buffs[0] = tx_bank;
+    // A waveform bank is sent one PRI at a time, following its schedule
+    tx_schedule.clear();
+    tx_schedule_pos = 0;
+    pmt::pmt_t schedule =
+        pmt::dict_ref(pending_meta, PMT_WAVEFORM_SCHEDULE, pmt::PMT_NIL);
+    size_t nwave = pmt::to_uint64(
+        pmt::dict_ref(pending_meta, PMT_NUM_WAVEFORMS, pmt::from_uint64(1)));
+    if (pmt::is_u32vector(schedule) and nwave > 0) {
+        tx_schedule = pmt::u32vector_elements(schedule);
+        tx_buff_size /= nwave;
+    }
+    pmt::pmt_t meta = pmt::dict_update(pmt::make_dict(), pending_meta);
+    meta = pmt::dict_add(meta, pmt::intern(tx_freq_key), pmt::from_double(tx_freq));
+    meta = pmt::dict_add(meta, pmt::intern(sample_start_key), pmt::from_long(n_tx_total));
+    // Sent with every waveform, like the sample start, so that blocks that only keep
+    // the latest metadata (or that start after the first CPI) still see it
+    if (frac_delay > 0)
+        meta = pmt::dict_add(meta, PMT_FRACTIONAL_DELAY, pmt::from_double(frac_delay));
+    // The receive thread switches to the new buffer size when its data reaches this
+    // transmit sample
+    rx_switches.push_back({ static_cast<int64_t>(n_tx_total), tx_buff_size, meta });
+    new_msg_received = false;
+}
+
 void usrp_radar_impl::run()
 {
     while (not new_msg_received) {
@@ -133,6 +177,12 @@ void usrp_radar_impl::run()
         }
     }
 
+    {
+        // The first waveform sets the buffer sizes, so it is applied immediately
+        gr::thread::scoped_lock lock(tx_mutex);
+        apply_pending_waveform();
+    }
+
     std::atomic<bool>& finished = this->finished;
     if (this->elevate_priority) {
         uhd::set_thread_priority_safe();
@@ -233,40 +283,100 @@ void usrp_radar_impl::receive(uhd::usrp::multi_usrp::sptr usrp,
     cmd.stream_now = rx_stream_now;
     rx_stream->issue_stream_cmd(cmd);
 
-    // Set up and allocate buffers
-    pmt::pmt_t rx_data_pmt = pmt::make_c32vector(tx_buff_size, 0);
-    gr_complex* rx_data_ptr = pmt::c32vector_writable_elements(rx_data_pmt, tx_buff_size);
-
+    // Receive buffer, sized to match the transmit buffer (one PRI, or one group of
+    // staggered PRIs)
+    size_t rx_buff_size = 0;
+    pmt::pmt_t rx_data_pmt;
+    gr_complex* rx_data_ptr = nullptr;
+    // Used to find the transmit sample that lines up with each received buffer
+    const uhd::time_spec_t rx_start_time(start_time);
+    const double tx_samp_rate = usrp->get_tx_rate();
+    const int64_t rx_delay = static_cast<int64_t>(n_delay);
 
     double time_until_start = start_time - usrp->get_time_now().get_real_secs();
     double recv_timeout = 0.1 + time_until_start;
     bool stop_called = false;
 
+    // Transmit sample that lines up with the start of the next receive buffer, and
+    // metadata waiting to be published with the next full buffer
+    int64_t rx_sample = 0;
+    pmt::pmt_t rx_meta = pmt::make_dict();
+
     // TODO: Handle multiple channels (e.g., one out port per channel)
     while (true) {
         if (finished and not stop_called) {
             rx_stream->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
             stop_called = true;
         }
+        // A new waveform (e.g., a new PRF stagger) changes the buffer size at the
+        // transmit sample where it took effect. Buffers of the old size are received
+        // up to that sample, so that every buffer still starts on a PRI boundary.
+        size_t recv_size;
+        {
+            gr::thread::scoped_lock lock(tx_mutex);
+            while (not rx_switches.empty() and rx_switches.front().sample <= rx_sample) {
+                const rx_switch& next = rx_switches.front();
+                if (next.buff_size != rx_buff_size) {
+                    rx_buff_size = next.buff_size;
+                    rx_data_pmt = pmt::make_c32vector(rx_buff_size, 0);
+                    size_t io(0);
+                    rx_data_ptr = pmt::c32vector_writable_elements(rx_data_pmt, io);
+                }
+                rx_meta = pmt::dict_update(rx_meta, next.meta);
+                rx_switches.pop_front();
+            }
+            recv_size = rx_buff_size;
+            if (not rx_switches.empty())
+                recv_size = std::min<int64_t>(recv_size,
+                                              rx_switches.front().sample - rx_sample);
+        }
         try {
-            if (n_delay > 0) {
-                // Throw away n_delay samples at the beginning
-                std::vector<gr_complex> dummy_vec(n_delay);
-                size_t n_rx =
-                    rx_stream->recv(dummy_vec.data(), n_delay, md, recv_timeout);
+            while (n_delay > 0) {
+                // Throw away n_delay samples at the beginning, using the output buffer
+                // as scratch space
+                size_t n_rx = rx_stream->recv(rx_data_ptr,
+                                              std::min(n_delay, rx_buff_size),
+                                              md,
+                                              recv_timeout);
+                if (md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE)
+                    break;
                 n_delay -= n_rx;
             }
-            rx_stream->recv(rx_data_ptr, tx_buff_size, md, recv_timeout);
+            size_t n_rx = rx_stream->recv(rx_data_ptr, recv_size, md, recv_timeout);
+            uint64_t rx_ns = latency_now_ns();
             recv_timeout = 0.1;
-            // Copy any new metadata to the output and reset the metadata
-            pmt::pmt_t meta = this->next_meta;
-            if (pmt::length(meta) > 0) {
-                meta = pmt::dict_add(
-                    meta, pmt::intern(rx_freq_key), pmt::from_double(rx_freq));
-                this->next_meta = pmt::make_dict();
+            // Follow the receive time when it is known, so that samples lost to an
+            // overflow don't shift the waveform switches
+            if (md.has_time_spec)
+                rx_sample =
+                    (md.time_spec - rx_start_time).to_ticks(tx_samp_rate) - rx_delay;
+            rx_sample += n_rx;
+            // A short read that ends at a waveform switch holds part of a PRI from
+            // before the switch, so it is not published
+            if (recv_size == rx_buff_size) {
+                // Copy any new metadata to the output and reset the metadata
+                pmt::pmt_t meta = rx_meta;
+                rx_meta = pmt::make_dict();
+                pmt::pmt_t index = pmt::PMT_NIL;
+                if (md.error_code == uhd::rx_metadata_t::ERROR_CODE_NONE) {
+                    gr::thread::scoped_lock lock(tx_mutex);
+                    index = pop_tx_index(md, rx_start_time, tx_samp_rate, rx_delay);
+                }
+                if (pmt::length(meta) > 0) {
+                    meta = pmt::dict_add(
+                        meta, pmt::intern(rx_freq_key), pmt::from_double(rx_freq));
+                }
+                // Tag pulses from a waveform bank with the waveform that was transmitted
+                if (not pmt::is_null(index))
+                    meta = pmt::dict_add(meta, PMT_WAVEFORM_INDEX, index);
+                if (md.has_time_spec) {
+                    double rx_time = (md.time_spec - rx_start_time).get_real_secs();
+                    meta = pmt::dict_add(meta, PMT_RX_TIME, pmt::from_double(rx_time));
+                }
+                if (latency_tracing)
+                    meta = latency_stamp(meta, alias(), rx_ns, latency_now_ns());
+                message_port_pub(PMT_OUT, pmt::cons(meta, rx_data_pmt));
             }
-            message_port_pub(PMT_OUT, pmt::cons(meta, rx_data_pmt));
-            // TODO: May need to resize the buffer if the transmit waveform changes
         } catch (uhd::io_error& e) {
             std::cerr << "Caught an IO exception. " << std::endl;
             std::cerr << e.what() << std::endl;
@@ -305,12 +415,20 @@ void usrp_radar_impl::transmit(uhd::usrp::multi_usrp::sptr usrp,
     double timeout = 0.1 + start_time;
     while (not finished) {
         if (new_msg_received) {
-            tx_buffs[0] = pmt::c32vector_writable_elements(tx_data, tx_buff_size);
-            next_meta = pmt::dict_add(
-                next_meta, pmt::intern(tx_freq_key), pmt::from_double(tx_freq));
-            next_meta = pmt::dict_add(
-                next_meta, pmt::intern(sample_start_key), pmt::from_long(n_tx_total));
-            new_msg_received = false;
+            // Switch waveforms at the first pulse boundary at or after the scheduled
+            // sample index
+            gr::thread::scoped_lock lock(tx_mutex);
+            if (new_msg_received and n_tx_total >= pending_sample)
+                apply_pending_waveform();
+        }
+        if (not tx_schedule.empty()) {
+            uint32_t index = tx_schedule[tx_schedule_pos];
+            tx_schedule_pos = (tx_schedule_pos + 1) % tx_schedule.size();
+            tx_buffs[0] = tx_bank + index * tx_buff_size;
+            gr::thread::scoped_lock lock(tx_mutex);
+            if (tx_indices.size() >= max_tx_indices)
+                tx_indices.pop_front();
+            tx_indices.push_back({ static_cast<int64_t>(n_tx_total), index });
         }
         n_tx_total += tx_stream->send(tx_buffs, tx_buff_size, md, timeout) *
                       tx_stream->get_num_channels();
@@ -323,6 +441,30 @@ void usrp_radar_impl::transmit(uhd::usrp::multi_usrp::sptr usrp,
     tx_stream->send("", 0, md);
 }
 
+pmt::pmt_t usrp_radar_impl::pop_tx_index(const uhd::rx_metadata_t& md,
+                                         const uhd::time_spec_t& start_time,
+                                         double tx_rate,
+                                         int64_t rx_delay)
+{
+    // Must be called with tx_mutex held
+    if (tx_indices.empty())
+        return pmt::PMT_NIL;
+    if (md.has_time_spec) {
+        // Transmit sample whose echo starts this buffer. Pulses sent before it were
+        // never received (e.g., after an overflow or a timeout), so their entries are
+        // dropped, and a pulse sent well after it hasn't been received yet.
+        int64_t sample = (md.time_spec - start_time).to_ticks(tx_rate) - rx_delay;
+        int64_t tolerance = static_cast<int64_t>(tx_buff_size / 2);
+        while (not tx_indices.empty() and tx_indices.front().sample + tolerance < sample)
+            tx_indices.pop_front();
+        if (tx_indices.empty() or tx_indices.front().sample > sample + tolerance)
+            return pmt::PMT_NIL;
+    }
+    pmt::pmt_t index = pmt::from_uint64(tx_indices.front().index);
+    tx_indices.pop_front();
+    return index;
+}
+
 void usrp_radar_impl::read_calibration_file(const std::string& filename)
 {
     std::ifstream file(filename);
@@ -333,11 +475,15 @@ void usrp_radar_impl::read_calibration_file(const std::string& filename)
         for (auto& config : json[radio_type]) {
             if (config["samp_rate"] == usrp->get_tx_rate() and
                 config["master_clock_rate"] == usrp->get_master_clock_rate()) {
-                n_delay = config["delay"];
+                // Delays may be fractional, as written by plasma_calibrate_delay
+                double delay = config["delay"].get<double>();
+                double whole_delay = std::max(std::floor(delay), 0.0);
+                n_delay = static_cast<size_t>(whole_delay);
+                frac_delay = std::max(delay - whole_delay, 0.0);
                 break;
             }
         }
-        if (n_delay == 0)
+        if (n_delay == 0 and frac_delay == 0)
             UHD_LOG_INFO("USRP Radar",
                          "Calibration file found, but no data exists for this "
                          "combination of radio, master clock rate, and sample rate");
@@ -357,5 +503,7 @@ void usrp_radar_impl::set_metadata_keys(const std::string& tx_freq_key,
     this->sample_start_key = sample_start_key;
 }
 
+void usrp_radar_impl::set_latency_tracing(bool enable) { latency_tracing = enable; }
+
 } /* namespace plasma */
 } /* namespace gr */
\ No newline at end of file
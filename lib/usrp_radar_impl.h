@@ -16,6 +16,7 @@
 #include <uhd/usrp/multi_usrp.hpp>
 #include <uhd/utils/thread.hpp>
 #include <boost/thread/thread.hpp>
+#include <deque>
 #include <fstream>
 #include <queue>
 
@@ -40,7 +41,10 @@ private:
     std::string tx_cpu_format, rx_cpu_format;
     std::string tx_otw_format, rx_otw_format;
     bool verbose;
+    // Calibrated receive delay, split into whole samples (discarded when streaming
+    // starts) and the fractional remainder (published for the matched filter)
     size_t n_delay;
+    double frac_delay;
     
     // Implementation params
     gr::thread::thread d_main_thread;
@@ -52,8 +56,40 @@ private:
     size_t n_tx_total;
     
     pmt::pmt_t tx_data;
-    pmt::pmt_t next_meta; // Metadata for the next Rx pdu
     std::atomic<bool> new_msg_received;
+    // Waveform waiting to be transmitted, and the transmit sample index at which it
+    // takes effect. tx_mutex also protects rx_switches, and tx_buff_size when it is
+    // read by the receive thread.
+    gr::thread::mutex tx_mutex;
+    pmt::pmt_t pending_tx_data;
+    pmt::pmt_t pending_meta;
+    uint64_t pending_sample;
+    // Waveforms that took effect on the transmit side, in order, until the receive
+    // thread reaches them: the transmit sample where each one started, its buffer size
+    // (one PRI, or one group of staggered PRIs), and the metadata for the first receive
+    // buffer that uses it
+    struct rx_switch {
+        int64_t sample;
+        size_t buff_size;
+        pmt::pmt_t meta;
+    };
+    std::deque<rx_switch> rx_switches;
+    // Waveform bank state. In bank mode, the transmit buffer is moved to the scheduled
+    // waveform of tx_data each PRI, and the index of every transmitted PRI is queued in
+    // tx_indices (protected by tx_mutex) with its first transmit sample, until the
+    // pulse received at that time is published. Pulses lost on the receive side are
+    // dropped from the queue by their time, and the queue is capped in case the
+    // receive thread stalls.
+    struct tx_pulse {
+        int64_t sample;
+        uint32_t index;
+    };
+    static constexpr size_t max_tx_indices = 4096;
+    const gr_complex* tx_bank;
+    std::vector<uint32_t> tx_schedule;
+    size_t tx_schedule_pos;
+    std::deque<tx_pulse> tx_indices;
+    std::atomic<bool> latency_tracing;
 
 
     // Metadata keys
@@ -65,6 +101,11 @@ private:
 
 private:
     void handle_msg(pmt::pmt_t msg);
+    void apply_pending_waveform();
+    pmt::pmt_t pop_tx_index(const uhd::rx_metadata_t& md,
+                            const uhd::time_spec_t& start_time,
+                            double tx_rate,
+                            int64_t rx_delay);
     void config_usrp(uhd::usrp::multi_usrp::sptr& usrp,
                      const std::string& args,
                      const double tx_rate,
@@ -128,6 +169,8 @@ public:
      */
     bool stop() override;
 
+    void set_latency_tracing(bool enable) override;
+
     /**
      * @brief Use the calibration file to determine the number of
      * samples to remove from the beginning of transmission
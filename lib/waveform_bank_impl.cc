@@ -0,0 +1,137 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "waveform_bank_impl.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+namespace plasma {
+
+waveform_bank::sptr waveform_bank::make(size_t num_waveforms,
+                                        const std::vector<int>& schedule,
+                                        double prf,
+                                        double samp_rate)
+{
+    return gnuradio::make_block_sptr<waveform_bank_impl>(
+        num_waveforms, schedule, prf, samp_rate);
+}
+
+
+/*
+ * The private constructor
+ */
+waveform_bank_impl::waveform_bank_impl(size_t num_waveforms,
+                                       const std::vector<int>& schedule,
+                                       double prf,
+                                       double samp_rate)
+    : gr::block("waveform_bank",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_prf(prf),
+      d_samp_rate(samp_rate),
+      d_next_slot(0),
+      d_meta(pmt::make_dict()),
+      d_in_port(PMT_IN),
+      d_out_port(PMT_OUT)
+{
+    if (num_waveforms == 0)
+        throw std::invalid_argument("Waveform bank must hold at least one waveform");
+    d_waveforms.assign(num_waveforms, pmt::PMT_NIL);
+    set_schedule(schedule);
+
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](pmt::pmt_t msg) { handle_msg(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+waveform_bank_impl::~waveform_bank_impl() {}
+
+void waveform_bank_impl::handle_msg(pmt::pmt_t msg)
+{
+    if (not pmt::is_pdu(msg)) {
+        GR_LOG_WARN(d_logger, "Invalid message type")
+        return;
+    }
+    gr::thread::scoped_lock lock(d_mutex);
+    pmt::pmt_t meta = pmt::car(msg);
+    size_t slot = pmt::to_uint64(
+        pmt::dict_ref(meta, PMT_WAVEFORM_INDEX, pmt::from_uint64(d_next_slot)));
+    if (slot >= d_waveforms.size()) {
+        GR_LOG_WARN(d_logger, "Waveform index out of range: " + std::to_string(slot))
+        return;
+    }
+    d_waveforms[slot] = pmt::cdr(msg);
+    d_next_slot = (slot + 1) % d_waveforms.size();
+    d_meta = pmt::dict_update(d_meta, pmt::dict_delete(meta, PMT_WAVEFORM_INDEX));
+    d_samp_rate = pmt::to_double(
+        pmt::dict_ref(meta, PMT_SAMPLE_RATE, pmt::from_double(d_samp_rate)));
+
+    publish();
+}
+
+void waveform_bank_impl::publish()
+{
+    // Must be called with d_mutex held. Nothing is sent until every slot is filled.
+    size_t max_len = 0;
+    for (const pmt::pmt_t& waveform : d_waveforms) {
+        if (pmt::is_null(waveform))
+            return;
+        max_len = std::max(max_len, pmt::length(waveform));
+    }
+    size_t n_pri = std::round(d_samp_rate / d_prf);
+    if (max_len > n_pri) {
+        GR_LOG_WARN(d_logger, "Waveforms are longer than the PRI")
+        return;
+    }
+
+    // Pad each waveform to a full PRI in a single contiguous buffer
+    size_t nwave = d_waveforms.size();
+    pmt::pmt_t bank = pmt::make_c32vector(nwave * n_pri, 0);
+    size_t io(0);
+    gr_complex* out = pmt::c32vector_writable_elements(bank, io);
+    for (size_t i = 0; i < nwave; i++) {
+        size_t n = pmt::length(d_waveforms[i]);
+        const gr_complex* in = pmt::c32vector_elements(d_waveforms[i], io);
+        std::copy(in, in + n, out + i * n_pri);
+    }
+
+    pmt::pmt_t meta = d_meta;
+    meta = pmt::dict_add(meta, PMT_SAMPLE_RATE, pmt::from_double(d_samp_rate));
+    meta = pmt::dict_add(meta, PMT_PRF, pmt::from_double(d_prf));
+    meta = pmt::dict_add(meta, PMT_NUM_WAVEFORMS, pmt::from_uint64(nwave));
+    meta = pmt::dict_add(meta, PMT_WAVEFORM_LENGTH, pmt::from_uint64(max_len));
+    meta = pmt::dict_add(
+        meta, PMT_WAVEFORM_SCHEDULE, pmt::init_u32vector(d_schedule.size(), d_schedule));
+    message_port_pub(d_out_port, pmt::cons(meta, bank));
+}
+
+void waveform_bank_impl::set_schedule(const std::vector<int>& schedule)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_schedule.clear();
+    for (int index : schedule) {
+        if (index < 0 or index >= (int)d_waveforms.size()) {
+            GR_LOG_WARN(d_logger,
+                        "Schedule index out of range: " + std::to_string(index))
+            continue;
+        }
+        d_schedule.push_back(index);
+    }
+    if (d_schedule.empty()) {
+        for (size_t i = 0; i < d_waveforms.size(); i++)
+            d_schedule.push_back(i);
+    }
+    publish();
+}
+
+} /* namespace plasma */
+} /* namespace gr */
@@ -0,0 +1,49 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023 gr-plasma author.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_PLASMA_WAVEFORM_BANK_IMPL_H
+#define INCLUDED_PLASMA_WAVEFORM_BANK_IMPL_H
+
+#include <gnuradio/plasma/pmt_constants.h>
+#include <gnuradio/plasma/waveform_bank.h>
+#include <gnuradio/thread/thread.h>
+
+namespace gr {
+namespace plasma {
+
+class waveform_bank_impl : public waveform_bank
+{
+private:
+    double d_prf;
+    double d_samp_rate;
+    // Waveform samples for each slot, or PMT_NIL if the slot hasn't been filled yet
+    std::vector<pmt::pmt_t> d_waveforms;
+    std::vector<uint32_t> d_schedule;
+    size_t d_next_slot;
+    pmt::pmt_t d_meta;
+    gr::thread::mutex d_mutex;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+
+    void handle_msg(pmt::pmt_t msg);
+    void publish();
+
+public:
+    waveform_bank_impl(size_t num_waveforms,
+                       const std::vector<int>& schedule,
+                       double prf,
+                       double samp_rate);
+    ~waveform_bank_impl();
+
+    void set_schedule(const std::vector<int>& schedule) override;
+};
+
+} // namespace plasma
+} // namespace gr
+
+#endif /* INCLUDED_PLASMA_WAVEFORM_BANK_IMPL_H */
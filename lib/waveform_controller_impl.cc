@@ -50,15 +50,18 @@ void waveform_controller_impl::handle_message(const pmt::pmt_t& msg)
     if (pmt::is_pdu(msg)) {
         pmt::pmt_t meta = pmt::car(msg);
         pmt::pmt_t data = pmt::cdr(msg);
-        size_t n = pmt::length(data);
         d_num_samp_waveform = pmt::length(data);
 
-        // Add metadata to the existing PDU
+        // Add metadata to the existing PDU and forward the sample vector by reference.
+        // This is safe because of who owns the buffer: the waveform sources
+        // (lfm_source, pcfm_source, waveform_bank) and cw_to_pulsed allocate a new
+        // vector for each new waveform and only ever resend it unchanged, and neither
+        // this block nor usrp_radar writes to it. Not every block works this way
+        // (usrp_radar and the processing blocks reuse their output buffers), so a
+        // source that reuses its buffer would need a copy here.
         meta = pmt::dict_update(meta, d_meta);
 
-        message_port_pub(
-            d_out_port,
-            pmt::cons(meta, pmt::init_c32vector(n, pmt::c32vector_elements(data, n))));
+        message_port_pub(d_out_port, pmt::cons(meta, data));
     } else {
         GR_LOG_ERROR(d_logger, "Waveform controller input must be a PDU")
     }
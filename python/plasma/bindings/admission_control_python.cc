@@ -0,0 +1,47 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(admission_control.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(a099f402abc66212c377ba4ab0ee0150)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/admission_control.h>
+// pydoc.h is automatically generated in the build directory
+#include <admission_control_pydoc.h>
+
+void bind_admission_control(py::module& m)
+{
+
+    using AdmissionControl = ::gr::plasma::AdmissionControl;
+
+
+    py::class_<AdmissionControl, std::shared_ptr<AdmissionControl>> admission_control_class(
+        m, "AdmissionControl", D(AdmissionControl));
+
+    admission_control_class.def(py::init<>(), D(AdmissionControl, AdmissionControl));
+
+    py::enum_<gr::plasma::AdmissionControl::Policy>(admission_control_class, "Policy")
+        .value("KEEP_LATEST", gr::plasma::AdmissionControl::KEEP_LATEST)
+        .value("FIFO", gr::plasma::AdmissionControl::FIFO)
+        .value("RATE_LIMITED", gr::plasma::AdmissionControl::RATE_LIMITED)
+        .export_values();
+    py::implicitly_convertible<int, gr::plasma::AdmissionControl::Policy>();
+}
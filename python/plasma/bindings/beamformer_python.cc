@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(beamformer.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(394d9ae42c6e550f35b41d5ba1b007ea)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/beamformer.h>
+// pydoc.h is automatically generated in the build directory
+#include <beamformer_pydoc.h>
+
+void bind_beamformer(py::module& m)
+{
+
+    using beamformer = ::gr::plasma::beamformer;
+
+
+    py::class_<beamformer, gr::block, gr::basic_block, std::shared_ptr<beamformer>>(
+        m, "beamformer", D(beamformer))
+
+        .def(py::init(&beamformer::make),
+             py::arg("num_channels"),
+             py::arg("element_spacing"),
+             py::arg("steering_angles"),
+             D(beamformer, make))
+
+
+        .def("set_steering_angles",
+             &beamformer::set_steering_angles,
+             py::arg("steering_angles"),
+             D(beamformer, set_steering_angles))
+
+
+        .def("set_element_spacing",
+             &beamformer::set_element_spacing,
+             py::arg("element_spacing"),
+             D(beamformer, set_element_spacing))
+
+
+        .def("set_backend",
+             &beamformer::set_backend,
+             py::arg("arg0"),
+             D(beamformer, set_backend))
+
+
+        .def("set_device_id",
+             &beamformer::set_device_id,
+             py::arg("device_id"),
+             D(beamformer, set_device_id))
+
+
+        .def("set_latency_tracing",
+             &beamformer::set_latency_tracing,
+             py::arg("enable"),
+             D(beamformer, set_latency_tracing))
+
+        ;
+}
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(cfar2D.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(9a7d1d20b6773b7fe6a4a2191e3a7ab3)                     */
+/* BINDTOOL_HEADER_FILE_HASH(9a93f57de363f601307b26671390baad)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -60,5 +60,33 @@ void bind_cfar2D(py::module& m)
              py::arg("n_pulse_cpi_key"),
              D(cfar2D, set_metadata_keys))
 
+
+        .def("set_device_id",
+             &cfar2D::set_device_id,
+             py::arg("device_id"),
+             D(cfar2D, set_device_id))
+
+
+        .def("set_cpu_affinity",
+             &cfar2D::set_cpu_affinity,
+             py::arg("cores"),
+             D(cfar2D, set_cpu_affinity))
+
+
+        .def("set_admission_policy",
+             &cfar2D::set_admission_policy,
+             py::arg("policy"),
+             py::arg("max_rate") = 0,
+             D(cfar2D, set_admission_policy))
+
+
+        .def("num_dropped", &cfar2D::num_dropped, D(cfar2D, num_dropped))
+
+
+        .def("set_latency_tracing",
+             &cfar2D::set_latency_tracing,
+             py::arg("enable"),
+             D(cfar2D, set_latency_tracing))
+
         ;
 }
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(cw_to_pulsed.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(87fc0b84fc680816485d0392b44c284f)                     */
+/* BINDTOOL_HEADER_FILE_HASH(94419dfb7c402edf66212426547be0af)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -48,5 +48,11 @@ void bind_cw_to_pulsed(py::module& m)
              py::arg("prf_key"),
              D(cw_to_pulsed, init_meta_dict))
 
+
+        .def("set_prf_stagger",
+             &cw_to_pulsed::set_prf_stagger,
+             py::arg("prfs"),
+             D(cw_to_pulsed, set_prf_stagger))
+
         ;
 }
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(detection_refiner.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(745120191643c90816f0b978f6dfa439)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/detection_refiner.h>
+// pydoc.h is automatically generated in the build directory
+#include <detection_refiner_pydoc.h>
+
+void bind_detection_refiner(py::module& m)
+{
+
+    using detection_refiner = ::gr::plasma::detection_refiner;
+
+
+    py::class_<detection_refiner, gr::block, gr::basic_block, std::shared_ptr<detection_refiner>>(
+        m, "detection_refiner", D(detection_refiner))
+
+        .def(py::init(&detection_refiner::make),
+             py::arg("num_cols"),
+             D(detection_refiner, make))
+
+
+        .def("set_metadata_keys",
+             &detection_refiner::set_metadata_keys,
+             py::arg("detection_indices_key"),
+             py::arg("doppler_fft_size_key"),
+             D(detection_refiner, set_metadata_keys))
+
+        ;
+}
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(device.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(9ee386279f14c5616fe6087bfbe1b8ca)                     */
+/* BINDTOOL_HEADER_FILE_HASH(f19480a825fc683592bcba9d8637f735)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -36,7 +36,26 @@ void bind_device(py::module& m)
     py::class_<Device, std::shared_ptr<Device>> device_class(m, "Device", D(Device));
 
     device_class.def(py::init<>(), D(Device, Device, 0));
-    device_class.def(py::init<gr::plasma::Device const&>(), py::arg("arg0"), D(Device, Device, 1));
+    device_class.def(py::init<gr::plasma::Device::Backend, int>(),
+                     py::arg("backend"),
+                     py::arg("device_id") = 0,
+                     D(Device, Device, 1));
+    device_class.def(py::init<gr::plasma::Device const&>(), py::arg("arg0"), D(Device, Device, 2));
+
+    device_class
+        .def("set_backend", &Device::set_backend, py::arg("backend"), D(Device, set_backend))
+        .def("set_device_id",
+             &Device::set_device_id,
+             py::arg("device_id"),
+             D(Device, set_device_id))
+        .def("set_cpu_affinity",
+             &Device::set_cpu_affinity,
+             py::arg("cores"),
+             D(Device, set_cpu_affinity))
+        .def("backend", &Device::backend, D(Device, backend))
+        .def("device_id", &Device::device_id, D(Device, device_id))
+        .def("cpu_affinity", &Device::cpu_affinity, D(Device, cpu_affinity))
+        .def("bind", &Device::bind, D(Device, bind));
 
     py::enum_<gr::plasma::Device::Backend>(device_class, "Backend")
         .value("DEFAULT", gr::plasma::Device::DEFAULT)
@@ -34,3 +34,18 @@ static const char* __doc_gr_plasma_cfar2D_set_backend = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_cfar2D_set_metadata_keys = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_cfar2D_set_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_cfar2D_set_cpu_affinity = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_cfar2D_set_admission_policy = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_cfar2D_num_dropped = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_cfar2D_set_latency_tracing = R"doc()doc";
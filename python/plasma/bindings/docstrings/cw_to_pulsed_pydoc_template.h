@@ -28,3 +28,6 @@ static const char* __doc_gr_plasma_cw_to_pulsed_make = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_cw_to_pulsed_init_meta_dict = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_cw_to_pulsed_set_prf_stagger = R"doc()doc";
@@ -22,3 +22,27 @@ static const char* __doc_gr_plasma_Device_Device_0 = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_Device_Device_1 = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_Device_2 = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_set_backend = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_set_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_set_cpu_affinity = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_backend = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_cpu_affinity = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_Device_bind = R"doc()doc";
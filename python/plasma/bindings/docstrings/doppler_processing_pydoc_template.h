@@ -34,3 +34,24 @@ static const char* __doc_gr_plasma_doppler_processing_set_backend = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_doppler_processing_set_metadata_keys = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_set_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_set_cpu_affinity = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_set_batch_size = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_set_admission_policy = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_num_dropped = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_set_latency_tracing = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_doppler_processing_set_mti_filter = R"doc()doc";
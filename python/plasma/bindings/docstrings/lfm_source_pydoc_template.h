@@ -28,3 +28,6 @@ static const char* __doc_gr_plasma_lfm_source_make = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_lfm_source_init_meta_dict = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_lfm_source_set_cache_size = R"doc()doc";
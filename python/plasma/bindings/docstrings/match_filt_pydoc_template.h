@@ -34,3 +34,24 @@ static const char* __doc_gr_plasma_match_filt_set_backend = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_match_filt_set_metadata_keys = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_set_range_gates = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_set_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_set_cpu_affinity = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_set_batch_size = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_set_admission_policy = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_num_dropped = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_match_filt_set_latency_tracing = R"doc()doc";
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, plasma, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_noncoherent_integrator_0 = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_noncoherent_integrator_1 = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_make = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_set_num_cpi = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_set_backend = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_set_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_noncoherent_integrator_set_latency_tracing = R"doc()doc";
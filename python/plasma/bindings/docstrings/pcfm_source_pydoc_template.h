@@ -28,3 +28,6 @@ static const char* __doc_gr_plasma_pcfm_source_make = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_pcfm_source_set_metadata_keys = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pcfm_source_set_cache_size = R"doc()doc";
@@ -30,4 +30,7 @@ static const char* __doc_gr_plasma_PhaseCode_generate_code = R"doc()doc";
 static const char* __doc_gr_plasma_PhaseCode_code_string = R"doc()doc";
 
 
+static const char* __doc_gr_plasma_PhaseCode_costas_sequence = R"doc()doc";
+
+
 static const char* __doc_gr_plasma_PhaseCode_wrapToPi = R"doc()doc";
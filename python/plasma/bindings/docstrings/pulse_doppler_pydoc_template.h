@@ -34,3 +34,18 @@ static const char* __doc_gr_plasma_pulse_doppler_set_backend = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_pulse_doppler_init_meta_dict = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pulse_doppler_set_range_gates = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pulse_doppler_set_device_id = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pulse_doppler_set_cpu_affinity = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pulse_doppler_set_admission_policy = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pulse_doppler_num_dropped = R"doc()doc";
@@ -28,3 +28,6 @@ static const char* __doc_gr_plasma_pulse_to_cpi_make = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_pulse_to_cpi_init_meta_dict = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_pulse_to_cpi_set_latency_tracing = R"doc()doc";
@@ -39,7 +39,19 @@ static const char* __doc_gr_plasma_range_doppler_sink_pyqwidget = R"doc()doc";
 static const char* __doc_gr_plasma_range_doppler_sink_set_dynamic_range = R"doc()doc";
 
 
+static const char* __doc_gr_plasma_range_doppler_sink_set_display_mode = R"doc()doc";
+
+
 static const char* __doc_gr_plasma_range_doppler_sink_set_msg_queue_depth = R"doc()doc";
 
 
 static const char* __doc_gr_plasma_range_doppler_sink_set_metadata_keys = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_range_doppler_sink_set_admission_policy = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_range_doppler_sink_num_dropped = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_range_doppler_sink_set_latency_tracing = R"doc()doc";
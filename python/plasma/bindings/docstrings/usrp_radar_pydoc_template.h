@@ -31,3 +31,6 @@
  static const char *__doc_gr_plasma_usrp_radar_set_metadata_keys = R"doc()doc";
 
   
+
+
+static const char* __doc_gr_plasma_usrp_radar_set_latency_tracing = R"doc()doc";
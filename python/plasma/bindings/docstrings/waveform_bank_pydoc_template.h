@@ -0,0 +1,30 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, plasma, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+static const char* __doc_gr_plasma_waveform_bank = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_waveform_bank_waveform_bank_0 = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_waveform_bank_waveform_bank_1 = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_waveform_bank_make = R"doc()doc";
+
+
+static const char* __doc_gr_plasma_waveform_bank_set_schedule = R"doc()doc";
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(doppler_processing.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(83cfc6df25d44cfdbcce5b46fc333337)                     */
+/* BINDTOOL_HEADER_FILE_HASH(6e9b3682a31113cb8d46f200531218e2)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -63,5 +63,48 @@ void bind_doppler_processing(py::module& m)
              py::arg("doppler_fft_size_key"),
              D(doppler_processing, set_metadata_keys))
 
+
+        .def("set_device_id",
+             &doppler_processing::set_device_id,
+             py::arg("device_id"),
+             D(doppler_processing, set_device_id))
+
+
+        .def("set_cpu_affinity",
+             &doppler_processing::set_cpu_affinity,
+             py::arg("cores"),
+             D(doppler_processing, set_cpu_affinity))
+
+
+        .def("set_batch_size",
+             &doppler_processing::set_batch_size,
+             py::arg("batch_size"),
+             D(doppler_processing, set_batch_size))
+
+
+        .def("set_admission_policy",
+             &doppler_processing::set_admission_policy,
+             py::arg("policy"),
+             py::arg("max_rate") = 0,
+             D(doppler_processing, set_admission_policy))
+
+
+        .def("num_dropped",
+             &doppler_processing::num_dropped,
+             D(doppler_processing, num_dropped))
+
+
+        .def("set_latency_tracing",
+             &doppler_processing::set_latency_tracing,
+             py::arg("enable"),
+             D(doppler_processing, set_latency_tracing))
+
+
+        .def("set_mti_filter",
+             &doppler_processing::set_mti_filter,
+             py::arg("taps"),
+             py::arg("fused"),
+             D(doppler_processing, set_mti_filter))
+
         ;
 }
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(latency_sink.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(6d28fa72f5ad3f0b7eda4358607faac4)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/latency_sink.h>
+// pydoc.h is automatically generated in the build directory
+#include <latency_sink_pydoc.h>
+
+void bind_latency_sink(py::module& m)
+{
+
+    using latency_sink = ::gr::plasma::latency_sink;
+
+
+    py::class_<latency_sink, gr::block, gr::basic_block, std::shared_ptr<latency_sink>>(
+        m, "latency_sink", D(latency_sink))
+
+        .def(py::init(&latency_sink::make),
+             py::arg("report_interval"),
+             D(latency_sink, make))
+
+
+        .def("reset", &latency_sink::reset, D(latency_sink, reset))
+
+        ;
+}
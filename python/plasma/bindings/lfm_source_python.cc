@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(lfm_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(badb1b368ff643c8b0409e5069ad2586)                     */
+/* BINDTOOL_HEADER_FILE_HASH(e88bfe56a6a244731ab8305bde744e03)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -55,5 +55,11 @@ void bind_lfm_source(py::module& m)
              py::arg("prf_key"),
              D(lfm_source, init_meta_dict))
 
+
+        .def("set_cache_size",
+             &lfm_source::set_cache_size,
+             py::arg("size"),
+             D(lfm_source, set_cache_size))
+
         ;
 }
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(match_filt.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(430965c145731e994034d27cc5deefb5)                     */
+/* BINDTOOL_HEADER_FILE_HASH(ec61182f428b6a13e4f0b4c527e6254b)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -56,5 +56,47 @@ void bind_match_filt(py::module& m)
              py::arg("n_pulse_cpi_key"),
              D(match_filt, set_metadata_keys))
 
+
+        .def("set_range_gates",
+             &match_filt::set_range_gates,
+             py::arg("min_gate"),
+             py::arg("max_gate"),
+             py::arg("in_meters"),
+             D(match_filt, set_range_gates))
+
+
+        .def("set_device_id",
+             &match_filt::set_device_id,
+             py::arg("device_id"),
+             D(match_filt, set_device_id))
+
+
+        .def("set_cpu_affinity",
+             &match_filt::set_cpu_affinity,
+             py::arg("cores"),
+             D(match_filt, set_cpu_affinity))
+
+
+        .def("set_batch_size",
+             &match_filt::set_batch_size,
+             py::arg("batch_size"),
+             D(match_filt, set_batch_size))
+
+
+        .def("set_admission_policy",
+             &match_filt::set_admission_policy,
+             py::arg("policy"),
+             py::arg("max_rate") = 0,
+             D(match_filt, set_admission_policy))
+
+
+        .def("num_dropped", &match_filt::num_dropped, D(match_filt, num_dropped))
+
+
+        .def("set_latency_tracing",
+             &match_filt::set_latency_tracing,
+             py::arg("enable"),
+             D(match_filt, set_latency_tracing))
+
         ;
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(noncoherent_integrator.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(b66ac13eddd3ad21efd489ceab752534)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/noncoherent_integrator.h>
+// pydoc.h is automatically generated in the build directory
+#include <noncoherent_integrator_pydoc.h>
+
+void bind_noncoherent_integrator(py::module& m)
+{
+
+    using noncoherent_integrator = ::gr::plasma::noncoherent_integrator;
+
+
+    py::class_<noncoherent_integrator,
+               gr::block,
+               gr::basic_block,
+               std::shared_ptr<noncoherent_integrator>>
+        noncoherent_integrator_class(
+            m, "noncoherent_integrator", D(noncoherent_integrator));
+
+    py::enum_<::gr::plasma::noncoherent_integrator::Method>(noncoherent_integrator_class,
+                                                            "Method")
+        .value("SUM", ::gr::plasma::noncoherent_integrator::SUM)
+        .value("EXPONENTIAL", ::gr::plasma::noncoherent_integrator::EXPONENTIAL)
+        .export_values();
+
+    noncoherent_integrator_class
+
+        .def(py::init(&noncoherent_integrator::make),
+             py::arg("num_cpi"),
+             py::arg("method") = ::gr::plasma::noncoherent_integrator::SUM,
+             D(noncoherent_integrator, make))
+
+
+        .def("set_num_cpi",
+             &noncoherent_integrator::set_num_cpi,
+             py::arg("num_cpi"),
+             D(noncoherent_integrator, set_num_cpi))
+
+
+        .def("set_backend",
+             &noncoherent_integrator::set_backend,
+             py::arg("arg0"),
+             D(noncoherent_integrator, set_backend))
+
+
+        .def("set_device_id",
+             &noncoherent_integrator::set_device_id,
+             py::arg("device_id"),
+             D(noncoherent_integrator, set_device_id))
+
+
+        .def("set_latency_tracing",
+             &noncoherent_integrator::set_latency_tracing,
+             py::arg("enable"),
+             D(noncoherent_integrator, set_latency_tracing))
+
+        ;
+}
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(pcfm_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(c5e9c666cc3514405a1511c3bf93eede)                     */
+/* BINDTOOL_HEADER_FILE_HASH(078120dbf8ff700a14d90f2bfb75507c)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -53,5 +53,11 @@ void bind_pcfm_source(py::module& m)
              py::arg("sample_rate_key"),
              D(pcfm_source, set_metadata_keys))
 
+
+        .def("set_cache_size",
+             &pcfm_source::set_cache_size,
+             py::arg("size"),
+             D(pcfm_source, set_cache_size))
+
         ;
 }
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(1)                                                        */
 /* BINDTOOL_HEADER_FILE(phase_code.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(63121bae2b51375ead608abab842bf0b)                     */
+/* BINDTOOL_HEADER_FILE_HASH(0b7a6cc16002e623fe5107c347144cd0)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -39,6 +39,13 @@ void bind_phase_code(py::module& m)
         .value("BARKER", gr::plasma::PhaseCode::BARKER)
         .value("FRANK", gr::plasma::PhaseCode::FRANK)
         .value("P4", gr::plasma::PhaseCode::P4)
+        .value("P1", gr::plasma::PhaseCode::P1)
+        .value("P2", gr::plasma::PhaseCode::P2)
+        .value("P3", gr::plasma::PhaseCode::P3)
+        .value("PX", gr::plasma::PhaseCode::PX)
+        .value("ZADOFF_CHU", gr::plasma::PhaseCode::ZADOFF_CHU)
+        .value("COSTAS", gr::plasma::PhaseCode::COSTAS)
+        .value("MPS", gr::plasma::PhaseCode::MPS)
         .value("GENERIC", gr::plasma::PhaseCode::GENERIC) // 999
         .export_values();
 
@@ -53,6 +60,11 @@ void bind_phase_code(py::module& m)
                                 py::arg("type"),
                                 D(PhaseCode, code_string));
 
+    phase_code_class.def_static("costas_sequence",
+                                &PhaseCode::costas_sequence,
+                                py::arg("n"),
+                                D(PhaseCode, costas_sequence));
+
     phase_code_class.def_static(
         "wrapToPi", &PhaseCode::wrapToPi, py::arg("arg0"), D(PhaseCode, wrapToPi));
     py::implicitly_convertible<int, gr::plasma::PhaseCode::Code>()
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(pulse_doppler.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(ab2a4b45ac773efa322f73c5754f9a32)                     */
+/* BINDTOOL_HEADER_FILE_HASH(4d8f181b177738f515c286f7315ebc2d)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -59,5 +59,35 @@ void bind_pulse_doppler(py::module& m)
              py::arg("doppler_fft_size_key"),
              D(pulse_doppler, init_meta_dict))
 
+
+        .def("set_range_gates",
+             &pulse_doppler::set_range_gates,
+             py::arg("min_gate"),
+             py::arg("max_gate"),
+             py::arg("in_meters"),
+             D(pulse_doppler, set_range_gates))
+
+
+        .def("set_device_id",
+             &pulse_doppler::set_device_id,
+             py::arg("device_id"),
+             D(pulse_doppler, set_device_id))
+
+
+        .def("set_cpu_affinity",
+             &pulse_doppler::set_cpu_affinity,
+             py::arg("cores"),
+             D(pulse_doppler, set_cpu_affinity))
+
+
+        .def("set_admission_policy",
+             &pulse_doppler::set_admission_policy,
+             py::arg("policy"),
+             py::arg("max_rate") = 0,
+             D(pulse_doppler, set_admission_policy))
+
+
+        .def("num_dropped", &pulse_doppler::num_dropped, D(pulse_doppler, num_dropped))
+
         ;
 }
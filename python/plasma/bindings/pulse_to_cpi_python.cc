@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(pulse_to_cpi.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(0d94c4fd9ee8007b413a1fc98b134a61)                     */
+/* BINDTOOL_HEADER_FILE_HASH(a069f520a2b2b8f8e2da109b242c3c8e)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -44,5 +44,11 @@ void bind_pulse_to_cpi(py::module& m)
              py::arg("n_pulse_cpi_key"),
              D(pulse_to_cpi, init_meta_dict))
 
+
+        .def("set_latency_tracing",
+             &pulse_to_cpi::set_latency_tracing,
+             py::arg("enable"),
+             D(pulse_to_cpi, set_latency_tracing))
+
         ;
 }
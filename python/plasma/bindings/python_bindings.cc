@@ -37,6 +37,13 @@ namespace py = pybind11;
     void bind_pdu_file_source(py::module& m);
     void bind_pulse_doppler(py::module& m);
     void bind_cw_to_pulsed(py::module& m);
+    void bind_admission_control(py::module& m);
+    void bind_latency_sink(py::module& m);
+    void bind_waveform_bank(py::module& m);
+    void bind_noncoherent_integrator(py::module& m);
+    void bind_detection_refiner(py::module& m);
+    void bind_tracker(py::module& m);
+    void bind_beamformer(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 
@@ -81,5 +88,12 @@ PYBIND11_MODULE(plasma_python, m)
     bind_pdu_file_source(m);
     bind_pulse_doppler(m);
     bind_cw_to_pulsed(m);
+    bind_admission_control(m);
+    bind_latency_sink(m);
+    bind_waveform_bank(m);
+    bind_noncoherent_integrator(m);
+    bind_detection_refiner(m);
+    bind_tracker(m);
+    bind_beamformer(m);
     // ) END BINDING_FUNCTION_CALLS
 }
\ No newline at end of file
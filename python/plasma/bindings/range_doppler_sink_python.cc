@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(1)                                                        */
 /* BINDTOOL_HEADER_FILE(range_doppler_sink.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(1e1aec46d53ce715c43cb3e8dee8ae35)                     */
+/* BINDTOOL_HEADER_FILE_HASH(47118a6c710c213653427b3e3753332a)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -36,8 +36,17 @@ void bind_range_doppler_sink(py::module& m)
     py::class_<range_doppler_sink,
                gr::block,
                gr::basic_block,
-               std::shared_ptr<range_doppler_sink>>(
-        m, "range_doppler_sink", D(range_doppler_sink))
+               std::shared_ptr<range_doppler_sink>>
+        range_doppler_sink_class(m, "range_doppler_sink", D(range_doppler_sink));
+
+    py::enum_<::gr::plasma::range_doppler_sink::DisplayMode>(range_doppler_sink_class,
+                                                             "DisplayMode")
+        .value("RANGE_DOPPLER", ::gr::plasma::range_doppler_sink::RANGE_DOPPLER)
+        .value("RANGE_TIME", ::gr::plasma::range_doppler_sink::RANGE_TIME)
+        .value("DOPPLER_TIME", ::gr::plasma::range_doppler_sink::DOPPLER_TIME)
+        .export_values();
+
+    range_doppler_sink_class
 
         .def(py::init(&range_doppler_sink::make),
              py::arg("samp_rate"),
@@ -72,6 +81,13 @@ void bind_range_doppler_sink(py::module& m)
              D(range_doppler_sink, set_dynamic_range))
 
 
+        .def("set_display_mode",
+             &range_doppler_sink::set_display_mode,
+             py::arg("mode"),
+             py::arg("history"),
+             D(range_doppler_sink, set_display_mode))
+
+
         .def("set_msg_queue_depth",
              &range_doppler_sink::set_msg_queue_depth,
              py::arg("depth"),
@@ -89,5 +105,23 @@ void bind_range_doppler_sink(py::module& m)
              py::arg("detection_indices_key"),
              D(range_doppler_sink, set_metadata_keys))
 
+
+        .def("set_admission_policy",
+             &range_doppler_sink::set_admission_policy,
+             py::arg("policy"),
+             py::arg("max_rate") = 0,
+             D(range_doppler_sink, set_admission_policy))
+
+
+        .def("num_dropped",
+             &range_doppler_sink::num_dropped,
+             D(range_doppler_sink, num_dropped))
+
+
+        .def("set_latency_tracing",
+             &range_doppler_sink::set_latency_tracing,
+             py::arg("enable"),
+             D(range_doppler_sink, set_latency_tracing))
+
         ;
 }
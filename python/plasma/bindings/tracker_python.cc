@@ -0,0 +1,73 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(tracker.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(3e0734a9735267350a6e4022caef61df)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/tracker.h>
+// pydoc.h is automatically generated in the build directory
+#include <tracker_pydoc.h>
+
+void bind_tracker(py::module& m)
+{
+
+    using tracker = ::gr::plasma::tracker;
+
+
+    py::class_<tracker, gr::block, gr::basic_block, std::shared_ptr<tracker>>(
+        m, "tracker", D(tracker))
+
+        .def(py::init(&tracker::make),
+             py::arg("range_gate"),
+             py::arg("velocity_gate"),
+             py::arg("alpha"),
+             py::arg("beta"),
+             py::arg("num_confirm"),
+             py::arg("max_misses"),
+             D(tracker, make))
+
+
+        .def("set_gates",
+             &tracker::set_gates,
+             py::arg("range_gate"),
+             py::arg("velocity_gate"),
+             D(tracker, set_gates))
+
+
+        .def("set_gains",
+             &tracker::set_gains,
+             py::arg("alpha"),
+             py::arg("beta"),
+             D(tracker, set_gains))
+
+
+        .def("set_confirmation",
+             &tracker::set_confirmation,
+             py::arg("num_confirm"),
+             py::arg("max_misses"),
+             D(tracker, set_confirmation))
+
+
+        .def("reset", &tracker::reset, D(tracker, reset))
+
+        ;
+}
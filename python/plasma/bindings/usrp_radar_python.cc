@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(usrp_radar.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(abcaa93a8ea387faf927c248eaf93f2e)                     */
+/* BINDTOOL_HEADER_FILE_HASH(ba43166fbae7fc122d33b238528a105b)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -63,6 +63,12 @@ void bind_usrp_radar(py::module& m)
              py::arg("sample_start_key"),
              D(usrp_radar, set_metadata_keys))
 
+
+        .def("set_latency_tracing",
+             &usrp_radar::set_latency_tracing,
+             py::arg("enable"),
+             D(usrp_radar, set_latency_tracing))
+
         ;
 
 
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2023 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(waveform_bank.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(8fa0d445e326fc32e25a7157095c550d)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/plasma/waveform_bank.h>
+// pydoc.h is automatically generated in the build directory
+#include <waveform_bank_pydoc.h>
+
+void bind_waveform_bank(py::module& m)
+{
+
+    using waveform_bank = ::gr::plasma::waveform_bank;
+
+
+    py::class_<waveform_bank, gr::block, gr::basic_block, std::shared_ptr<waveform_bank>>(
+        m, "waveform_bank", D(waveform_bank))
+
+        .def(py::init(&waveform_bank::make),
+             py::arg("num_waveforms"),
+             py::arg("schedule"),
+             py::arg("prf"),
+             py::arg("samp_rate"),
+             D(waveform_bank, make))
+
+
+        .def("set_schedule",
+             &waveform_bank::set_schedule,
+             py::arg("schedule"),
+             D(waveform_bank, set_schedule))
+
+        ;
+}
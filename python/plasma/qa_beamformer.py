@@ -0,0 +1,56 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+import pmt
+from qa_utils import run_until_messages
+try:
+  from gnuradio.plasma import beamformer
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.plasma import beamformer
+
+class qa_beamformer(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = beamformer(4, 0.5, [0])
+
+    def test_001_beams(self):
+        from gnuradio import blocks
+        block = beamformer(2, 0.5, [0, 30])
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # Two samples per channel of a plane wave from broadside
+        block.to_basic_block()._post(
+            pmt.intern("in"),
+            pmt.cons(pmt.make_dict(), pmt.init_c32vector(4, [1, 1, 1, 1])))
+
+        run_until_messages(self.tb, debug, 1)
+
+        # The broadside beam has unit gain. The 30 degree beam shifts the second
+        # element by -90 degrees.
+        self.assertEqual(debug.num_messages(), 1)
+        msg = debug.get_message(0)
+        self.assertComplexTuplesAlmostEqual(
+            pmt.c32vector_elements(pmt.cdr(msg)), [1, 1, 0.5 - 0.5j, 0.5 - 0.5j], 5)
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            pmt.car(msg), pmt.intern("plasma:num_beams"), pmt.PMT_NIL)), 2)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_beamformer)
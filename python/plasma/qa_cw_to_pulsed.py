@@ -7,7 +7,9 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import pmt
+from qa_utils import run_until_messages
 try:
   from gnuradio.plasma import cw_to_pulsed
 except ImportError:
@@ -34,6 +36,47 @@ class qa_cw_to_pulsed(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def test_002_prf_stagger(self):
+        # PRIs of 10, 20 and 5 samples
+        samp_rate = 1000
+        block = cw_to_pulsed(100, samp_rate)
+        block.init_meta_dict("core:sample_rate", "radar:prf")
+        block.set_prf_stagger([100, 50, 200])
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        wave = [1, 2j, 3]
+        block.to_basic_block()._post(
+            pmt.intern("in"), pmt.cons(pmt.make_dict(), pmt.init_c32vector(3, wave)))
+        run_until_messages(self.tb, debug, 1)
+        self.assertEqual(debug.num_messages(), 1)
+
+        # The group holds one copy of the waveform at the start of each PRI
+        msg = debug.get_message(0)
+        offsets = pmt.dict_ref(pmt.car(msg), pmt.intern("plasma:pulse_offsets"),
+                               pmt.PMT_NIL)
+        self.assertEqual(list(pmt.u64vector_elements(offsets)), [0, 10, 30])
+        expected = [0] * 35
+        for offset in (0, 10, 30):
+            expected[offset:offset + 3] = wave
+        self.assertComplexTuplesAlmostEqual(pmt.c32vector_elements(pmt.cdr(msg)),
+                                            expected)
+
+        # Turning the stagger off goes back to a single PRI. Its (single) offset is
+        # attached even without input metadata, so pulse_to_cpi stops splitting.
+        block.set_prf_stagger([])
+        block.to_basic_block()._post(
+            pmt.intern("in"), pmt.cons(pmt.PMT_NIL, pmt.init_c32vector(3, wave)))
+        run_until_messages(self.tb, debug, 2)
+        self.assertEqual(debug.num_messages(), 2)
+
+        msg = debug.get_message(1)
+        offsets = pmt.dict_ref(pmt.car(msg), pmt.intern("plasma:pulse_offsets"),
+                               pmt.PMT_NIL)
+        self.assertEqual(list(pmt.u64vector_elements(offsets)), [0])
+        self.assertComplexTuplesAlmostEqual(pmt.c32vector_elements(pmt.cdr(msg)),
+                                            wave + [0] * 7)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_cw_to_pulsed)
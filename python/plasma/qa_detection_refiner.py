@@ -0,0 +1,116 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+import pmt
+from qa_utils import run_until_messages
+try:
+  from gnuradio.plasma import detection_refiner
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.plasma import detection_refiner
+
+class qa_detection_refiner(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = detection_refiner(128)
+
+    def test_001_interpolate(self):
+        from gnuradio import blocks
+        c = 299792458
+        samp_rate = 1e6
+        prf = 1e3
+        freq = 1e9
+        nrow, ncol = 4, 4
+        block = detection_refiner(ncol)
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # Peak in row 1 of column 3 (column-major), with uneven neighbors in range
+        # and doppler (which wraps around to column 0)
+        data = [0] * (nrow * ncol)
+        data[3 * nrow + 1] = 4
+        data[3 * nrow + 0] = 2
+        data[3 * nrow + 2] = 3
+        data[2 * nrow + 1] = 1
+        data[0 * nrow + 1] = 2
+        meta = pmt.make_dict()
+        meta = pmt.dict_add(meta, pmt.intern("core:sample_rate"),
+                            pmt.from_double(samp_rate))
+        meta = pmt.dict_add(meta, pmt.intern("radar:prf"), pmt.from_double(prf))
+        meta = pmt.dict_add(meta, pmt.intern("core:frequency"), pmt.from_double(freq))
+        meta = pmt.dict_add(meta, pmt.intern("detection_indices"),
+                            pmt.init_s32vector(1, [3 * nrow + 1]))
+        block.to_basic_block()._post(
+            pmt.intern("in"), pmt.cons(meta, pmt.init_c32vector(len(data), data)))
+
+        run_until_messages(self.tb, debug, 1)
+
+        self.assertEqual(debug.num_messages(), 1)
+        meta = pmt.car(debug.get_message(0))
+        def ref(key):
+            return pmt.f64vector_elements(pmt.dict_ref(
+                meta, pmt.intern("plasma:" + key), pmt.PMT_NIL))
+        # Parabola vertices at +1/6 range bins and +0.1 doppler bins
+        doppler = (1 + 0.1) * prf / ncol
+        self.assertFloatTuplesAlmostEqual(
+            ref("detection_range"), [c / 2 * (1 + 1 / 6) / samp_rate], 4)
+        self.assertFloatTuplesAlmostEqual(ref("detection_doppler"), [doppler], 4)
+        self.assertFloatTuplesAlmostEqual(
+            ref("detection_velocity"), [c / freq / 2 * doppler], 4)
+
+    def test_002_beams(self):
+        from gnuradio import blocks
+        from gnuradio.plasma import cfar2D
+        prf = 1e3
+        nrow, ncol, nbeam = 16, 8, 2
+        cfar = cfar2D([1, 1], [2, 2], 1e-3, ncol)
+        cfar.set_metadata_keys(
+            "detection_indices", "n_detections", "radar:num_pulse_cpi")
+        block = detection_refiner(ncol)
+        debug = blocks.message_debug()
+        self.tb.msg_connect((cfar, 'out'), (block, 'in'))
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # Two beams side by side along doppler, with a weak target in the last
+        # column of beam 0 right next to a strong target in the first column of beam
+        # 1. The strong target must not raise the weak target's threshold.
+        data = [1] * (nrow * ncol * nbeam)
+        data[(ncol - 1) * nrow + 8] = 20 ** 0.5
+        data[ncol * nrow + 8] = 100
+        meta = pmt.make_dict()
+        meta = pmt.dict_add(meta, pmt.intern("radar:prf"), pmt.from_double(prf))
+        meta = pmt.dict_add(meta, pmt.intern("plasma:num_beams"), pmt.from_long(nbeam))
+        cfar.to_basic_block()._post(
+            pmt.intern("in"), pmt.cons(meta, pmt.init_c32vector(len(data), data)))
+
+        run_until_messages(self.tb, debug, 1)
+
+        self.assertEqual(debug.num_messages(), 1)
+        meta = pmt.car(debug.get_message(0))
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            meta, pmt.intern("n_detections"), pmt.PMT_NIL)), 2)
+        self.assertEqual(pmt.u64vector_elements(pmt.dict_ref(
+            meta, pmt.intern("plasma:detection_beam"), pmt.PMT_NIL)), (0, 1))
+        # Each detection's doppler is measured within its own beam
+        self.assertFloatTuplesAlmostEqual(pmt.f64vector_elements(pmt.dict_ref(
+            meta, pmt.intern("plasma:detection_doppler"), pmt.PMT_NIL)),
+            [(ncol - 1 - ncol // 2) * prf / ncol, -(ncol // 2) * prf / ncol], 4)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_detection_refiner)
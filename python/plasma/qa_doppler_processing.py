@@ -7,15 +7,18 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import numpy
+import pmt
+from qa_utils import run_until_messages
 try:
-  from gnuradio.plasma import doppler_processing
+  from gnuradio.plasma import doppler_processing, AdmissionControl
 except ImportError:
     import os
     import sys
     dirname, filename = os.path.split(os.path.abspath(__file__))
     sys.path.append(os.path.join(dirname, "bindings"))
-    from gnuradio.plasma import doppler_processing
+    from gnuradio.plasma import doppler_processing, AdmissionControl
 
 class qa_doppler_processing(gr_unittest.TestCase):
 
@@ -34,6 +37,118 @@ class qa_doppler_processing(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def run_mti(self, taps, fused):
+        nrow, npulse = 4, 8
+        tb = gr.top_block()
+        block = doppler_processing(npulse, npulse)
+        block.set_metadata_keys("radar:num_pulse_cpi", "radar:doppler_fft_size")
+        block.set_mti_filter(taps, fused)
+        debug = blocks.message_debug()
+        tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # Stationary clutter: the same return from every pulse
+        data = [1 + 1j] * (nrow * npulse)
+        block.to_basic_block()._post(
+            pmt.intern("in"),
+            pmt.cons(pmt.make_dict(), pmt.init_c32vector(len(data), data)))
+        run_until_messages(tb, debug, 1)
+
+        self.assertEqual(debug.num_messages(), 1)
+        return pmt.c32vector_elements(pmt.cdr(debug.get_message(0)))
+
+    def test_002_mti_nulls_dc(self):
+        # Without a filter, the clutter shows up at zero doppler
+        self.assertGreater(max(abs(x) for x in self.run_mti([], False)), 1)
+        # Two- and three-pulse cancellers, in slow time and in the doppler domain
+        for taps in ([1, -1], [1, -2, 1]):
+            for fused in (False, True):
+                out = self.run_mti(taps, fused)
+                self.assertLess(max(abs(x) for x in out), 1e-4, (taps, fused))
+
+    def run_doppler(self, block, cpis, num_messages):
+        """
+        Queue the CPIs (pairs of metadata and samples) all at once, pass them
+        through the block, and return the output PDUs
+        """
+        tb = gr.top_block()
+        debug = blocks.message_debug()
+        tb.msg_connect((block, 'out'), (debug, 'store'))
+        for meta, data in cpis:
+            data = pmt.init_c32vector(len(data), list(data))
+            block.to_basic_block()._post(pmt.intern("in"), pmt.cons(meta, data))
+        run_until_messages(tb, debug, num_messages)
+        self.assertEqual(debug.num_messages(), num_messages)
+        return [debug.get_message(i) for i in range(num_messages)]
+
+    def make_cpis(self, nrow, npulse, num_beams):
+        """
+        Random CPIs with the given number of beams each, tagged with their
+        position in the sequence
+        """
+        rng = numpy.random.default_rng(0)
+        cpis = []
+        for i, nbeam in enumerate(num_beams):
+            meta = pmt.dict_add(pmt.make_dict(), pmt.intern("test:id"), pmt.from_long(i))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:num_beams"),
+                                pmt.from_long(nbeam))
+            n = nrow * npulse * nbeam
+            cpis.append((meta, rng.standard_normal(n) + 1j * rng.standard_normal(n)))
+        return cpis
+
+    def make_block(self, npulse, batch_size, policy=AdmissionControl.FIFO):
+        block = doppler_processing(npulse, npulse)
+        block.set_metadata_keys("radar:num_pulse_cpi", "radar:doppler_fft_size")
+        block.set_admission_policy(policy, 0)
+        block.set_batch_size(batch_size)
+        return block
+
+    def cpi_id(self, msg):
+        return pmt.to_long(pmt.dict_ref(pmt.car(msg), pmt.intern("test:id"), pmt.PMT_NIL))
+
+    def assert_same_output(self, out, expected):
+        self.assertEqual(len(out), len(expected))
+        for x, y in zip(out, expected):
+            self.assertEqual(self.cpi_id(x), self.cpi_id(y))
+            self.assertComplexTuplesAlmostEqual(pmt.c32vector_elements(pmt.cdr(x)),
+                                                pmt.c32vector_elements(pmt.cdr(y)), 4)
+
+    def test_003_batching(self):
+        # CPIs that are queued together are processed as one batch, with the same
+        # results (in the same order) as one at a time
+        nrow, npulse = 16, 8
+        cpis = self.make_cpis(nrow, npulse, [1] * 5)
+        expected = self.run_doppler(self.make_block(npulse, 1), cpis, len(cpis))
+        out = self.run_doppler(self.make_block(npulse, 4), cpis, len(cpis))
+        self.assert_same_output(out, expected)
+
+    def test_004_admission(self):
+        nrow, npulse = 16, 8
+        cpis = self.make_cpis(nrow, npulse, [1] * 5)
+
+        # FIFO processes the whole backlog
+        block = self.make_block(npulse, 1, AdmissionControl.FIFO)
+        out = self.run_doppler(block, cpis, 5)
+        self.assertEqual([self.cpi_id(msg) for msg in out], [0, 1, 2, 3, 4])
+        self.assertEqual(block.num_dropped(), 0)
+
+        # KEEP_LATEST skips ahead to the newest CPIs, leaving one waiting
+        block = self.make_block(npulse, 1, AdmissionControl.KEEP_LATEST)
+        block.set_msg_queue_depth(1)
+        out = self.run_doppler(block, cpis, 2)
+        self.assertEqual([self.cpi_id(msg) for msg in out], [3, 4])
+        self.assertEqual(block.num_dropped(), 3)
+
+    def test_005_beam_count_breaks_batch(self):
+        # A change in the number of beams starts a new batch, since the stacked beams
+        # would otherwise be mistaken for pulses
+        nrow, npulse = 16, 8
+        cpis = self.make_cpis(nrow, npulse, [1, 1, 2, 2, 1])
+        expected = self.run_doppler(self.make_block(npulse, 1), cpis, len(cpis))
+        out = self.run_doppler(self.make_block(npulse, 4), cpis, len(cpis))
+        self.assert_same_output(out, expected)
+        for msg, (meta, data) in zip(out, cpis):
+            self.assertEqual(pmt.length(pmt.cdr(msg)), len(data))
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_doppler_processing)
@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+import pmt
+import time
+from qa_utils import run_until_messages
+try:
+  from gnuradio.plasma import latency_sink
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.plasma import latency_sink
+
+class qa_latency_sink(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = latency_sink(10)
+
+    def test_001_report(self):
+        from gnuradio import blocks
+        sink = latency_sink(2)
+        debug = blocks.message_debug()
+        self.tb.msg_connect((sink, 'stats'), (debug, 'store'))
+
+        now = time.time_ns()
+        trace = pmt.make_dict()
+        trace = pmt.dict_add(trace, pmt.intern("usrp_radar0"),
+                             pmt.init_u64vector(2, [now - 3000000, now - 2000000]))
+        trace = pmt.dict_add(trace, pmt.intern("match_filt0"),
+                             pmt.init_u64vector(2, [now - 1500000, now - 1000000]))
+        meta = pmt.dict_add(pmt.make_dict(), pmt.intern("plasma:latency"), trace)
+        for _ in range(2):
+            sink.to_basic_block()._post(pmt.intern("in"), meta)
+
+        run_until_messages(self.tb, debug, 1)
+
+        self.assertEqual(debug.num_messages(), 1)
+        stats = debug.get_message(0)
+        mf = pmt.dict_ref(stats, pmt.intern("match_filt0"), pmt.PMT_NIL)
+        added = pmt.dict_ref(mf, pmt.intern("added"), pmt.PMT_NIL)
+        processing = pmt.dict_ref(mf, pmt.intern("processing"), pmt.PMT_NIL)
+        self.assertAlmostEqual(
+            pmt.to_double(pmt.dict_ref(added, pmt.intern("p50"), pmt.PMT_NIL)), 1.0)
+        self.assertAlmostEqual(
+            pmt.to_double(pmt.dict_ref(processing, pmt.intern("max"), pmt.PMT_NIL)), 0.5)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_latency_sink)
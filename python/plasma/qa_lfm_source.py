@@ -7,7 +7,9 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import pmt
+from qa_utils import run_until_messages
 try:
   from gnuradio.plasma import lfm_source
 except ImportError:
@@ -34,6 +36,94 @@ class qa_lfm_source(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def make_block(self, bandwidth, pulse_width, samp_rate=10e6, prf=1e3):
+        block = lfm_source(bandwidth, -bandwidth / 2, pulse_width, samp_rate, prf)
+        block.init_meta_dict("radar:bandwidth", "radar:start_freq", "radar:duration",
+                             "core:sample_rate", "core:label", "radar:prf")
+        return block
+
+    def run_updates(self, block, updates):
+        """
+        Send the parameter updates to the block and return the waveform PDUs that come
+        out, starting with the one sent when the flowgraph starts
+        """
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+        for msg in updates:
+            block.to_basic_block()._post(pmt.intern("in"), msg)
+        run_until_messages(self.tb, debug, len(updates) + 1)
+        self.assertEqual(debug.num_messages(), len(updates) + 1)
+        return [debug.get_message(i) for i in range(len(updates) + 1)]
+
+    def initial_pdu(self, bandwidth, pulse_width):
+        """
+        The waveform PDU of a block created with the given parameters
+        """
+        tb = gr.top_block()
+        block = self.make_block(bandwidth, pulse_width)
+        debug = blocks.message_debug()
+        tb.msg_connect((block, 'out'), (debug, 'store'))
+        run_until_messages(tb, debug, 1)
+        return debug.get_message(0)
+
+    def meta_ref(self, pdu, key):
+        return pmt.dict_ref(pmt.car(pdu), pmt.intern(key), pmt.PMT_NIL)
+
+    def assert_same_waveform(self, pdu, expected):
+        self.assertComplexTuplesAlmostEqual(pmt.c32vector_elements(pmt.cdr(pdu)),
+                                            pmt.c32vector_elements(pmt.cdr(expected)),
+                                            5)
+
+    def test_002_dict_update(self):
+        # Every parameter in the dictionary is applied before the waveform is
+        # regenerated, and the scheduled switch is forwarded with the new waveform
+        block = self.make_block(1e6, 10e-6)
+        update = pmt.make_dict()
+        update = pmt.dict_add(update, pmt.intern("radar:bandwidth"),
+                              pmt.from_double(2e6))
+        update = pmt.dict_add(update, pmt.intern("radar:start_freq"),
+                              pmt.from_double(-1e6))
+        update = pmt.dict_add(update, pmt.intern("radar:duration"),
+                              pmt.from_double(20e-6))
+        update = pmt.dict_add(update, pmt.intern("plasma:effective_sample"),
+                              pmt.from_uint64(5000))
+        out = self.run_updates(block, [update])
+
+        pdu = out[1]
+        self.assert_same_waveform(pdu, self.initial_pdu(2e6, 20e-6))
+        self.assertEqual(pmt.to_double(self.meta_ref(pdu, "radar:bandwidth")), 2e6)
+        self.assertEqual(pmt.to_double(self.meta_ref(pdu, "radar:duration")), 20e-6)
+        self.assertEqual(pmt.to_uint64(self.meta_ref(pdu, "plasma:effective_sample")),
+                         5000)
+        # The initial waveform had no scheduled switch
+        self.assertTrue(pmt.is_null(self.meta_ref(out[0], "plasma:effective_sample")))
+
+    def test_003_pair_update(self):
+        # A single (key . value) pair regenerates the waveform right away. The
+        # scheduled switch of an earlier update is not sent again.
+        block = self.make_block(1e6, 10e-6)
+        scheduled = pmt.dict_add(pmt.make_dict(), pmt.intern("plasma:effective_sample"),
+                                 pmt.from_uint64(5000))
+        pair = pmt.cons(pmt.intern("radar:duration"), pmt.from_double(5e-6))
+        out = self.run_updates(block, [scheduled, pair])
+
+        pdu = out[2]
+        self.assert_same_waveform(pdu, self.initial_pdu(1e6, 5e-6))
+        self.assertEqual(pmt.to_double(self.meta_ref(pdu, "radar:duration")), 5e-6)
+        self.assertEqual(pmt.to_uint64(self.meta_ref(out[1], "plasma:effective_sample")),
+                         5000)
+        self.assertTrue(pmt.is_null(self.meta_ref(pdu, "plasma:effective_sample")))
+
+    def test_004_cached_waveform(self):
+        # Returning to an earlier configuration sends the cached waveform, which is the
+        # same PMT, so downstream blocks can reuse their own cached results
+        block = self.make_block(1e6, 10e-6)
+        updates = [pmt.cons(pmt.intern("radar:bandwidth"), pmt.from_double(bw))
+                   for bw in (2e6, 1e6)]
+        out = self.run_updates(block, updates)
+        self.assertFalse(pmt.eq(pmt.cdr(out[1]), pmt.cdr(out[0])))
+        self.assertTrue(pmt.eq(pmt.cdr(out[2]), pmt.cdr(out[0])))
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_lfm_source)
@@ -7,7 +7,10 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import numpy
+import pmt
+from qa_utils import run_until_consumed, run_until_messages
 try:
   from gnuradio.plasma import match_filt
 except ImportError:
@@ -15,7 +18,7 @@ except ImportError:
     import sys
     dirname, filename = os.path.split(os.path.abspath(__file__))
     sys.path.append(os.path.join(dirname, "bindings"))
-    from gnuradio.plasma import match_filt
+    from gnuradio.plasma import match_filt, AdmissionControl
 
 class qa_match_filt(gr_unittest.TestCase):
 
@@ -34,6 +37,235 @@ class qa_match_filt(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def run_match_filt(self, block, tx, cpis, num_messages, tx_meta=None):
+        """
+        Load the transmit waveform, then pass the CPIs (pairs of metadata and
+        samples) through the block and return the output PDUs
+        """
+        tb = gr.top_block()
+        debug = blocks.message_debug()
+        tb.msg_connect((block, 'out'), (debug, 'store'))
+        if tx_meta is None:
+            tx_meta = pmt.make_dict()
+        block.to_basic_block()._post(
+            pmt.intern("tx"), pmt.cons(tx_meta, pmt.init_c32vector(len(tx), list(tx))))
+        run_until_consumed(tb, block, "tx")
+
+        for meta, data in cpis:
+            data = pmt.init_c32vector(len(data), list(data))
+            block.to_basic_block()._post(pmt.intern("rx"), pmt.cons(meta, data))
+        run_until_messages(tb, debug, num_messages)
+        self.assertEqual(debug.num_messages(), num_messages)
+        return [debug.get_message(i) for i in range(num_messages)]
+
+    def check_range_gate(self, in_meters):
+        # Two pulses with echoes from point targets at delays of 3 and 5 samples
+        nrow, npulse, samp_rate = 8, 2, 1e6
+        tx = numpy.array([1, 1j])
+        rx = numpy.zeros((npulse, nrow), dtype=complex)
+        rx[0, 3:5] = tx
+        rx[1, 5:7] = 2 * tx
+
+        # Delays of 1.5 and 5.5 samples keep delays 2 through 5
+        block = match_filt(npulse)
+        block.set_metadata_keys("radar:num_pulse_cpi")
+        scale = 299792458 / (2 * samp_rate) if in_meters else 1
+        block.set_range_gates(1.5 * scale, 5.5 * scale, in_meters)
+        meta = pmt.dict_add(pmt.make_dict(), pmt.intern("core:sample_rate"),
+                            pmt.from_double(samp_rate))
+        out = self.run_match_filt(block, tx, [(meta, rx.flatten())], 1)[0]
+
+        meta = pmt.car(out)
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            meta, pmt.intern("radar:range_gate_start"), pmt.PMT_NIL)), 2)
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            meta, pmt.intern("radar:range_gate_stop"), pmt.PMT_NIL)), 6)
+
+        # The gated rows are the same as those of the full convolution, where row r
+        # is a delay of r - (ntaps - 1) samples
+        data = numpy.array(pmt.c32vector_elements(pmt.cdr(out))).reshape(npulse, -1)
+        self.assertEqual(data.shape[1], 4)
+        offset = len(tx) - 1
+        for i in range(npulse):
+            full = numpy.convolve(rx[i], numpy.conj(tx[::-1]))
+            self.assertComplexTuplesAlmostEqual(
+                data[i], full[2 + offset:6 + offset], 5)
+        self.assertEqual(numpy.argmax(abs(data[0])), 1)
+        self.assertEqual(numpy.argmax(abs(data[1])), 3)
+
+    def test_002_range_gate_samples(self):
+        self.check_range_gate(False)
+
+    def test_003_range_gate_meters(self):
+        self.check_range_gate(True)
+
+    def make_cpis(self, nrow, npulse, num_cpi):
+        """
+        Random CPIs, tagged with their position in the sequence
+        """
+        rng = numpy.random.default_rng(0)
+        cpis = []
+        for i in range(num_cpi):
+            meta = pmt.dict_add(pmt.make_dict(), pmt.intern("test:id"), pmt.from_long(i))
+            n = nrow * npulse
+            cpis.append((meta, rng.standard_normal(n) + 1j * rng.standard_normal(n)))
+        return cpis
+
+    def make_block(self, npulse, batch_size, policy=AdmissionControl.FIFO):
+        block = match_filt(npulse)
+        block.set_metadata_keys("radar:num_pulse_cpi")
+        block.set_admission_policy(policy, 0)
+        block.set_batch_size(batch_size)
+        return block
+
+    def cpi_id(self, msg):
+        return pmt.to_long(pmt.dict_ref(pmt.car(msg), pmt.intern("test:id"), pmt.PMT_NIL))
+
+    def assert_same_output(self, out, expected):
+        self.assertEqual(len(out), len(expected))
+        for x, y in zip(out, expected):
+            self.assertEqual(self.cpi_id(x), self.cpi_id(y))
+            self.assertComplexTuplesAlmostEqual(pmt.c32vector_elements(pmt.cdr(x)),
+                                                pmt.c32vector_elements(pmt.cdr(y)), 4)
+
+    def test_004_batching(self):
+        # CPIs that are queued together are compressed as one batch, with the same
+        # results (in the same order) as one at a time
+        nrow, npulse, num_cpi = 16, 4, 5
+        tx = [1, 1j, -1, -1j]
+        cpis = self.make_cpis(nrow, npulse, num_cpi)
+        expected = self.run_match_filt(self.make_block(npulse, 1), tx, cpis, num_cpi)
+        out = self.run_match_filt(self.make_block(npulse, 4), tx, cpis, num_cpi)
+        self.assert_same_output(out, expected)
+
+    def test_005_keep_latest(self):
+        # With a backlog of CPIs, only the newest ones are compressed
+        nrow, npulse = 16, 4
+        tx = [1, 1j, -1, -1j]
+        cpis = self.make_cpis(nrow, npulse, 5)
+        block = self.make_block(npulse, 1, AdmissionControl.KEEP_LATEST)
+        block.set_msg_queue_depth(1)
+        out = self.run_match_filt(block, tx, cpis, 2)
+        self.assertEqual([self.cpi_id(msg) for msg in out], [3, 4])
+        self.assertEqual(block.num_dropped(), 3)
+
+    def test_006_waveform_bank_beams(self):
+        # A bank of two waveforms, each padded to a PRI of 8 samples
+        nrow, npulse, nbeam, pri = 8, 2, 2, 8
+        waves = [numpy.array([1, 1]), numpy.array([1, -1j])]
+        tx = numpy.concatenate([numpy.pad(w, (0, pri - len(w))) for w in waves])
+        tx_meta = pmt.make_dict()
+        tx_meta = pmt.dict_add(tx_meta, pmt.intern("plasma:num_waveforms"),
+                               pmt.from_uint64(2))
+        tx_meta = pmt.dict_add(tx_meta, pmt.intern("plasma:waveform_length"),
+                               pmt.from_uint64(2))
+
+        # Each CPI gives the waveform of each of its pulses. The beams are stacked
+        # after the pulses, and every beam repeats the same waveforms.
+        cpis = self.make_cpis(nrow, npulse * nbeam, 2)
+        indices = [[1, 0], [0, 1]]
+        for i, index in enumerate(indices):
+            meta, data = cpis[i]
+            meta = pmt.dict_add(meta, pmt.intern("plasma:num_beams"),
+                                pmt.from_long(nbeam))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:waveform_index"),
+                                pmt.init_u32vector(npulse, index))
+            cpis[i] = (meta, data)
+
+        # Batched CPIs gather their filters the same way
+        for batch_size in (1, 4):
+            out = self.run_match_filt(self.make_block(npulse, batch_size), tx, cpis,
+                                      len(cpis), tx_meta)
+            for msg, (meta, data), index in zip(out, cpis, indices):
+                data = data.reshape(npulse * nbeam, nrow)
+                y = numpy.array(pmt.c32vector_elements(pmt.cdr(msg)))
+                y = y.reshape(npulse * nbeam, -1)
+                for col in range(npulse * nbeam):
+                    w = waves[index[col % npulse]]
+                    expected = numpy.convolve(data[col], numpy.conj(w[::-1]))
+                    self.assertComplexTuplesAlmostEqual(y[col], expected, 4)
+
+    def test_007_fractional_delay(self):
+        # Echoes delayed by 10.5 samples, where the receiver reports the half sample
+        # left over after its integer delay correction
+        nrow, npulse, delay = 64, 2, 10.5
+        tx = numpy.array([1, 1, 1, 1])
+        k = numpy.fft.fftfreq(nrow) * nrow
+        shift = numpy.exp(-2j * numpy.pi * delay * k / nrow)
+        echo = numpy.fft.ifft(numpy.fft.fft(tx, nrow) * shift)
+        rx = numpy.tile(echo, npulse)
+        meta = pmt.dict_add(pmt.make_dict(), pmt.intern("core:sample_rate"),
+                            pmt.from_double(1e6))
+        meta = pmt.dict_add(meta, pmt.intern("plasma:fractional_delay"),
+                            pmt.from_double(0.5))
+
+        # The corrected filter has one more tap than the waveform, so row r is a delay
+        # of r - len(tx) samples. The interpolated peak lands on the integer delay,
+        # halfway between the two samples it straddled.
+        out = self.run_match_filt(self.make_block(npulse, 1), tx, [(meta, rx)], 1)[0]
+        data = numpy.array(pmt.c32vector_elements(pmt.cdr(out))).reshape(npulse, -1)
+        for y in abs(data):
+            peak = numpy.argmax(y)
+            self.assertEqual(peak - len(tx), 10)
+            self.assertAlmostEqual(y[peak - 1], y[peak + 1], 3)
+            self.assertGreater(y[peak], y[peak + 1])
+
+    def test_008_cached_filter(self):
+        # Switching back to a waveform sends the same PMT again, whose filter comes
+        # from the cache and gives the same output as before
+        nrow, npulse = 16, 4
+        waves = [[1, 1j, -1, -1j], [1, -1, 1, -1]]
+        tx = [pmt.cons(pmt.make_dict(), pmt.init_c32vector(len(w), w)) for w in waves]
+        meta, data = self.make_cpis(nrow, npulse, 1)[0]
+        rx = pmt.cons(meta, pmt.init_c32vector(len(data), list(data)))
+
+        tb = gr.top_block()
+        block = self.make_block(npulse, 1)
+        debug = blocks.message_debug()
+        tb.msg_connect((block, 'out'), (debug, 'store'))
+        for i, waveform in enumerate([tx[0], tx[1], tx[0]]):
+            block.to_basic_block()._post(pmt.intern("tx"), waveform)
+            run_until_consumed(tb, block, "tx")
+            block.to_basic_block()._post(pmt.intern("rx"), rx)
+            run_until_messages(tb, debug, i + 1)
+        self.assertEqual(debug.num_messages(), 3)
+
+        out = [pmt.c32vector_elements(pmt.cdr(debug.get_message(i))) for i in range(3)]
+        data = data.reshape(npulse, nrow)
+        for y, w in zip(out, [waves[0], waves[1], waves[0]]):
+            y = numpy.array(y).reshape(npulse, -1)
+            for col in range(npulse):
+                expected = numpy.convolve(data[col], numpy.conj(w[::-1]))
+                self.assertComplexTuplesAlmostEqual(y[col], expected, 4)
+        self.assertComplexTuplesAlmostEqual(out[2], out[0], 6)
+
+    def test_009_batch_admission(self):
+        # CPIs drained from the queue into a batch still go through the admission
+        # control. At one CPI per second, the backlog behind the first is dropped.
+        nrow, npulse = 16, 4
+        tx = [1, 1j, -1, -1j]
+        cpis = self.make_cpis(nrow, npulse, 5)
+        block = self.make_block(npulse, 8, AdmissionControl.RATE_LIMITED)
+        block.set_admission_policy(AdmissionControl.RATE_LIMITED, 1)
+        out = self.run_match_filt(block, tx, cpis, 1)
+        self.assertEqual(self.cpi_id(out[0]), 0)
+        self.assertEqual(block.num_dropped(), 4)
+
+    def test_010_batch_fractional_delay(self):
+        # A new fractional delay ends the batch, so the CPIs before it are filtered
+        # without the new correction
+        nrow, npulse, num_cpi = 16, 4, 4
+        tx = [1, 1j, -1, -1j]
+        cpis = self.make_cpis(nrow, npulse, num_cpi)
+        for i in (2, 3):
+            meta, data = cpis[i]
+            meta = pmt.dict_add(meta, pmt.intern("plasma:fractional_delay"),
+                                pmt.from_double(0.5))
+            cpis[i] = (meta, data)
+        expected = self.run_match_filt(self.make_block(npulse, 1), tx, cpis, num_cpi)
+        out = self.run_match_filt(self.make_block(npulse, 4), tx, cpis, num_cpi)
+        self.assert_same_output(out, expected)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_match_filt)
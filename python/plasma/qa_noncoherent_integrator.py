@@ -0,0 +1,69 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+import pmt
+from qa_utils import run_until_messages
+try:
+  from gnuradio.plasma import noncoherent_integrator
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.plasma import noncoherent_integrator
+
+class qa_noncoherent_integrator(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_integrator(self, block, maps, num_messages):
+        from gnuradio import blocks
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+        for data in maps:
+            block.to_basic_block()._post(
+                pmt.intern("in"),
+                pmt.cons(pmt.make_dict(), pmt.init_c32vector(len(data), data)))
+
+        run_until_messages(self.tb, debug, num_messages)
+        return [debug.get_message(i) for i in range(debug.num_messages())]
+
+    def test_instance(self):
+        instance = noncoherent_integrator(4)
+
+    def test_001_sum(self):
+        block = noncoherent_integrator(2, noncoherent_integrator.SUM)
+        msgs = self.run_integrator(
+            block, [[1, 1j], [2, 0], [3j, 1 + 1j]], 1)
+
+        # The third map only starts the next sum
+        self.assertEqual(len(msgs), 1)
+        self.assertFloatTuplesAlmostEqual(
+            pmt.f32vector_elements(pmt.cdr(msgs[0])), [5, 1])
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            pmt.car(msgs[0]), pmt.intern("plasma:num_integrated"), pmt.PMT_NIL)), 2)
+
+    def test_002_exponential(self):
+        block = noncoherent_integrator(2, noncoherent_integrator.EXPONENTIAL)
+        msgs = self.run_integrator(block, [[2], [0], [0]], 3)
+
+        self.assertEqual(len(msgs), 3)
+        self.assertFloatTuplesAlmostEqual(
+            [pmt.f32vector_elements(pmt.cdr(msg))[0] for msg in msgs], [4, 2, 1])
+        self.assertEqual([pmt.to_long(pmt.dict_ref(
+            pmt.car(msg), pmt.intern("plasma:num_integrated"), pmt.PMT_NIL))
+            for msg in msgs], [1, 2, 3])
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_noncoherent_integrator)
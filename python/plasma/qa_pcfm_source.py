@@ -7,15 +7,17 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import pmt
+from qa_utils import run_until_messages
 try:
-  from gnuradio.plasma import pcfm_source
+  from gnuradio.plasma import pcfm_source, PhaseCode
 except ImportError:
     import os
     import sys
     dirname, filename = os.path.split(os.path.abspath(__file__))
     sys.path.append(os.path.join(dirname, "bindings"))
-    from gnuradio.plasma import pcfm_source
+    from gnuradio.plasma import pcfm_source, PhaseCode
 
 class qa_pcfm_source(gr_unittest.TestCase):
 
@@ -34,6 +36,70 @@ class qa_pcfm_source(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def run_source(self, source, msgs, num_messages):
+        """
+        Queue the update messages, then run the source until it has published
+        num_messages waveforms (including the one sent on startup)
+        """
+        tb = gr.top_block()
+        debug = blocks.message_debug()
+        tb.msg_connect((source, 'out'), (debug, 'store'))
+        for msg in msgs:
+            source.to_basic_block()._post(pmt.intern("in"), msg)
+        run_until_messages(tb, debug, num_messages)
+        return [debug.get_message(i) for i in range(debug.num_messages())]
+
+    def waveform(self, code, n, over, samp_rate):
+        """
+        Waveform published on startup by a source created with these parameters
+        """
+        out = self.run_source(pcfm_source(code, n, over, samp_rate), [], 1)
+        return pmt.c32vector_elements(pmt.cdr(out[0]))
+
+    def assert_waveform(self, msg, code, n, over, samp_rate):
+        meta = pmt.car(msg)
+        self.assertEqual(pmt.symbol_to_string(pmt.dict_ref(
+            meta, pmt.intern("radar:phase_code_class"), pmt.PMT_NIL)), code)
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            meta, pmt.intern("radar:num_phase_code_chips"), pmt.PMT_NIL)), n)
+        self.assertEqual(pmt.to_long(pmt.dict_ref(
+            meta, pmt.intern("radar:oversampling"), pmt.PMT_NIL)), over)
+        self.assertEqual(pmt.to_double(pmt.dict_ref(
+            meta, pmt.intern("core:sample_rate"), pmt.PMT_NIL)), samp_rate)
+        codes = {"barker": PhaseCode.BARKER, "frank": PhaseCode.FRANK}
+        self.assertComplexTuplesAlmostEqual(
+            pmt.c32vector_elements(pmt.cdr(msg)),
+            self.waveform(codes[code], n, over, samp_rate), 5)
+
+    def test_002_message_updates(self):
+        samp_rate = 1e6
+        update = pmt.make_dict()
+        update = pmt.dict_add(update, pmt.intern("radar:phase_code_class"),
+                              pmt.intern("frank"))
+        update = pmt.dict_add(update, pmt.intern("radar:num_phase_code_chips"),
+                              pmt.from_long(16))
+        update = pmt.dict_add(update, pmt.intern("plasma:effective_sample"),
+                              pmt.from_uint64(1234))
+        msgs = [
+            # A single parameter
+            pmt.cons(pmt.intern("radar:num_phase_code_chips"), pmt.from_long(7)),
+            # Several parameters, applied together
+            update,
+            # An invalid waveform is rejected and the previous parameters are kept
+            pmt.cons(pmt.intern("radar:oversampling"), pmt.from_long(0)),
+            pmt.cons(pmt.intern("radar:oversampling"), pmt.from_long(2)),
+        ]
+        source = pcfm_source(PhaseCode.BARKER, 13, 4, samp_rate)
+        out = self.run_source(source, msgs, 4)
+
+        self.assertEqual(len(out), 4)
+        self.assert_waveform(out[0], "barker", 13, 4, samp_rate)
+        self.assert_waveform(out[1], "barker", 7, 4, samp_rate)
+        self.assert_waveform(out[2], "frank", 16, 4, samp_rate)
+        self.assertEqual(pmt.to_uint64(pmt.dict_ref(
+            pmt.car(out[2]), pmt.intern("plasma:effective_sample"), pmt.PMT_NIL)), 1234)
+        self.assert_waveform(out[3], "frank", 16, 2, samp_rate)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_pcfm_source)
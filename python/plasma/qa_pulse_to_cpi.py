@@ -7,7 +7,9 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import pmt
+from qa_utils import run_until_messages
 try:
   from gnuradio.plasma import pulse_to_cpi
 except ImportError:
@@ -34,6 +36,87 @@ class qa_pulse_to_cpi(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def post_pulse(self, block, samples, offsets=None):
+        meta = pmt.make_dict()
+        if offsets is not None:
+            meta = pmt.dict_add(meta, pmt.intern("plasma:pulse_offsets"),
+                                pmt.init_u64vector(len(offsets), offsets))
+        block.to_basic_block()._post(
+            pmt.intern("in"),
+            pmt.cons(meta, pmt.init_c32vector(len(samples), samples)))
+
+    def test_002_prf_stagger(self):
+        npulse = 6
+        block = pulse_to_cpi(npulse)
+        block.init_meta_dict("radar:num_pulse_cpi")
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # Two stagger groups with PRIs of 10, 20 and 5 samples. Each pulse is cut to
+        # the shortest PRI.
+        groups = [[complex(g * 100 + i) for i in range(35)] for g in range(2)]
+        for group in groups:
+            self.post_pulse(block, group, [0, 10, 30])
+        # Then single-PRI pulses, as sent when the stagger is turned off
+        pulses = [[complex(1000 + p * 10 + i) for i in range(10)]
+                  for p in range(npulse)]
+        self.post_pulse(block, pulses[0], [0])
+        for pulse in pulses[1:]:
+            self.post_pulse(block, pulse)
+        run_until_messages(self.tb, debug, 2)
+        self.assertEqual(debug.num_messages(), 2)
+
+        expected = []
+        for group in groups:
+            for offset in (0, 10, 30):
+                expected += group[offset:offset + 5]
+        self.assertComplexTuplesAlmostEqual(
+            pmt.c32vector_elements(pmt.cdr(debug.get_message(0))), expected)
+        self.assertComplexTuplesAlmostEqual(
+            pmt.c32vector_elements(pmt.cdr(debug.get_message(1))), sum(pulses, []))
+
+    def test_003_pulse_length_change(self):
+        # A PRI change partway through a CPI drops the pulses gathered so far
+        npulse = 4
+        block = pulse_to_cpi(npulse)
+        block.init_meta_dict("radar:num_pulse_cpi")
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        for p in range(2):
+            self.post_pulse(block, [complex(p)] * 10)
+        pulses = [[complex(100 + p * 10 + i) for i in range(8)] for p in range(npulse)]
+        for pulse in pulses:
+            self.post_pulse(block, pulse)
+        run_until_messages(self.tb, debug, 1)
+        self.assertEqual(debug.num_messages(), 1)
+        self.assertComplexTuplesAlmostEqual(
+            pmt.c32vector_elements(pmt.cdr(debug.get_message(0))), sum(pulses, []))
+
+    def test_004_waveform_index(self):
+        npulse = 4
+        block = pulse_to_cpi(npulse)
+        block.init_meta_dict("radar:num_pulse_cpi")
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # The first CPI has an untagged pulse, and the second is fully tagged
+        key = pmt.intern("plasma:waveform_index")
+        for cpi, tagged in enumerate(([0, 1, 3], [0, 1, 2, 3])):
+            for p in range(npulse):
+                meta = pmt.make_dict()
+                if p in tagged:
+                    meta = pmt.dict_add(meta, key, pmt.from_uint64((p + cpi) % 2))
+                block.to_basic_block()._post(
+                    pmt.intern("in"), pmt.cons(meta, pmt.init_c32vector(4, [1] * 4)))
+        run_until_messages(self.tb, debug, 2)
+        self.assertEqual(debug.num_messages(), 2)
+
+        # Indices are only sent when every pulse has one, rather than reusing stale ones
+        self.assertFalse(pmt.dict_has_key(pmt.car(debug.get_message(0)), key))
+        index = pmt.dict_ref(pmt.car(debug.get_message(1)), key, pmt.PMT_NIL)
+        self.assertEqual(list(pmt.u32vector_elements(index)), [1, 0, 1, 0])
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_pulse_to_cpi)
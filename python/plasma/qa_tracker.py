@@ -0,0 +1,97 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+import pmt
+from qa_utils import run_until_messages
+try:
+  from gnuradio.plasma import tracker
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.plasma import tracker
+
+class qa_tracker(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = tracker(10, 5, 0.5, 0.1, 3, 2)
+
+    def test_001_track(self):
+        from gnuradio import blocks
+        block = tracker(10, 5, 0.5, 0.1, 2, 1)
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # A target closing at 10 m/s, updated every 100 pulses at a 1 kHz PRF (0.1 s),
+        # and a false alarm in the first CPI. The refined velocity is positive for
+        # closing targets, so the track's range rate is -10 m/s.
+        ranges = [[1000, 5000], [999], [998]]
+        for r in ranges:
+            meta = pmt.make_dict()
+            meta = pmt.dict_add(meta, pmt.intern("radar:prf"), pmt.from_double(1e3))
+            meta = pmt.dict_add(
+                meta, pmt.intern("radar:num_pulse_cpi"), pmt.from_long(100))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:detection_range"),
+                                pmt.init_f64vector(len(r), r))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:detection_velocity"),
+                                pmt.init_f64vector(len(r), [10] * len(r)))
+            block.to_basic_block()._post(
+                pmt.intern("in"), pmt.cons(meta, pmt.init_c32vector(0, [])))
+
+        run_until_messages(self.tb, debug, 3)
+
+        # The target's track is confirmed on its second hit, and the false alarm's
+        # track is deleted
+        self.assertEqual(debug.num_messages(), 3)
+        num_tracks = [len(pmt.u64vector_elements(pmt.dict_ref(
+            pmt.car(debug.get_message(i)), pmt.intern("plasma:track_id"),
+            pmt.PMT_NIL))) for i in range(3)]
+        self.assertEqual(num_tracks, [0, 1, 1])
+        self.assertFloatTuplesAlmostEqual(
+            pmt.f64vector_elements(pmt.cdr(debug.get_message(2))), [998, -10])
+
+    def test_002_rx_time(self):
+        from gnuradio import blocks
+        block = tracker(10, 5, 0.5, 0.1, 2, 1)
+        debug = blocks.message_debug()
+        self.tb.msg_connect((block, 'out'), (debug, 'store'))
+
+        # Every other CPI of a 0.1 s CPI train was dropped upstream, so the updates are
+        # 0.2 s apart. The receive times give the interval, and a target closing at
+        # 10 m/s lands on its predicted range.
+        ranges = [1000, 998, 996]
+        for i, r in enumerate(ranges):
+            meta = pmt.make_dict()
+            meta = pmt.dict_add(meta, pmt.intern("radar:prf"), pmt.from_double(1e3))
+            meta = pmt.dict_add(
+                meta, pmt.intern("radar:num_pulse_cpi"), pmt.from_long(100))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:rx_time"),
+                                pmt.from_double(0.2 * i))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:detection_range"),
+                                pmt.init_f64vector(1, [r]))
+            meta = pmt.dict_add(meta, pmt.intern("plasma:detection_velocity"),
+                                pmt.init_f64vector(1, [10]))
+            block.to_basic_block()._post(
+                pmt.intern("in"), pmt.cons(meta, pmt.init_c32vector(0, [])))
+
+        run_until_messages(self.tb, debug, 3)
+        self.assertEqual(debug.num_messages(), 3)
+        self.assertFloatTuplesAlmostEqual(
+            pmt.f64vector_elements(pmt.cdr(debug.get_message(2))), [996, -10])
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_tracker)
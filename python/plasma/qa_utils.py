@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+"""
+Helpers shared by the message-based QA tests
+"""
+
+import time
+
+import pmt
+
+
+def run_until_messages(tb, debug, num_messages, timeout=5.0):
+    """
+    Start a flowgraph, wait until a message_debug block has stored num_messages
+    messages (or until the timeout in seconds expires), then stop the flowgraph.
+
+    Polling against a deadline keeps fast machines from waiting and gives slow
+    machines (or the first ArrayFire JIT compilation) enough time.
+    """
+    tb.start()
+    deadline = time.monotonic() + timeout
+    while debug.num_messages() < num_messages and time.monotonic() < deadline:
+        time.sleep(0.001)
+    tb.stop()
+    tb.wait()
+
+
+def run_until_consumed(tb, block, port, timeout=5.0):
+    """
+    Start a flowgraph, wait until block has taken every message queued on the
+    given input port (or until the timeout in seconds expires), then stop the
+    flowgraph.
+
+    The input ports of a block are serviced in no particular order, so a test
+    uses this to make sure a message (e.g., a matched filter waveform) has
+    been handled before posting the messages that depend on it. Stopping the
+    flowgraph waits for the handler to return.
+    """
+    port = pmt.intern(port)
+    tb.start()
+    deadline = time.monotonic() + timeout
+    while block.to_basic_block().nmsgs(port) > 0 and time.monotonic() < deadline:
+        time.sleep(0.001)
+    tb.stop()
+    tb.wait()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2023 gr-plasma author.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+import pmt
+from qa_utils import run_until_messages
+try:
+  from gnuradio.plasma import waveform_bank
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.plasma import waveform_bank
+
+class qa_waveform_bank(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = waveform_bank(2, [], 1e3, 1e6)
+
+    def test_001_bank(self):
+        from gnuradio import blocks
+        prf = 1e3
+        samp_rate = 8e3
+        bank = waveform_bank(2, [1, 1, 0], prf, samp_rate)
+        debug = blocks.message_debug()
+        self.tb.msg_connect((bank, 'out'), (debug, 'store'))
+
+        # Fill slot 1 explicitly, then slot 0 (which wraps around)
+        meta = pmt.dict_add(pmt.make_dict(), pmt.intern("plasma:waveform_index"),
+                            pmt.from_uint64(1))
+        bank.to_basic_block()._post(
+            pmt.intern("in"), pmt.cons(meta, pmt.init_c32vector(3, [2, 2, 2])))
+        bank.to_basic_block()._post(
+            pmt.intern("in"), pmt.cons(pmt.make_dict(), pmt.init_c32vector(2, [1, 1])))
+
+        run_until_messages(self.tb, debug, 1)
+
+        # Nothing is sent until every slot is filled
+        self.assertEqual(debug.num_messages(), 1)
+        msg = debug.get_message(0)
+        self.assertComplexTuplesAlmostEqual(
+            pmt.c32vector_elements(pmt.cdr(msg)),
+            [1, 1, 0, 0, 0, 0, 0, 0, 2, 2, 2, 0, 0, 0, 0, 0])
+        meta = pmt.car(msg)
+        self.assertEqual(pmt.to_uint64(pmt.dict_ref(
+            meta, pmt.intern("plasma:num_waveforms"), pmt.PMT_NIL)), 2)
+        self.assertEqual(pmt.to_uint64(pmt.dict_ref(
+            meta, pmt.intern("plasma:waveform_length"), pmt.PMT_NIL)), 3)
+        self.assertEqual(list(pmt.u32vector_elements(pmt.dict_ref(
+            meta, pmt.intern("plasma:waveform_schedule"), pmt.PMT_NIL))), [1, 1, 0])
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_waveform_bank)